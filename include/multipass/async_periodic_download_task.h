@@ -18,13 +18,14 @@
 #pragma once
 
 #include <multipass/exceptions/download_exception.h>
+#include <multipass/executor.h>
 #include <multipass/logging/log.h>
 
 #include <chrono>
 #include <string_view>
 
+#include <QFutureWatcher>
 #include <QTimer>
-#include <QtConcurrent/QtConcurrent>
 
 namespace mpl = multipass::logging;
 
@@ -66,7 +67,9 @@ public:
 
         // TODO, remove the launch_msg parameter once we have better class separation.
         mpl::log_message(mpl::Level::debug, "async task", std::string(launch_msg));
-        future = QtConcurrent::run(std::forward<Callable>(func), std::forward<Args>(args)...);
+        future = MP_EXECUTOR.run(Lane::blocking,
+                                 std::forward<Callable>(func),
+                                 std::forward<Args>(args)...);
 
         auto event_handler_on_success_and_failure = [retry_start_delay_time, this]() -> void {
             try
@@ -98,7 +101,7 @@ public:
             if (future.isFinished())
             {
                 mpl::log_message(mpl::Level::debug, "async task", std::string(launch_msg));
-                future = QtConcurrent::run(func, args...);
+                future = MP_EXECUTOR.run(Lane::blocking, func, args...);
                 future_watcher.setFuture(future);
             }
         });
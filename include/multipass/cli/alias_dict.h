@@ -60,26 +60,32 @@ public:
     std::optional<AliasDefinition> get_alias(const std::string& alias) const;
     DictType::iterator begin()
     {
+        ensure_loaded();
         return aliases.begin();
     }
     DictType::iterator end()
     {
+        ensure_loaded();
         return aliases.end();
     }
     DictType::const_iterator cbegin() const
     {
+        ensure_loaded();
         return aliases.cbegin();
     }
     DictType::const_iterator cend() const
     {
+        ensure_loaded();
         return aliases.cend();
     }
     bool empty() const
     {
+        ensure_loaded();
         return (aliases.empty() || (aliases.size() == 1 && get_active_context().empty()));
     }
     size_type size() const
     {
+        ensure_loaded();
         return aliases.size();
     }
     void clear()
@@ -96,13 +102,16 @@ public:
     QJsonObject to_json() const;
 
 private:
-    void load_dict();
+    void ensure_loaded() const;
+    void load_dict() const;
     void save_dict();
     void sanitize_contexts();
     std::optional<AliasDefinition> get_alias_from_all_contexts(const std::string& alias) const;
 
-    std::string active_context;
-    DictType aliases;
+    // Mutable so that the first const access can populate them, see ensure_loaded()
+    mutable std::string active_context;
+    mutable DictType aliases;
+    mutable bool loaded = false;
 
     bool modified = false;
     std::string aliases_file;
@@ -46,7 +46,7 @@ public:
                                const QString& description,
                                const QString& syntax = QString());
 
-    ParseCode parse(const std::optional<AliasDict>& aliases = std::nullopt);
+    ParseCode parse(const AliasDict* aliases = nullptr);
     cmd::Command* chosenCommand() const;
     cmd::Command* findCommand(const QString& command) const;
     const std::vector<cmd::Command::UPtr>& getCommands() const;
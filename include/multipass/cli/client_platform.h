@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <multipass/id_mappings.h>
 #include <multipass/singleton.h>
 
 #include <QString>
@@ -27,9 +28,6 @@
 
 namespace multipass
 {
-const auto default_id = -1;
-const auto no_id_info_available = -2;
-
 class Terminal;
 
 namespace cli
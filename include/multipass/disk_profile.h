@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QString>
+
+#include <optional>
+
+namespace multipass
+{
+// How an instance's disk is attached: the default favours compatibility, the other I/O throughput
+enum class DiskProfile
+{
+    standard,
+    throughput
+};
+
+inline QString disk_profile_name(DiskProfile profile)
+{
+    return profile == DiskProfile::throughput ? "throughput" : "default";
+}
+
+inline std::optional<DiskProfile> disk_profile_from(const QString& name)
+{
+    if (name == "default")
+        return DiskProfile::standard;
+    if (name == "throughput")
+        return DiskProfile::throughput;
+
+    return std::nullopt;
+}
+} // namespace multipass
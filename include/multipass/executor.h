@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "singleton.h"
+
+#include <QFuture>
+#include <QFutureSynchronizer>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define MP_EXECUTOR multipass::Executor::instance()
+
+namespace multipass
+{
+// Work is either computing, so that it needs no more threads than cores, or mostly waiting (on
+// instances, processes, the network), so that it is worth many more threads than that
+enum class Lane
+{
+    cpu,
+    blocking
+};
+
+// Lets a task that is already running find out that its result is no longer wanted. Tasks that are
+// still queued are dropped by cancelling their QFuture instead.
+class CancellationToken
+{
+public:
+    void cancel() noexcept
+    {
+        cancelled->store(true, std::memory_order_relaxed);
+    }
+
+    bool is_cancelled() const noexcept
+    {
+        return cancelled->load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
+};
+
+// The daemon-wide pools that background work runs on, so that thread counts stay bounded however
+// many instances there are
+class Executor : public Singleton<Executor>
+{
+public:
+    struct LaneStats
+    {
+        int max_threads = 0;
+        std::int64_t queued = 0;  // submitted but not started yet
+        std::int64_t running = 0;
+        std::uint64_t completed = 0;
+        std::chrono::microseconds total_queue_wait{0};
+        std::chrono::microseconds max_queue_wait{0};
+    };
+
+    Executor(const Singleton<Executor>::PrivatePass&);
+
+    template <typename Function, typename... Args>
+    auto run(Lane lane, Function&& function, Args&&... args);
+
+    // Waits for all the futures, then rethrows the first error among them. Meanwhile, the lane gets
+    // an extra thread, lest tasks that wait on other tasks take every thread and wait on work
+    // queued behind them.
+    template <typename Futures>
+    void wait_for(Lane lane, const Futures& futures);
+    template <typename T>
+    void wait_for(Lane lane, QFutureSynchronizer<T>& synchronizer);
+    template <typename T>
+    void wait_for(Lane lane, const QFuture<T>& future);
+
+    // The lane of the task that the calling thread runs, if any, for code that waits on behalf of
+    // whichever lane called it
+    static std::optional<Lane> current_lane();
+
+    LaneStats stats(Lane lane) const;
+    // Returns whether all tasks finished in time; those that did not are left running
+    bool wait_for_done(std::chrono::milliseconds timeout);
+
+private:
+    struct LaneState
+    {
+        QThreadPool pool;
+        std::atomic<std::int64_t> queued{0};
+        std::atomic<std::int64_t> running{0};
+        std::atomic<std::uint64_t> completed{0};
+        std::atomic<std::int64_t> total_queue_wait_us{0};
+        std::atomic<std::int64_t> max_queue_wait_us{0};
+    };
+
+    // Accounts for a task from submission until it starts, or is dropped without starting
+    class Pending
+    {
+    public:
+        Pending(LaneState& state, Lane lane);
+        ~Pending();
+
+        struct Running
+        {
+            ~Running();
+            LaneState& state;
+            std::optional<Lane> outer_lane; // of a task that waits on this one in the same thread
+        };
+        [[nodiscard]] Running start();
+
+    private:
+        LaneState& state;
+        Lane lane;
+        std::chrono::steady_clock::time_point submitted;
+        bool started = false;
+    };
+
+    LaneState& state_of(Lane lane);
+    void warn_if_saturated(Lane lane);
+
+    std::array<LaneState, 2> lanes;
+};
+
+namespace utils
+{
+template <typename T>
+bool is_default_constructed(const T& input_type)
+{
+    return input_type == T{};
+}
+
+// simplified parallel transform, it takes a std container and a unary operation and
+// returns a std::vector<OutputValueType> where the OutputValueType is the unary operation return
+// type. The operations run on the blocking lane, where the callers so far want them.
+template <typename Container, typename UnaryOperation>
+std::vector<std::invoke_result_t<std::decay_t<UnaryOperation>, typename Container::value_type>>
+parallel_transform(const Container& input_container, UnaryOperation&& unary_op)
+{
+    using InputValueType = typename Container::value_type;
+    using OutputValueType = std::invoke_result_t<std::decay_t<UnaryOperation>, InputValueType>;
+
+    std::vector<QFuture<OutputValueType>> futures;
+    futures.reserve(input_container.size());
+    for (const auto& item : input_container)
+        futures.push_back(MP_EXECUTOR.run(Lane::blocking, unary_op, std::cref(item)));
+
+    MP_EXECUTOR.wait_for(Lane::blocking, futures);
+
+    std::vector<OutputValueType> results;
+    for (auto& future : futures)
+    {
+        auto item = future.takeResult();
+        if (!is_default_constructed(item))
+        {
+            results.emplace_back(std::move(item));
+        }
+    }
+
+    return results;
+}
+
+template <typename Container, typename UnaryOperation>
+void parallel_for_each(Container& input_container, UnaryOperation&& unary_op)
+{
+    std::vector<QFuture<void>> futures;
+    futures.reserve(input_container.size());
+    for (auto& item : input_container)
+        futures.push_back(MP_EXECUTOR.run(Lane::blocking, unary_op, std::ref(item)));
+
+    MP_EXECUTOR.wait_for(Lane::blocking, futures);
+}
+} // namespace utils
+} // namespace multipass
+
+template <typename Function, typename... Args>
+auto multipass::Executor::run(Lane lane, Function&& function, Args&&... args)
+{
+    auto& state = state_of(lane);
+    warn_if_saturated(lane);
+
+    auto task = [pending = std::make_shared<Pending>(state, lane),
+                 function = std::forward<Function>(function),
+                 args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        auto finish = pending->start();
+        return std::apply(std::move(function), std::move(args));
+    };
+
+    return QtConcurrent::run(&state.pool, std::move(task));
+}
+
+template <typename Futures>
+void multipass::Executor::wait_for(Lane lane, const Futures& futures)
+{
+    auto& pool = state_of(lane).pool;
+    pool.releaseThread();
+
+    std::exception_ptr first_error;
+    for (auto future : futures)
+    {
+        try
+        {
+            future.waitForFinished();
+        }
+        catch (...)
+        {
+            if (!first_error)
+                first_error = std::current_exception();
+        }
+    }
+
+    pool.reserveThread();
+    if (first_error)
+        std::rethrow_exception(first_error);
+}
+
+template <typename T>
+void multipass::Executor::wait_for(Lane lane, QFutureSynchronizer<T>& synchronizer)
+{
+    wait_for(lane, synchronizer.futures());
+}
+
+template <typename T>
+void multipass::Executor::wait_for(Lane lane, const QFuture<T>& future)
+{
+    wait_for(lane, std::array{future});
+}
@@ -129,6 +129,8 @@ public:
     virtual fs::path read_symlink(const fs::path& path, std::error_code& err) const;
     virtual fs::file_status status(const fs::path& path, std::error_code& err) const;
     virtual fs::file_status symlink_status(const fs::path& path, std::error_code& err) const;
+    virtual fs::file_time_type last_write_time(const fs::path& path, std::error_code& err) const;
+    virtual std::uintmax_t file_size(const fs::path& path, std::error_code& err) const;
     virtual std::unique_ptr<RecursiveDirIterator>
     recursive_dir_iterator(const fs::path& path, std::error_code& err) const;
     virtual std::unique_ptr<DirIterator> dir_iterator(const fs::path& path,
@@ -20,6 +20,8 @@
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 
+#include <optional>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -29,8 +31,47 @@ namespace mpl = multipass::logging;
 
 namespace multipass
 {
+const auto default_id = -1;
+const auto no_id_info_available = -2;
+
 using id_mappings = std::vector<std::pair<int, int>>;
 
+// Host-to-instance mappings compiled into hash maps in both directions, for lookups on hot paths.
+// Mappings to default_id are resolved to the given instance id up front. As with a search through
+// the list, the first mapping for an id wins.
+class IdMap
+{
+public:
+    IdMap(const id_mappings& mappings, int default_instance_id)
+    {
+        forward.reserve(mappings.size());
+        reverse.reserve(mappings.size());
+        for (const auto& [host_id, instance_id] : mappings)
+        {
+            forward.try_emplace(host_id,
+                                instance_id == default_id ? default_instance_id : instance_id);
+            reverse.try_emplace(instance_id, host_id);
+        }
+    }
+
+    std::optional<int> instance_id_for(int host_id) const
+    {
+        const auto it = forward.find(host_id);
+        return it == forward.end() ? std::nullopt : std::make_optional(it->second);
+    }
+
+    // Keyed by the instance ids as given, i.e. before resolving the default
+    std::optional<int> host_id_for(int instance_id) const
+    {
+        const auto it = reverse.find(instance_id);
+        return it == reverse.end() ? std::nullopt : std::make_optional(it->second);
+    }
+
+private:
+    std::unordered_map<int, int> forward;
+    std::unordered_map<int, int> reverse;
+};
+
 inline auto unique_id_mappings(id_mappings& xid_mappings)
 {
     std::unordered_map<int, std::unordered_set<int>> dup_id_map;
@@ -70,4 +111,14 @@ inline auto unique_id_mappings(id_mappings& xid_mappings)
 
     return std::make_pair(dup_id_map, dup_rev_id_map);
 }
+
+// As sshfs_server takes them: "host:instance," for each mapping
+inline std::string serialise_id_mappings(const id_mappings& xid_mappings)
+{
+    std::string out;
+    for (const auto& [host_id, instance_id] : xid_mappings)
+        out += fmt::format("{}:{},", host_id, instance_id);
+
+    return out;
+}
 } // namespace multipass
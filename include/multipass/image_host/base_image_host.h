@@ -41,7 +41,8 @@ protected:
 
     virtual void for_each_entry_do_impl(const Action& action) = 0;
     virtual VMImageInfo info_for_full_hash_impl(const std::string& full_hash) = 0;
-    virtual void clear() = 0;
+    // Implementations build the new manifests aside and publish them in one step, so that lookups
+    // running concurrently see either the old or the new manifests in full
     virtual void fetch_manifests(const bool force_update) = 0;
 
     URLDownloader* const url_downloader;
@@ -22,6 +22,8 @@
 
 #include <QString>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -52,11 +54,11 @@ private:
     void for_each_entry_do_impl(const Action& action) override;
     VMImageInfo info_for_full_hash_impl(const std::string& full_hash) override;
     void fetch_manifests(const bool force_update) override;
-    void clear() override;
-    CustomManifest* manifest_from(const std::string& remote_name);
+    std::shared_ptr<const CustomManifest> manifest_from(const std::string& remote_name) const;
 
     const QString arch;
-    std::pair<std::string, std::unique_ptr<CustomManifest>> manifest;
+    mutable std::mutex manifest_mutex;
+    std::shared_ptr<const CustomManifest> manifest;
     std::string remote;
 };
 } // namespace multipass
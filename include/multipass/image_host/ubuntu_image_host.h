@@ -23,6 +23,8 @@
 
 #include <QString>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -35,26 +37,41 @@ class UbuntuVMImageRemote;
 class UbuntuVMImageHost final : public BaseVMImageHost
 {
 public:
+    // Parsed manifests are cached in binary form under manifest_cache_dir, when given
     UbuntuVMImageHost(std::vector<std::pair<std::string, UbuntuVMImageRemote>> remotes,
-                      URLDownloader* downloader);
+                      URLDownloader* downloader,
+                      const QString& manifest_cache_dir = {});
 
     std::optional<VMImageInfo> info_for(const Query& query) override;
     std::vector<std::pair<std::string, VMImageInfo>> all_info_for(const Query& query) override;
     std::vector<VMImageInfo> all_images_for(const std::string& remote_name,
                                             const bool allow_unsupported) override;
     std::vector<std::string> supported_remotes() override;
+    void for_each_aliased_entry_do(const Action& action) override;
 
 private:
+    using Manifests = std::vector<std::pair<std::string, std::unique_ptr<SimpleStreamsManifest>>>;
+
     void for_each_entry_do_impl(const Action& action) override;
     VMImageInfo info_for_full_hash_impl(const std::string& full_hash) override;
     void fetch_manifests(const bool force_update) override;
-    void clear() override;
-    SimpleStreamsManifest* manifest_from(const std::string& remote);
+    std::shared_ptr<const Manifests> current_manifests() const;
+    const SimpleStreamsManifest* manifest_from(const Manifests& manifests,
+                                               const std::string& remote) const;
     const VMImageInfo* match_alias(const QString& key, const SimpleStreamsManifest& manifest) const;
+    std::unique_ptr<SimpleStreamsManifest> load_cached_manifest(
+        const std::string& remote_name,
+        const QByteArray& fingerprint) const;
+    void save_cached_manifest(const std::string& remote_name,
+                              const QByteArray& fingerprint,
+                              const SimpleStreamsManifest& manifest) const;
 
-    std::vector<std::pair<std::string, std::unique_ptr<SimpleStreamsManifest>>> manifests;
+    // Refreshes publish a complete new set, so readers keep whichever set they started with
+    mutable std::mutex manifests_mutex;
+    std::shared_ptr<const Manifests> manifests{std::make_shared<const Manifests>()};
     std::vector<std::pair<std::string, UbuntuVMImageRemote>> remotes;
     QString index_path;
+    const QString manifest_cache_dir;
 };
 
 class UbuntuVMImageRemote
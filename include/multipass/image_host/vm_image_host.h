@@ -42,6 +42,14 @@ public:
     virtual std::vector<VMImageInfo> all_images_for(const std::string& remote_name,
                                                     const bool allow_unsupported) = 0;
     virtual void for_each_entry_do(const Action& action) = 0;
+    // Visits only the entries that carry aliases, which is all that listing releases needs
+    virtual void for_each_aliased_entry_do(const Action& action)
+    {
+        for_each_entry_do([&action](const std::string& remote, const VMImageInfo& info) {
+            if (!info.aliases.empty())
+                action(remote, info);
+        });
+    }
     virtual std::vector<std::string> supported_remotes() = 0;
     virtual void update_manifests(const bool force_update) = 0;
 
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "singleton.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define MP_METRICS multipass::Metrics::instance()
+
+namespace multipass
+{
+// Metrics are updated with relaxed atomics, so that they can stay on in production. Finding the
+// series of a label takes a shared lock, but allocates only the first time the label is seen.
+class Counter
+{
+public:
+    void add(std::uint64_t n = 1) noexcept
+    {
+        count.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t value() const noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> count{0};
+};
+
+class Histogram
+{
+public:
+    // Upper bounds of the buckets, in seconds; wide enough for both quick RPCs and slow launches
+    static constexpr std::array<double, 12> bounds{
+        0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30, 60, 300};
+
+    void observe(std::chrono::steady_clock::duration duration) noexcept;
+
+    std::array<std::uint64_t, bounds.size() + 1> bucket_counts() const noexcept; // not cumulative
+    std::uint64_t count() const noexcept;
+    double sum() const noexcept; // in seconds
+
+private:
+    std::array<std::atomic<std::uint64_t>, bounds.size() + 1> buckets{};
+    std::atomic<std::int64_t> sum_us{0};
+};
+
+// A metric split by the value of one label, like RPC durations by RPC
+template <typename Metric>
+class Labelled
+{
+public:
+    Metric& with(std::string_view label_value)
+    {
+        {
+            std::shared_lock lock{mutex};
+            if (auto it = series.find(label_value); it != series.end())
+                return *it->second;
+        }
+
+        std::unique_lock lock{mutex};
+        auto& metric = series[std::string{label_value}];
+        if (!metric)
+            metric = std::make_unique<Metric>();
+
+        return *metric;
+    }
+
+    void for_each(const std::function<void(const std::string&, const Metric&)>& visit) const
+    {
+        std::shared_lock lock{mutex};
+        for (const auto& [label_value, metric] : series)
+            visit(label_value, *metric);
+    }
+
+private:
+    mutable std::shared_mutex mutex;
+    std::map<std::string, std::unique_ptr<Metric>, std::less<>> series;
+};
+
+// What the daemon knows about its own activity, for fleets that want to watch it
+class Metrics : public Singleton<Metrics>
+{
+public:
+    Metrics(const Singleton<Metrics>::PrivatePass&) noexcept;
+
+    Labelled<Histogram> rpc_durations;                // by RPC
+    Labelled<Counter> instance_operations;            // by operation, one per instance
+    Labelled<Histogram> instance_operation_durations; // likewise
+    Counter downloaded_bytes;
+    Counter image_vault_hits;
+    Counter image_vault_misses;
+    Counter ssh_execs;
+
+    // In the Prometheus text exposition format
+    std::string to_prometheus() const;
+};
+
+// Appends a gauge in the Prometheus text exposition format, for state that is cheaper to read when
+// asked than to track, like the instances or the executor's queues. Samples go with their labels,
+// e.g. {"lane=\"cpu\"", 2}.
+void append_prometheus_gauge(std::string& out,
+                             std::string_view name,
+                             std::string_view help,
+                             const std::vector<std::pair<std::string, double>>& samples);
+// Likewise for totals that are kept elsewhere, like the time tasks spent in the executor's queues
+void append_prometheus_counter(std::string& out,
+                               std::string_view name,
+                               std::string_view help,
+                               const std::vector<std::pair<std::string, double>>& samples);
+} // namespace multipass
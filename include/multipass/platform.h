@@ -40,6 +40,7 @@
 #define MP_PLATFORM multipass::platform::Platform::instance()
 
 struct sftp_attributes_struct;
+struct sftp_statvfs_struct;
 
 namespace multipass
 {
@@ -93,6 +94,23 @@ UpdatePrompt::UPtr make_update_prompt();
 std::unique_ptr<Process> make_sshfs_server_process(const SSHFSServerConfig& config);
 std::unique_ptr<Process> make_process(std::unique_ptr<ProcessSpec>&& process_spec);
 int symlink_attr_from(const char* path, sftp_attributes_struct* attr);
+// Attributes of a directory entry, without following symlinks, from a single system call. Returns
+// -1 where that is not possible and the caller needs to work them out some other way.
+int entry_attr_from(const char* path, sftp_attributes_struct* attr);
+// File system statistics, for the SFTP statvfs extensions. Return -1 where unsupported.
+int statvfs_from(const char* path, sftp_statvfs_struct* st);
+int fstatvfs_from(int fd, sftp_statvfs_struct* st);
+// Flushes the data of an open file to its storage
+int sync_file(int fd);
+// Whether two open files are one and the same, even when opened separately or under other names
+bool same_file(int fd, int other_fd);
+// Copies `length` bytes (all to the end of the input when 0) between open files without the data
+// going through the caller, where the host can. Returns the number of bytes copied, -1 on failure.
+long long copy_file_data(int in_fd,
+                         long long in_offset,
+                         int out_fd,
+                         long long out_offset,
+                         unsigned long long length);
 
 // Creates a function that will wait for signals or until the passed function returns false.
 // The passed function is checked every `period` milliseconds.
@@ -62,6 +62,8 @@ public:
 
     ProcessState execute(const int timeout = 30000) override;
 
+    void reload_apparmor_profile() override;
+
 protected:
     const std::shared_ptr<ProcessSpec> process_spec;
 
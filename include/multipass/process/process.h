@@ -114,6 +114,10 @@ public:
 
     virtual ProcessState execute(const int timeout = 30000) = 0;
 
+    // Applies the AppArmor profile of the spec anew, for specs whose profile changes while the
+    // process runs. Does nothing for processes that are not confined.
+    virtual void reload_apparmor_profile() = 0;
+
 signals:
     void started();
     void finished(multipass::ProcessState process_state);
@@ -20,8 +20,11 @@
 #include "setting_spec.h"
 #include "settings_handler.h"
 
+#include <cstdint>
+#include <filesystem>
 #include <map>
 #include <mutex>
+#include <optional>
 
 namespace multipass
 {
@@ -36,6 +39,17 @@ public:
 private:
     const SettingSpec& get_setting(const QString& key) const; // throws on unknown key
 
+    // What tells whether the file changed since it was read, be it by this or another process
+    struct FileStamp
+    {
+        bool exists = false;
+        std::filesystem::file_time_type mtime{};
+        std::uintmax_t size = 0;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+    FileStamp stamp() const;
+
 private:
     using SettingMap = std::map<QString, SettingSpec::UPtr>;
     static SettingMap convert(SettingSpec::Set);
@@ -44,5 +58,8 @@ private:
     QString filename;
     SettingMap settings;
     mutable std::mutex mutex;
+    mutable std::mutex cache_mutex;
+    mutable std::map<QString, QString> cache; // values as read when the file had cache_stamp
+    mutable std::optional<FileStamp> cache_stamp;
 };
 } // namespace multipass
@@ -24,8 +24,10 @@
 #include <QByteArray>
 #include <QString>
 
+#include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace multipass
@@ -38,9 +40,17 @@ struct SimpleStreamsManifest
         const QString& host_url,
         std::function<bool(VMImageInfo&)> mutator = [](VMImageInfo&) { return true; });
 
+    // Compact binary form of an already parsed manifest, which loads without any JSON parsing
+    static std::unique_ptr<SimpleStreamsManifest> fromBinary(const QByteArray& data);
+    QByteArray toBinary() const;
+
     const QString updated_at;
     const std::vector<VMImageInfo> products;
     const std::unordered_map<QString, const VMImageInfo*> image_records;
+    // Products by lowercase id, in product order for equal ids, for full-hash and prefix lookups
+    const std::multimap<QString, const VMImageInfo*> products_by_id;
+    // Products that carry aliases, i.e. the latest version of each release
+    const std::vector<const VMImageInfo*> aliased_products;
 
     SimpleStreamsManifest(const QString& updated_at, std::vector<VMImageInfo>&& images);
 };
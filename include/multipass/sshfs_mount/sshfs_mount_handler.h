@@ -18,26 +18,86 @@
 #pragma once
 
 #include <multipass/mount_handler.h>
-#include <multipass/process/process.h>
-#include <multipass/qt_delete_later_unique_ptr.h>
 #include <multipass/sshfs_server_config.h>
 
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
 namespace multipass
 {
+// Whether sshfs is available in each instance, and how to run it there, checked by the first mount
+// to activate after the instance boots. Mounts activating at the same time wait on that check
+// instead of repeating it. The daemon keeps one of these for all of its SSHFS mounts.
+class SSHFSChecks
+{
+public:
+    using Result = std::optional<SshfsGuestInfo>;
+    using Check = std::shared_ptr<const std::shared_future<Result>>; // compared by identity
+
+    // Runs check for the instance unless another one is underway or has succeeded, in which case
+    // that one's outcome is returned instead. Either way, the check that was used is returned too.
+    std::pair<Result, Check> run_once(const std::string& name,
+                                      const std::function<Result()>& check);
+
+    // Lets the next mount check the instance again, unless its check was already replaced
+    void forget(const std::string& name, const Check& used);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, Check> checks;
+};
+
+// The sshfs_server processes serving SSHFS mounts, one per instance. Each serves all the mounts of
+// its instance over a single SSH session, a channel per mount, so that mounts come and go without
+// disturbing the others. The daemon keeps one of these for all of its SSHFS mounts.
+class SSHFSServers
+{
+public:
+    // Has the instance's sshfs_server serve config.source_path at config.target_path, starting the
+    // process with that mount if it is not running. Blocks until the mount is served, throws if it
+    // cannot be.
+    void attach(const SSHFSServerConfig& config, std::chrono::milliseconds timeout);
+
+    // Has the instance's sshfs_server stop serving target, stopping the process along with its
+    // last mount. Unless forced, throws if that does not go well.
+    void detach(const std::string& instance, const std::string& target, bool force);
+
+private:
+    class Server;
+
+    std::shared_ptr<Server> server_for(const std::string& instance);
+    void retire(const std::string& instance, const std::shared_ptr<Server>& server);
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Server>> servers;
+};
+
+// Serves one mount through the sshfs_server of its instance, which it shares with the instance's
+// other mounts, as it does finding out whether and how sshfs runs in the instance.
 class SSHFSMountHandler : public MountHandler
 {
 public:
     SSHFSMountHandler(VirtualMachine* vm,
                       const SSHKeyProvider* ssh_key_provider,
                       const std::string& target,
-                      VMMount mount_spec);
+                      VMMount mount_spec,
+                      SSHFSChecks& sshfs_checks,
+                      SSHFSServers& sshfs_servers);
     ~SSHFSMountHandler() override;
 
     void activate_impl(ServerVariant server, std::chrono::milliseconds timeout) override;
     void deactivate_impl(bool force) override;
 
 private:
-    qt_delete_later_unique_ptr<Process> process;
     SSHFSServerConfig config;
+    SSHFSChecks& sshfs_checks;
+    SSHFSServers& sshfs_servers;
+    SSHFSChecks::Check sshfs_check; // the one this mount was activated with
 };
 } // namespace multipass
@@ -19,11 +19,21 @@
 
 #include <multipass/id_mappings.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace multipass
 {
 
+// What mounting needs to know about an instance, which is the same for all of its mounts
+struct SshfsGuestInfo
+{
+    std::string sshfs_exec_line;
+    int default_uid;
+    int default_gid;
+};
+
 struct SSHFSServerConfig
 {
     std::string host;
@@ -35,6 +45,15 @@ struct SSHFSServerConfig
     std::string target_path;
     id_mappings gid_mappings;
     id_mappings uid_mappings;
+    bool cache{false}; // whether sshfs may answer from its caches, see mount_caching_key
+    // What sshfs_server would otherwise discover in the instance by itself, for every mount.
+    // Discovery is left to it when sshfs_exec_line is empty.
+    std::string sshfs_exec_line{};
+    int instance_uid{-1};
+    int instance_gid{-1};
+    // Every source the process serves, when it serves more than source_path. Kept up to date by
+    // whoever attaches and detaches mounts, for the AppArmor profile to be reloaded with.
+    std::shared_ptr<const std::vector<std::string>> source_paths{};
 };
 
 } // namespace multipass
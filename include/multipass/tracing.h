@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "singleton.h"
+
+#include <QString>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define MP_TRACER multipass::Tracer::instance()
+
+namespace multipass
+{
+// Where the time of one operation on one instance (e.g. a launch) went, stage by stage
+struct Trace
+{
+    struct Span
+    {
+        std::string stage;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::duration duration;
+        std::thread::id thread;
+    };
+
+    std::string instance;
+    std::string operation;
+    std::chrono::system_clock::time_point started_at;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration{};
+    std::vector<Span> spans;
+};
+
+// Collects the spans of the operations in progress. Spans of instances without an operation in
+// progress are dropped, so stages shared by several operations can be traced unconditionally.
+class Tracer : public Singleton<Tracer>
+{
+public:
+    Tracer(const Singleton<Tracer>::PrivatePass&) noexcept;
+
+    virtual void begin(const std::string& instance, const std::string& operation);
+    virtual std::optional<Trace> end(const std::string& instance);
+    virtual void record(const std::string& instance,
+                        const std::string& stage,
+                        std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point finish);
+
+private:
+    std::mutex mutex;
+    std::map<std::string, Trace> traces;
+};
+
+// Attributes spans that don't name their instance, on this thread, to the given instance. Code deep
+// in the pipeline (e.g. the image vault) has no idea what instance it is working for.
+class TraceScope
+{
+public:
+    explicit TraceScope(std::string instance);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    static const std::string& current();
+
+private:
+    std::string previous;
+};
+
+// Records the time from its construction to its destruction as a stage of the instance's trace
+class TraceSpan
+{
+public:
+    explicit TraceSpan(std::string stage);
+    TraceSpan(std::string instance, std::string stage);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    std::string instance;
+    std::string stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Wraps a callable so that it runs in this thread's trace scope, wherever it ends up running
+template <typename Function>
+auto in_trace_scope(Function&& function)
+{
+    return [instance = TraceScope::current(),
+            function = std::forward<Function>(function)]() mutable {
+        TraceScope scope{instance};
+        return function();
+    };
+}
+
+// The Chrome trace event format, which chrome://tracing and Perfetto open
+std::string to_chrome_trace(const Trace& trace);
+// Writes the trace into the directory, keeping only the most recent ones there. Returns its path.
+QString write_chrome_trace(const Trace& trace, const QString& dir);
+// A table of how long each stage took, for the client
+std::string summary_of(const Trace& trace);
+} // namespace multipass
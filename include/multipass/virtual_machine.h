@@ -18,6 +18,8 @@
 #pragma once
 
 #include "disabled_copy_move.h"
+#include "disk_profile.h"
+#include "memory_size.h"
 #include "network_interface.h"
 
 #include <QDir>
@@ -26,13 +28,13 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace multipass
 {
 struct IPAddress;
-class MemorySize;
 class VMMount;
 struct VMSpecs;
 class MountHandler;
@@ -65,6 +67,15 @@ public:
     using UPtr = std::unique_ptr<VirtualMachine>;
     using ShPtr = std::shared_ptr<VirtualMachine>;
 
+    // Bounds within which update_cpus and resize_memory apply to a running instance
+    struct LiveResizeLimits
+    {
+        int min_cores;
+        int max_cores;
+        MemorySize min_memory;
+        MemorySize max_memory;
+    };
+
     virtual ~VirtualMachine() = default;
     virtual void start() = 0;
     virtual void shutdown(ShutdownPolicy shutdown_policy = ShutdownPolicy::Powerdown) = 0;
@@ -89,6 +100,20 @@ public:
     virtual void update_cpus(int num_cores) = 0;
     virtual void resize_memory(const MemorySize& new_size) = 0;
     virtual void resize_disk(const MemorySize& new_size) = 0;
+    // Nothing unless the instance is running and can be resized in place (disks only ever grow)
+    virtual std::optional<LiveResizeLimits> live_resize_limits() const
+    {
+        return std::nullopt;
+    }
+    virtual void set_disk_profile(DiskProfile profile) = 0;
+    virtual void set_memory_density(bool enabled) = 0;
+    // Ask a running instance in memory density mode to give back memory beyond the target
+    virtual void set_balloon_target(const MemorySize& target) = 0;
+    // The memory the instance occupies on the host, if known
+    virtual std::optional<MemorySize> host_memory_usage() const
+    {
+        return std::nullopt;
+    }
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) = 0;
@@ -112,6 +137,7 @@ public:
         const std::string& old_name,
         const std::string& new_name) = 0; // only VM can avoid repeated names
     virtual void delete_snapshot(const std::string& name) = 0;
+    virtual void delete_snapshots(const std::vector<std::string>& names) = 0;
     virtual void restore_snapshot(const std::string& name, VMSpecs& specs) = 0;
     virtual void load_snapshots() = 0;
     virtual std::vector<std::string> get_childrens_names(const Snapshot* parent) const = 0;
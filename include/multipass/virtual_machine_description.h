@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <multipass/disk_profile.h>
 #include <multipass/memory_size.h>
 #include <multipass/network_interface.h>
 #include <multipass/vm_image.h>
@@ -48,6 +49,8 @@ public:
     YAML::Node user_data_config;
     YAML::Node vendor_data_config;
     YAML::Node network_data_config;
+    DiskProfile disk_profile = DiskProfile::standard;
+    bool memory_density = false;
 };
 } // namespace multipass
 
@@ -48,6 +48,16 @@ public:
     virtual VirtualMachine::UPtr create_virtual_machine(const VirtualMachineDescription& desc,
                                                         const SSHKeyProvider& key_provider,
                                                         VMStatusMonitor& monitor) = 0;
+
+    /** Copies the files of an instance that a clone of it needs, which can take long.
+     *
+     * @param monitor Told how far along the copy is, in percent; the copy is abandoned with an
+     * exception if it returns false
+     */
+    virtual void clone_instance_files(const std::string& src_name,
+                                      const std::string& dest_name,
+                                      const ProgressMonitor& monitor) = 0;
+    // Expects the instance files to have been cloned already
     virtual VirtualMachine::UPtr clone_bare_vm(const VMSpecs& src_spec,
                                                const VMSpecs& dest_spec,
                                                const std::string& src_name,
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "disk_profile.h"
 #include "memory_size.h"
 #include "network_interface.h"
 #include "virtual_machine.h"
@@ -44,6 +45,8 @@ struct VMSpecs
     QJsonObject metadata;
     int clone_count =
         0; // tracks the number of cloned vm from this source vm (regardless of deletes)
+    DiskProfile disk_profile = DiskProfile::standard;
+    bool memory_density = false; // let the host reclaim memory the guest is not using
 
     friend inline bool operator==(const VMSpecs& a, const VMSpecs& b) = default;
 };
@@ -120,7 +120,7 @@ mp::ParseCode mp::ArgParser::prepare_alias_execution(const QString& alias)
     return mp::ParseCode::Ok;
 }
 
-mp::ParseCode mp::ArgParser::parse(const std::optional<mp::AliasDict>& aliases)
+mp::ParseCode mp::ArgParser::parse(const mp::AliasDict* aliases)
 {
     QCommandLineOption help_option(help_option_names, "Displays help on commandline options");
     QCommandLineOption verbose_option(
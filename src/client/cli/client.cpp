@@ -28,6 +28,7 @@
 #include "cmd/info.h"
 #include "cmd/launch.h"
 #include "cmd/list.h"
+#include "cmd/metrics.h"
 #include "cmd/mount.h"
 #include "cmd/networks.h"
 #include "cmd/prefer.h"
@@ -94,6 +95,7 @@ mp::Client::Client(ClientConfig& config)
     add_command<cmd::Help>();
     add_command<cmd::Info>();
     add_command<cmd::List>();
+    add_command<cmd::Metrics>();
     add_command<cmd::Networks>();
     add_command<cmd::Mount>();
     add_command<cmd::Prefer>(aliases);
@@ -137,7 +139,7 @@ int mp::Client::run(const QStringList& arguments)
     parser.setApplicationDescription(description);
 
     mp::ReturnCode ret = mp::ReturnCode::Ok;
-    ParseCode parse_status = parser.parse(aliases);
+    ParseCode parse_status = parser.parse(&aliases);
 
     auto verbosity =
         parser.verbosityLevel(); // try to respect requested verbosity, even if parsing failed
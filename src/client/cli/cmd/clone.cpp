@@ -47,8 +47,26 @@ mp::ReturnCode cmd::Clone::run(ArgParser* parser)
         return standard_failure_handler_for(name(), cerr, status, reply.reply_message());
     };
 
+    auto streaming_callback = [this, &spinner](CloneReply& reply,
+                                               grpc::ClientReaderWriterInterface<CloneRequest,
+                                                                                 CloneReply>*) {
+        if (!reply.log_line().empty())
+            spinner.print(cerr, reply.log_line());
+
+        if (!reply.percent_complete().empty())
+        {
+            spinner.stop();
+            spinner.start("Cloning " + rpc_request.source_name() + ": " +
+                          reply.percent_complete() + "%");
+        }
+    };
+
     spinner.start("Cloning " + rpc_request.source_name());
-    return dispatch(&RpcMethod::clone, rpc_request, action_on_success, action_on_failure);
+    return dispatch(&RpcMethod::clone,
+                    rpc_request,
+                    action_on_success,
+                    action_on_failure,
+                    streaming_callback);
 }
 
 std::string cmd::Clone::name() const
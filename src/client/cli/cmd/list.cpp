@@ -21,9 +21,45 @@
 #include <multipass/cli/argparser.h>
 #include <multipass/cli/formatter.h>
 
+#include <algorithm>
+
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 
+namespace
+{
+// Moves the cursor home and clears the terminal, so that each listing replaces the last
+constexpr auto clear_screen = "\x1b[H\x1b[2J";
+
+// Returns whether the reply changed the listing
+bool apply_watch_reply(const mp::WatchReply& reply, mp::InstancesList& listing)
+{
+    auto& instances = *listing.mutable_instances();
+    if (reply.has_snapshot())
+        instances = reply.snapshot().instances();
+
+    for (const auto& change : reply.changes())
+    {
+        const auto& instance = change.instance();
+        auto it = std::find_if(instances.begin(), instances.end(), [&instance](const auto& listed) {
+            return listed.name() == instance.name();
+        });
+
+        if (change.removed())
+        {
+            if (it != instances.end())
+                instances.erase(it);
+        }
+        else if (it != instances.end())
+            *it = instance;
+        else
+            *instances.Add() = instance;
+    }
+
+    return reply.has_snapshot() || reply.changes_size() > 0;
+}
+} // namespace
+
 mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -32,6 +68,9 @@ mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
+    if (watch)
+        return watch_instances(parser);
+
     auto on_success = [this](ListReply& reply) {
         cout << chosen_formatter->format(reply);
 
@@ -49,6 +88,36 @@ mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
     return dispatch(&RpcMethod::list, request, on_success, on_failure);
 }
 
+mp::ReturnCode cmd::List::watch_instances(mp::ArgParser* parser)
+{
+    ListReply listing;
+    listing.mutable_instance_list();
+
+    auto on_success = [](WatchReply&) { return ReturnCode::Ok; };
+
+    auto on_failure = [this](grpc::Status& status) {
+        return standard_failure_handler_for(name(), cerr, status);
+    };
+
+    using Client = grpc::ClientReaderWriterInterface<WatchRequest, WatchReply>;
+    auto streaming_callback = [this, &listing](WatchReply& reply, Client*) {
+        if (!reply.log_line().empty())
+            cerr << reply.log_line();
+
+        if (!apply_watch_reply(reply, *listing.mutable_instance_list()))
+            return;
+
+        if (term->is_live())
+            cout << clear_screen;
+
+        cout << chosen_formatter->format(listing) << std::flush;
+    };
+
+    WatchRequest watch_request;
+    watch_request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::watch, watch_request, on_success, on_failure, streaming_callback);
+}
+
 std::string cmd::List::name() const
 {
     return "list";
@@ -80,8 +149,11 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
     QCommandLineOption noIpv4Option("no-ipv4",
                                     "Do not query the instances for the IPv4's they are using");
     noIpv4Option.setFlags(QCommandLineOption::HiddenFromHelp);
+    QCommandLineOption watchOption("watch",
+                                   "Keep listing the instances as they change, without "
+                                   "their IPv4 addresses");
 
-    parser->addOptions({snapshotsOption, formatOption, noIpv4Option});
+    parser->addOptions({snapshotsOption, formatOption, noIpv4Option, watchOption});
 
     auto status = parser->commandParse(this);
 
@@ -102,6 +174,13 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
         return ParseCode::CommandLineError;
     }
 
+    if (parser->isSet(snapshotsOption) && parser->isSet(watchOption))
+    {
+        cerr << "Snapshots cannot be watched\n";
+        return ParseCode::CommandLineError;
+    }
+
+    watch = parser->isSet(watchOption);
     request.set_snapshots(parser->isSet(snapshotsOption));
     request.set_request_ipv4(!parser->isSet(noIpv4Option));
 
@@ -38,9 +38,11 @@ public:
 
 private:
     ParseCode parse_args(ArgParser* parser);
+    ReturnCode watch_instances(ArgParser* parser);
 
     ListRequest request;
     Formatter* chosen_formatter;
+    bool watch = false;
 };
 } // namespace cmd
 } // namespace multipass
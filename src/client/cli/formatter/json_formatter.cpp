@@ -135,6 +135,8 @@ QJsonObject generate_instance_details(const mp::DetailedInfoItem& item)
         memory.insert("used", std::stoll(instance_details.memory_usage()));
     if (!item.memory_total().empty())
         memory.insert("total", std::stoll(item.memory_total()));
+    if (!instance_details.host_memory_usage().empty())
+        memory.insert("host", std::stoll(instance_details.host_memory_usage()));
     instance_info.insert("memory", memory);
 
     QJsonArray ipv4_addrs;
@@ -186,6 +186,11 @@ void generate_instance_details(Dest&& dest, const mp::DetailedInfoItem& item)
                    "{:<16}{}\n",
                    "Memory usage:",
                    to_usage(instance_details.memory_usage(), item.memory_total()));
+    if (!instance_details.host_memory_usage().empty())
+        fmt::format_to(dest,
+                       "{:<16}{}\n",
+                       "Host memory:",
+                       mp::MemorySize{instance_details.host_memory_usage()}.human_readable());
 
     const auto& mount_paths = item.mount_info().mount_paths();
     fmt::format_to(dest, "{:<16}{}", "Mounts:", mount_paths.empty() ? "--\n" : "");
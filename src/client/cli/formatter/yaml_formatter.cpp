@@ -141,6 +141,8 @@ YAML::Node generate_instance_details(const mp::DetailedInfoItem& item)
                           : YAML::Node(std::stoll(instance_details.memory_usage()));
     memory["total"] =
         item.memory_total().empty() ? YAML::Node() : YAML::Node(std::stoll(item.memory_total()));
+    if (!instance_details.host_memory_usage().empty())
+        memory["host"] = std::stoll(instance_details.host_memory_usage());
     instance_node["memory"] = memory;
 
     instance_node["ipv4"] = YAML::Node(YAML::NodeType::Sequence);
@@ -36,8 +36,11 @@ int main_impl(int argc, char* argv[])
     mp::Console::setup_environment();
     auto term = mp::Terminal::make_terminal();
 
+    // Cheap: the settings file is only read when a setting is first looked up
     mp::client::register_global_settings_handlers();
 
+    // Not deferred: gRPC sets up TLS with the client certificate when the channel is created, and
+    // the commands that parse the arguments are handed the resulting stub up front
     mp::ClientConfig config{mp::client::get_server_address(),
                             mp::client::get_cert_provider(),
                             term.get()};
@@ -50,8 +50,6 @@ mp::AliasDict::AliasDict(mp::Terminal* term) : cout(term->cout()), cerr(term->ce
     const auto cli_client_dir_path = QDir{user_config_path.absoluteFilePath(mp::client_name)};
 
     aliases_file = cli_client_dir_path.absoluteFilePath(file_name).toStdString();
-
-    load_dict();
 }
 
 mp::AliasDict::~AliasDict()
@@ -71,6 +69,7 @@ mp::AliasDict::~AliasDict()
 
 void mp::AliasDict::set_active_context(const std::string& new_active_context)
 {
+    ensure_loaded();
     if (new_active_context != active_context)
     {
         modified = true;
@@ -85,11 +84,13 @@ void mp::AliasDict::set_active_context(const std::string& new_active_context)
 
 std::string mp::AliasDict::active_context_name() const
 {
+    ensure_loaded();
     return active_context;
 }
 
 const mp::AliasContext& mp::AliasDict::get_active_context() const
 {
+    ensure_loaded();
     try
     {
         return aliases.at(active_context);
@@ -103,6 +104,7 @@ const mp::AliasContext& mp::AliasDict::get_active_context() const
 
 bool mp::AliasDict::add_alias(const std::string& alias, const mp::AliasDefinition& command)
 {
+    ensure_loaded();
     if (aliases[active_context].try_emplace(alias, command).second)
     {
         modified = true;
@@ -115,6 +117,7 @@ bool mp::AliasDict::add_alias(const std::string& alias, const mp::AliasDefinitio
 
 bool mp::AliasDict::exists_alias(const std::string& alias) const
 {
+    ensure_loaded();
     for (const auto& [_, context_dict] : aliases)
     {
         if (context_dict.find(alias) != context_dict.cend())
@@ -133,6 +136,7 @@ bool mp::AliasDict::is_alias_unique(const std::string& alias) const
 
 bool mp::AliasDict::remove_alias(const std::string& alias)
 {
+    ensure_loaded();
     if (aliases[active_context].erase(alias) > 0)
     {
         modified = true;
@@ -144,6 +148,7 @@ bool mp::AliasDict::remove_alias(const std::string& alias)
 
 bool mp::AliasDict::remove_context(const std::string& context)
 {
+    ensure_loaded();
     if (aliases.erase(context) > 0)
     {
         modified = true;
@@ -199,6 +204,7 @@ std::vector<mp::ContextAliasPair> mp::AliasDict::remove_aliases_for_instance(
 std::optional<mp::ContextAliasPair> mp::AliasDict::get_context_and_alias(
     const std::string& alias) const
 {
+    ensure_loaded();
     // This will never throw because we already checked that the active context exists.
     if (aliases.at(active_context).count(alias) > 0)
         return std::make_pair(active_context, alias);
@@ -223,6 +229,7 @@ std::optional<mp::ContextAliasPair> mp::AliasDict::get_context_and_alias(
 std::optional<mp::AliasDefinition> mp::AliasDict::get_alias_from_current_context(
     const std::string& alias) const
 {
+    ensure_loaded();
     try
     {
         return aliases.at(active_context).at(alias);
@@ -240,6 +247,7 @@ std::optional<mp::AliasDefinition> mp::AliasDict::get_alias_from_current_context
 // The given alias can be fully qualified or not.
 std::optional<mp::AliasDefinition> mp::AliasDict::get_alias(const std::string& alias) const
 {
+    ensure_loaded();
     std::optional<mp::AliasDefinition> alias_in_current_context =
         get_alias_from_current_context(alias);
 
@@ -277,6 +285,7 @@ std::optional<mp::AliasDefinition> mp::AliasDict::get_alias(const std::string& a
 
 QJsonObject mp::AliasDict::to_json() const
 {
+    ensure_loaded();
     auto alias_to_json = [](const mp::AliasDefinition& alias) -> QJsonObject {
         QJsonObject json;
 
@@ -310,7 +319,16 @@ QJsonObject mp::AliasDict::to_json() const
     return dict_json;
 }
 
-void mp::AliasDict::load_dict()
+void mp::AliasDict::ensure_loaded() const
+{
+    if (!loaded)
+    {
+        load_dict();
+        loaded = true;
+    }
+}
+
+void mp::AliasDict::load_dict() const
 {
     QFile db_file{QString::fromStdString(aliases_file)};
 
@@ -441,6 +459,7 @@ void mp::AliasDict::sanitize_contexts()
 std::optional<mp::AliasDefinition> mp::AliasDict::get_alias_from_all_contexts(
     const std::string& alias) const
 {
+    ensure_loaded();
     const AliasDefinition* ret;
     bool found{false};
 
@@ -18,6 +18,7 @@
 #include "daemon.h"
 #include "base_cloud_init_config.h"
 #include "instance_settings_handler.h"
+#include "memory_density_policy.h"
 #include "runtime_instance_info_helper.h"
 #include "snapshot_settings_handler.h"
 
@@ -33,11 +34,13 @@
 #include <multipass/exceptions/sshfs_missing_error.h>
 #include <multipass/exceptions/start_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
+#include <multipass/executor.h>
 #include <multipass/image_host/vm_image_host.h>
 #include <multipass/ip_address.h>
 #include <multipass/json_utils.h>
 #include <multipass/logging/client_logger.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/name_generator.h>
 #include <multipass/network_interface.h>
 #include <multipass/platform.h>
@@ -48,6 +51,7 @@
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/top_catch_all.h>
+#include <multipass/tracing.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine.h>
 #include <multipass/virtual_machine_description.h>
@@ -69,7 +73,6 @@
 #include <QStorageInfo>
 #include <QString>
 #include <QSysInfo>
-#include <QtConcurrent/QtConcurrent>
 
 #include <algorithm>
 #include <cassert>
@@ -96,6 +99,10 @@ constexpr auto category = "daemon";
 constexpr auto instance_db_name = "multipassd-vm-instances.json";
 constexpr auto reboot_cmd = "sudo reboot";
 constexpr auto stop_ssh_cmd = "sudo systemctl stop ssh";
+constexpr auto memory_reclaim_interval = std::chrono::minutes(2);
+// How long a watch stream stays quiet before an empty reply checks that the client is still there
+constexpr auto watch_keepalive_interval = std::chrono::seconds(30);
+constexpr auto background_task_grace = std::chrono::seconds(10); // when shutting down
 constexpr auto sshfs_error_template =
     "Error enabling mount support in '{}'"
     "\n\nPlease install the 'multipass-sshfs' snap manually inside the instance.";
@@ -268,6 +275,9 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
         auto deleted = record["deleted"].toBool();
         auto metadata = record["metadata"].toObject();
         auto clone_count = record["clone_count"].toInt();
+        auto disk_profile = mp::disk_profile_from(record["disk_profile"].toString())
+                                .value_or(mp::DiskProfile::standard);
+        auto memory_density = record["memory_density"].toBool();
 
         if (!num_cores && !deleted && ssh_username.empty() && metadata.isEmpty() &&
             !mp::MemorySize{mem_size}.in_bytes() && !mp::MemorySize{disk_space}.in_bytes())
@@ -306,7 +316,9 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
             mounts,
             deleted,
             metadata,
-            clone_count};
+            clone_count,
+            disk_profile,
+            memory_density};
     }
     return reconstructed_records;
 }
@@ -339,6 +351,8 @@ QJsonObject vm_spec_to_json(const mp::VMSpecs& specs)
 
     json.insert("mounts", json_mounts);
     json.insert("clone_count", specs.clone_count);
+    json.insert("disk_profile", mp::disk_profile_name(specs.disk_profile));
+    json.insert("memory_density", specs.memory_density);
 
     return json;
 }
@@ -348,6 +362,33 @@ std::string generate_next_clone_name(int clone_count, const std::string& source_
     return fmt::format("{}-clone{}", source_name, clone_count + 1);
 }
 
+// Writes the instance's trace under the data directory and returns a summary of it, if it had one.
+// The operation's duration goes to the metrics too.
+std::string finish_trace(const std::string& name, const QString& data_directory)
+{
+    const auto trace = MP_TRACER.end(name);
+    if (!trace)
+        return {};
+
+    MP_METRICS.instance_operation_durations.with(trace->operation).observe(trace->duration);
+
+    try
+    {
+        const auto path = mp::write_chrome_trace(*trace, QDir{data_directory}.filePath("traces"));
+        mpl::debug(category, "Wrote the {} trace of {} to {}", trace->operation, name, path);
+    }
+    catch (const std::exception& e)
+    {
+        mpl::warn(category,
+                  "Cannot write the {} trace of {}: {}",
+                  trace->operation,
+                  name,
+                  e.what());
+    }
+
+    return mp::summary_of(*trace);
+}
+
 auto fetch_image_for(const std::string& name,
                      mp::VirtualMachineFactory& factory,
                      mp::VMImageVault& vault)
@@ -600,6 +641,12 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_restore, &daemon, &mp::Daemon::restore);
     QObject::connect(&rpc, &mp::DaemonRpc::on_daemon_info, &daemon, &mp::Daemon::daemon_info);
     QObject::connect(&rpc, &mp::DaemonRpc::on_wait_ready, &daemon, &mp::Daemon::wait_ready);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_metrics, &daemon, &mp::Daemon::metrics);
+    QObject::connect(&rpc,
+                     &mp::DaemonRpc::on_watch,
+                     &daemon,
+                     &mp::Daemon::watch,
+                     Qt::DirectConnection);
 }
 
 enum class InstanceGroup
@@ -1210,6 +1257,7 @@ mp::SettingsHandler* register_instance_mod(
     InstanceTable& operative_instances,
     const InstanceTable& deleted_instances,
     const std::unordered_set<std::string>& preparing_instances,
+    const std::unordered_multiset<std::string>& cloning_sources,
     std::function<void()> instance_persister,
     std::function<bool(const std::string&)> is_bridged,
     std::function<void(const std::string&)> add_interface)
@@ -1219,6 +1267,7 @@ mp::SettingsHandler* register_instance_mod(
                                                       operative_instances,
                                                       deleted_instances,
                                                       preparing_instances,
+                                                      cloning_sources,
                                                       std::move(instance_persister),
                                                       is_bridged,
                                                       add_interface));
@@ -1342,6 +1391,28 @@ void populate_snapshot_info(mp::VirtualMachine& vm,
 
     populate_snapshot_fundamentals(snapshot, fundamentals);
 }
+
+void populate_release_and_os(mp::ListVMInstance& entry, const mp::DaemonConfig& config)
+{
+    auto vm_image = fetch_image_for(entry.name(), *config.factory, *config.vault);
+    auto current_release = vm_image.original_release;
+
+    if (!vm_image.id.empty() && current_release.empty())
+    {
+        try
+        {
+            auto vm_image_info = config.image_hosts.back()->info_for_full_hash(vm_image.id);
+            current_release = vm_image_info.release_title.toStdString();
+        }
+        catch (const std::exception& e)
+        {
+            mpl::warn(category, "Cannot fetch image information: {}", e.what());
+        }
+    }
+
+    entry.set_current_release(current_release);
+    entry.set_os(vm_image.os);
+}
 } // namespace
 
 mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
@@ -1357,6 +1428,7 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
           operative_instances,
           deleted_instances,
           preparing_instances,
+          cloning_sources,
           [this] { persist_instances(); },
           [this](const std::string& n) { return is_bridged(n); },
           [this](const std::string& n) { return add_bridged_interface(n); })},
@@ -1429,7 +1501,9 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                                               {},
                                               {},
                                               {},
-                                              {}};
+                                              {},
+                                              spec.disk_profile,
+                                              spec.memory_density};
 
         auto& instance_record = spec.deleted ? deleted_instances : operative_instances;
         auto instance = instance_record[name] =
@@ -1453,6 +1527,7 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
 
         if (!spec.deleted)
             init_mounts(name);
+        publish_instance(name);
         std::unique_lock lock{start_mutex};
 
         if (spec.state == e_state::running)
@@ -1510,14 +1585,14 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
         else
         {
-            image_update_future = QtConcurrent::run([this] {
+            image_update_future = MP_EXECUTOR.run(Lane::blocking, [this] {
                 config->vault->prune_expired_images();
 
                 auto prepare_action = [this](const VMImage& source_image) -> VMImage {
                     return config->factory->prepare_source_image(source_image);
                 };
 
-                auto download_monitor = [](int download_type, int percentage) {
+                auto download_monitor = [this](int download_type, int percentage) {
                     static int last_percentage_logged = -1;
                     if (percentage % 10 == 0)
                     {
@@ -1529,7 +1604,7 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                             last_percentage_logged = percentage;
                         }
                     }
-                    return true;
+                    return !shutting_down.is_cancelled();
                 };
 
                 try
@@ -1546,11 +1621,17 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
     });
     source_images_maintenance_task.start(config->image_refresh_timer);
+
+    // Periodically resize the balloons of instances in memory density mode to what they are using
+    connect(&memory_reclaim_task, &QTimer::timeout, this, &Daemon::reclaim_idle_memory);
+    memory_reclaim_task.start(memory_reclaim_interval);
 }
 
 mp::Daemon::~Daemon()
 {
     mp::top_catch_all(category, [this] {
+        shutting_down.cancel();
+        instance_watchers.close();
         MP_SETTINGS.unregister_handler(instance_mod_handler);
         MP_SETTINGS.unregister_handler(snapshot_mod_handler);
 
@@ -1578,6 +1659,17 @@ mp::Daemon::~Daemon()
          */
         update_manifests_all_task.shutdown();
 
+        memory_reclaim_task.stop();
+        memory_reclaim_future.waitForFinished();
+
+        // Readiness waits and other tasks may still be running on the daemon's behalf, with no
+        // watcher left to wait for them. Some take minutes, which shutting down does not wait out.
+        if (!MP_EXECUTOR.wait_for_done(background_task_grace))
+            mpl::warn(category,
+                      "{} background tasks are still running, shutting down without them",
+                      MP_EXECUTOR.stats(Lane::cpu).running +
+                          MP_EXECUTOR.stats(Lane::blocking).running);
+
         // waitForFinished() ensures that the futures are finished gracefully
         // but there's a chance that the signals which are queued during their
         // execution haven't got executed yet. So, process all the remaining events
@@ -1739,7 +1831,7 @@ try
                 }
             };
 
-            image_host->for_each_entry_do(action);
+            image_host->for_each_aliased_entry_do(action);
         }
     }
     else
@@ -1888,25 +1980,7 @@ try
         else
             entry->mutable_instance_status()->set_status(grpc_instance_status_for(present_state));
 
-        auto vm_image = fetch_image_for(name, *config->factory, *config->vault);
-        auto current_release = vm_image.original_release;
-        auto os = vm_image.os;
-
-        if (!vm_image.id.empty() && current_release.empty())
-        {
-            try
-            {
-                auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
-                current_release = vm_image_info.release_title.toStdString();
-            }
-            catch (const std::exception& e)
-            {
-                mpl::warn(category, "Cannot fetch image information: {}", e.what());
-            }
-        }
-
-        entry->set_current_release(current_release);
-        entry->set_os(os);
+        populate_release_and_os(*entry, *config);
 
         if (request->request_ipv4() && MP_UTILS.is_running(present_state))
         {
@@ -2083,6 +2157,7 @@ try
         }
 
         vm_instance_specs[name].mounts[target_path] = vm_mount;
+        instance_watchers.notify(name, InstanceWatchers::Change::mounts);
     }
 
     persist_instances();
@@ -2125,6 +2200,7 @@ try
             operative_instances[name] = std::move(vm_it->second);
             deleted_instances.erase(vm_it);
             init_mounts(name);
+            publish_instance(name);
             mpl::debug(category, "Instance recovered: {}", name);
         }
         persist_instances();
@@ -2206,6 +2282,7 @@ try
 
     std::vector<std::string> starting_vms{};
     starting_vms.reserve(instance_selection.operative_selection.size());
+    std::vector<std::string> traced_vms; // the ones started here, rather than already starting
 
     fmt::memory_buffer start_errors, start_warnings;
     for (auto& vm_it : instance_selection.operative_selection)
@@ -2213,6 +2290,14 @@ try
         std::lock_guard lock{start_mutex};
         const auto& name = vm_it->first;
         auto& vm = *vm_it->second;
+        if (cloning_sources.count(name))
+        {
+            fmt::format_to(std::back_inserter(start_errors),
+                           "Cannot start the instance '{}' while it is being cloned.",
+                           name);
+            continue;
+        }
+
         switch (vm.current_state())
         {
         case VirtualMachine::State::unknown:
@@ -2245,22 +2330,38 @@ try
                 mpl::error(category, "Mounts have been disabled on this instance of Multipass");
             }
 
-            vm.start();
+            MP_TRACER.begin(name, "start");
+            try
+            {
+                TraceSpan span{name, "start"};
+                vm.start();
+            }
+            catch (...)
+            {
+                MP_TRACER.end(name);
+                throw;
+            }
+            traced_vms.push_back(name);
+            MP_METRICS.instance_operations.with("start").add();
         }
 
         starting_vms.push_back(vm_it->first);
     }
 
-    auto future_watcher = create_future_watcher();
+    auto future_watcher = create_future_watcher([this, traced_vms] {
+        for (const auto& name : traced_vms)
+            finish_trace(name, config->data_directory);
+    });
     future_watcher->setFuture(
-        QtConcurrent::run(&Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
-                          this,
-                          server,
-                          starting_vms,
-                          timeout,
-                          status_promise,
-                          fmt::to_string(start_errors),
-                          fmt::to_string(start_warnings)));
+        MP_EXECUTOR.run(Lane::blocking,
+                        &Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
+                        this,
+                        server,
+                        starting_vms,
+                        timeout,
+                        status_promise,
+                        fmt::to_string(start_errors),
+                        fmt::to_string(start_warnings)));
 }
 catch (const std::exception& e)
 {
@@ -2298,6 +2399,9 @@ try
                             VirtualMachine& vm) { return this->shutdown_vm(vm, delay_minutes); };
 
         status = cmd_vms(instance_selection.operative_selection, operation);
+        if (!request->cancel_shutdown())
+            MP_METRICS.instance_operations.with("stop").add(
+                instance_selection.operative_selection.size());
     }
 
     status_promise->set_value(status);
@@ -2384,14 +2488,15 @@ try
 
     auto future_watcher = create_future_watcher();
     future_watcher->setFuture(
-        QtConcurrent::run(&Daemon::async_wait_for_ready_all<RestartReply, RestartRequest>,
-                          this,
-                          server,
-                          names_from(instance_targets),
-                          timeout,
-                          status_promise,
-                          std::string(),
-                          std::string()));
+        MP_EXECUTOR.run(Lane::blocking,
+                        &Daemon::async_wait_for_ready_all<RestartReply, RestartRequest>,
+                        this,
+                        server,
+                        names_from(instance_targets),
+                        timeout,
+                        status_promise,
+                        std::string(),
+                        std::string()));
 }
 catch (const std::exception& e)
 {
@@ -2418,6 +2523,13 @@ try
 
     if (status.ok())
     {
+        for (const auto& vm_it : instance_selection.operative_selection)
+            if (cloning_sources.count(vm_it->first))
+                return status_promise->set_value(grpc::Status{
+                    grpc::StatusCode::FAILED_PRECONDITION,
+                    fmt::format("Cannot delete instance '{}' while it is being cloned.",
+                                vm_it->first)});
+
         const bool purge = request->purge();
         bool purge_snapshots = request->purge_snapshots();
         auto instances_dirty = false;
@@ -2457,10 +2569,12 @@ try
                                               ? SnapshotPick{{}, true}
                                               : snapshot_pick_it->second;
 
-                if (!all || !purge) // if we're not purging the instance, we need to delete
-                                    // specified snapshots
-                    for (const auto& snapshot_name : pick)
-                        vm_it->second->delete_snapshot(snapshot_name);
+                // if we're not purging the instance, we need to delete specified snapshots
+                if ((!all || !purge) && !pick.empty())
+                {
+                    vm_it->second->delete_snapshots({pick.begin(), pick.end()});
+                    instance_watchers.notify(instance_name, InstanceWatchers::Change::snapshots);
+                }
 
                 if (all) // we're asked to delete the VM
                     instances_dirty |= delete_vm(vm_it, purge, response);
@@ -2515,6 +2629,7 @@ try
                 mount->deactivate();
                 vm_spec_mounts.erase(target);
                 vm_mounts.erase(expiring_it);
+                instance_watchers.notify(name, InstanceWatchers::Change::mounts);
             }
             catch (const std::runtime_error& e)
             {
@@ -2774,6 +2889,12 @@ try
                 grpc::Status{grpc::FAILED_PRECONDITION,
                              "Multipass can only take snapshots of stopped instances."});
 
+        if (cloning_sources.count(instance_name))
+            return status_promise->set_value(grpc::Status{
+                grpc::FAILED_PRECONDITION,
+                fmt::format("Cannot take a snapshot of '{}' while it is being cloned.",
+                            instance_name)});
+
         auto snapshot_name = request->snapshot();
         if (!snapshot_name.empty() && !mp::utils::valid_hostname(snapshot_name))
             return status_promise->set_value(
@@ -2786,6 +2907,7 @@ try
         SnapshotReply reply;
         reply.set_snapshot(
             vm_ptr->take_snapshot(spec_it->second, snapshot_name, request->comment())->get_name());
+        instance_watchers.notify(instance_name, InstanceWatchers::Change::snapshots);
 
         server->Write(reply);
     }
@@ -2834,6 +2956,12 @@ try
                 grpc::Status{grpc::FAILED_PRECONDITION,
                              "Multipass can only restore snapshots of stopped instances."});
 
+        if (cloning_sources.count(instance_name))
+            return status_promise->set_value(grpc::Status{
+                grpc::FAILED_PRECONDITION,
+                fmt::format("Cannot restore a snapshot of '{}' while it is being cloned.",
+                            instance_name)});
+
         auto spec_it = vm_instance_specs.find(instance_name);
         assert(spec_it != vm_instance_specs.end() && "missing instance specs");
         auto& vm_specs = spec_it->second;
@@ -2869,11 +2997,16 @@ try
         reply_msg(server, "Restoring snapshot");
         auto old_specs = vm_specs;
         vm_ptr->restore_snapshot(request->snapshot(), vm_specs);
+        instance_watchers.notify(instance_name, InstanceWatchers::Change::snapshots);
 
         auto mounts_it = mounts.find(instance_name);
         assert(mounts_it != mounts.end() && "uninitialized mounts");
 
-        if (update_mounts(vm_specs, mounts_it->second, vm_ptr) || vm_specs != old_specs)
+        const auto mounts_updated = update_mounts(vm_specs, mounts_it->second, vm_ptr);
+        if (mounts_updated)
+            instance_watchers.notify(instance_name, InstanceWatchers::Change::mounts);
+
+        if (mounts_updated || vm_specs != old_specs)
             persist_instances();
 
         server->Write(reply);
@@ -2923,45 +3056,102 @@ try
         if (auto dest_vm_status = validate_dest_name(destination_name); !dest_vm_status.ok())
             return status_promise->set_value(std::move(dest_vm_status));
 
-        auto rollback_resources = sg::make_scope_guard([this, destination_name]() noexcept -> void {
-            top_catch_all(category, [this, destination_name]() {
+        auto rollback = [this, destination_name]() noexcept -> void {
+            top_catch_all(category, [this, &destination_name]() {
                 release_resources(destination_name);
                 preparing_instances.erase(destination_name);
             });
-        });
+        };
+        auto rollback_resources = sg::make_scope_guard(rollback);
 
-        // signal that the new instance is being cooked up
+        // signal that the new instance is being cooked up, and keep the source as it is meanwhile
         preparing_instances.insert(destination_name);
-        auto& src_spec = vm_instance_specs[source_name];
-        auto dest_spec = clone_spec(src_spec, source_name, destination_name);
+        cloning_sources.insert(source_name);
+        auto release_source = sg::make_scope_guard([this, source_name]() noexcept {
+            cloning_sources.erase(cloning_sources.find(source_name));
+        });
 
+        auto dest_spec = clone_spec(vm_instance_specs[source_name], source_name, destination_name);
         config->vault->clone(source_name, destination_name);
 
-        const mp::VMImage dest_vm_image =
-            fetch_image_for(destination_name, *config->factory, *config->vault);
-
-        // Specs need to be in place before the factory can create the VM
-        // Notice that we are passing `this`, which can be used to retrieve further info
-        vm_instance_specs.emplace(destination_name, dest_spec);
-        operative_instances[destination_name] =
-            config->factory->clone_bare_vm(src_spec,
-                                           dest_spec,
-                                           source_name,
-                                           destination_name,
-                                           dest_vm_image,
-                                           *config->ssh_key_provider,
-                                           *this);
-        ++src_spec.clone_count;
-        // preparing instance is done
-        preparing_instances.erase(destination_name);
-        persist_instances();
-        init_mounts(destination_name);
+        // Copying the instance disks can take minutes, so it happens off the daemon thread
+        auto clone_future_watcher = new QFutureWatcher<grpc::Status>();
+        const auto log_level = mpl::level_from(request->verbosity_level());
+
+        QObject::connect(
+            clone_future_watcher,
+            &QFutureWatcher<grpc::Status>::finished,
+            [this,
+             server,
+             status_promise,
+             source_name,
+             destination_name,
+             dest_spec,
+             rollback,
+             clone_future_watcher,
+             log_level] {
+                mpl::ClientLogger<CloneReply, CloneRequest> logger{log_level,
+                                                                   *config->logger,
+                                                                   server};
+                cloning_sources.erase(cloning_sources.find(source_name));
+
+                auto status = clone_future_watcher->result();
+                if (status.ok())
+                {
+                    try
+                    {
+                        auto rollback_resources = sg::make_scope_guard(rollback);
+                        finish_clone(source_name, destination_name, dest_spec);
+
+                        CloneReply rpc_response;
+                        rpc_response.set_reply_message(
+                            fmt::format("Cloned from {} to {}.\n", source_name, destination_name));
+                        server->Write(rpc_response);
+                        rollback_resources.dismiss();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        status = grpc::Status(grpc::StatusCode::INTERNAL, e.what());
+                    }
+                }
+                else
+                {
+                    rollback();
+                }
+
+                status_promise->set_value(status);
+                delete clone_future_watcher;
+            });
 
-        CloneReply rpc_response;
-        rpc_response.set_reply_message(
-            fmt::format("Cloned from {} to {}.\n", source_name, destination_name));
-        server->Write(rpc_response);
+        clone_future_watcher->setFuture(MP_EXECUTOR.run(
+            Lane::blocking,
+            [this, server, source_name, destination_name, log_level] {
+                mpl::ClientLogger<CloneReply, CloneRequest> logger{log_level,
+                                                                   *config->logger,
+                                                                   server};
+                auto progress_monitor = [server](int /*progress_type*/, int percentage) {
+                    CloneReply reply;
+                    reply.set_percent_complete(std::to_string(percentage));
+                    return server->Write(reply);
+                };
+
+                try
+                {
+                    config->factory->clone_instance_files(source_name,
+                                                          destination_name,
+                                                          progress_monitor);
+                    return grpc::Status::OK;
+                }
+                catch (const std::exception& e)
+                {
+                    return grpc::Status(grpc::StatusCode::INTERNAL, e.what());
+                }
+            }));
+
+        // from here on, the watcher finishes the clone or rolls it back
         rollback_resources.dismiss();
+        release_source.dismiss();
+        return;
     }
     status_promise->set_value(src_vm_status);
 }
@@ -2970,6 +3160,33 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::INTERNAL, e.what()));
 }
 
+void mp::Daemon::finish_clone(const std::string& source_name,
+                              const std::string& destination_name,
+                              const VMSpecs& dest_spec)
+{
+    const mp::VMImage dest_vm_image =
+        fetch_image_for(destination_name, *config->factory, *config->vault);
+
+    // Specs need to be in place before the factory can create the VM
+    // Notice that we are passing `this`, which can be used to retrieve further info
+    auto& src_spec = vm_instance_specs[source_name];
+    vm_instance_specs.emplace(destination_name, dest_spec);
+    operative_instances[destination_name] =
+        config->factory->clone_bare_vm(src_spec,
+                                       dest_spec,
+                                       source_name,
+                                       destination_name,
+                                       dest_vm_image,
+                                       *config->ssh_key_provider,
+                                       *this);
+    ++src_spec.clone_count;
+    // preparing instance is done
+    preparing_instances.erase(destination_name);
+    persist_instances();
+    init_mounts(destination_name);
+    publish_instance(destination_name);
+}
+
 void mp::Daemon::daemon_info(
     const DaemonInfoRequest* request,
     grpc::ServerReaderWriterInterface<DaemonInfoReply, DaemonInfoRequest>* server,
@@ -3037,6 +3254,101 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::metrics(const MetricsRequest* request,
+                         grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>* server,
+                         std::promise<grpc::Status>* status_promise)
+try
+{
+    mpl::ClientLogger<MetricsReply, MetricsRequest> logger{
+        mpl::level_from(request->verbosity_level()),
+        *config->logger,
+        server};
+
+    auto metrics = MP_METRICS.to_prometheus();
+
+    auto state_label = [](InstanceStatus::Status status) {
+        const auto state = QString::fromStdString(InstanceStatus::Status_Name(status)).toLower();
+        return fmt::format("state=\"{}\"", state.toStdString());
+    };
+
+    std::map<std::string, std::size_t> instances_by_state;
+    for (const auto& [name, instance] : operative_instances)
+        ++instances_by_state[state_label(grpc_instance_status_for(instance->current_state()))];
+    instances_by_state[state_label(InstanceStatus::DELETED)] += deleted_instances.size();
+
+    const std::vector<std::pair<std::string, double>> instances{instances_by_state.begin(),
+                                                                instances_by_state.end()};
+    append_prometheus_gauge(metrics, "multipass_instances", "Instances, by state.", instances);
+
+    std::vector<std::pair<std::string, double>> threads, queued, running, total_wait, max_wait;
+    for (auto lane : {Lane::cpu, Lane::blocking})
+    {
+        using Seconds = std::chrono::duration<double>;
+        const auto labels = fmt::format("lane=\"{}\"", lane == Lane::cpu ? "cpu" : "blocking");
+        const auto stats = MP_EXECUTOR.stats(lane);
+        threads.emplace_back(labels, stats.max_threads);
+        queued.emplace_back(labels, stats.queued);
+        running.emplace_back(labels, stats.running);
+        total_wait.emplace_back(labels, Seconds{stats.total_queue_wait}.count());
+        max_wait.emplace_back(labels, Seconds{stats.max_queue_wait}.count());
+    }
+    append_prometheus_gauge(metrics,
+                            "multipass_executor_threads",
+                            "Threads available to background work, by lane.",
+                            threads);
+    append_prometheus_gauge(metrics,
+                            "multipass_executor_queued_tasks",
+                            "Background tasks waiting for a thread, by lane.",
+                            queued);
+    append_prometheus_gauge(metrics,
+                            "multipass_executor_running_tasks",
+                            "Background tasks running, by lane.",
+                            running);
+    append_prometheus_counter(metrics,
+                              "multipass_executor_queue_wait_seconds_total",
+                              "Time background tasks spent waiting for a thread, by lane.",
+                              total_wait);
+    append_prometheus_gauge(metrics,
+                            "multipass_executor_max_queue_wait_seconds",
+                            "Longest a background task waited for a thread, by lane.",
+                            max_wait);
+
+    MetricsReply reply;
+    reply.set_metrics(metrics);
+    server->Write(reply);
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::watch(const WatchRequest* request,
+                       grpc::ServerReaderWriterInterface<WatchReply, WatchRequest>* server,
+                       std::promise<grpc::Status>* status_promise)
+try
+{
+    WatchReply reply;
+    auto subscription = instance_watchers.subscribe(reply);
+
+    // Writing blocks while the client is behind, and the changes it misses meanwhile merge.
+    // Replies without changes are sent now and then, to find out about clients that went away.
+    while (server->Write(reply))
+    {
+        auto next = subscription->next(watch_keepalive_interval);
+        if (!next)
+            break;
+
+        reply = std::move(*next);
+    }
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
 void mp::Daemon::on_shutdown()
 {
 }
@@ -3068,20 +3380,22 @@ void mp::Daemon::on_restart(const std::string& name)
         }
     });
     future_watcher->setFuture(
-        QtConcurrent::run(&Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
-                          this,
-                          nullptr,
-                          std::vector<std::string>{name},
-                          mp::default_timeout,
-                          nullptr,
-                          std::string(),
-                          std::string()));
+        MP_EXECUTOR.run(Lane::blocking,
+                        &Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
+                        this,
+                        nullptr,
+                        std::vector<std::string>{name},
+                        mp::default_timeout,
+                        nullptr,
+                        std::string(),
+                        std::string()));
 }
 
 void mp::Daemon::persist_state_for(const std::string& name, const VirtualMachine::State& state)
 {
     vm_instance_specs[name].state = state;
     persist_instances();
+    instance_watchers.set_status(name, grpc_instance_status_for(state));
 }
 
 void mp::Daemon::update_metadata_for(const std::string& name, const QJsonObject& metadata)
@@ -3089,6 +3403,7 @@ void mp::Daemon::update_metadata_for(const std::string& name, const QJsonObject&
     vm_instance_specs[name].metadata = metadata;
 
     persist_instances();
+    instance_watchers.notify(name, InstanceWatchers::Change::metadata);
 }
 
 QJsonObject mp::Daemon::retrieve_metadata_for(const std::string& name)
@@ -3112,6 +3427,7 @@ void mp::Daemon::persist_instances()
 
 void mp::Daemon::release_resources(const std::string& instance)
 {
+    instance_watchers.remove(instance);
     config->vault->remove(instance);
     config->factory->remove_resources_for(instance);
 
@@ -3125,6 +3441,20 @@ void mp::Daemon::release_resources(const std::string& instance)
     }
 }
 
+// The state comes from the specs, which backends keep up to date through persist_state_for
+void mp::Daemon::publish_instance(const std::string& name)
+{
+    const auto& spec = vm_instance_specs[name];
+
+    ListVMInstance instance;
+    instance.set_name(name);
+    instance.mutable_instance_status()->set_status(
+        spec.deleted ? InstanceStatus::DELETED : grpc_instance_status_for(spec.state));
+    populate_release_and_os(instance, *config);
+
+    instance_watchers.put(instance);
+}
+
 void mp::Daemon::create_vm(const CreateRequest* request,
                            grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
                            std::promise<grpc::Status>* status_promise,
@@ -3179,6 +3509,8 @@ void mp::Daemon::create_vm(const CreateRequest* request,
     auto timeout = timeout_for(request->timeout());
 
     preparing_instances.insert(name);
+    MP_TRACER.begin(name, start ? "launch" : "create");
+    MP_METRICS.instance_operations.with(start ? "launch" : "create").add();
 
     auto prepare_future_watcher = new QFutureWatcher<mp::VirtualMachineDescription>();
     auto log_level = mpl::level_from(request->verbosity_level());
@@ -3205,13 +3537,17 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                                            {},
                                            false,
                                            QJsonObject()};
-                operative_instances[name] =
-                    config->factory->create_virtual_machine(vm_desc,
-                                                            *config->ssh_key_provider,
-                                                            *this);
+                {
+                    TraceSpan span{name, "create_virtual_machine"};
+                    operative_instances[name] =
+                        config->factory->create_virtual_machine(vm_desc,
+                                                                *config->ssh_key_provider,
+                                                                *this);
+                }
                 preparing_instances.erase(name);
 
                 persist_instances();
+                publish_instance(name);
 
                 if (start)
                 {
@@ -3219,17 +3555,25 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                     reply.set_create_message("Starting " + name);
                     server->Write(reply);
 
-                    operative_instances[name]->start();
+                    {
+                        TraceSpan span{name, "start"};
+                        operative_instances[name]->start();
+                    }
 
-                    auto future_watcher = create_future_watcher([this, server, name] {
+                    auto future_watcher = create_future_watcher([this, server, name, log_level] {
                         LaunchReply reply;
                         reply.set_vm_instance_name(name);
                         config->update_prompt->populate_if_time_to_show(
                             reply.mutable_update_info());
 
+                        const auto summary = finish_trace(name, config->data_directory);
+                        if (log_level > mpl::Level::error)
+                            reply.set_log_line(summary);
+
                         server->Write(reply);
                     });
-                    future_watcher->setFuture(QtConcurrent::run(
+                    future_watcher->setFuture(MP_EXECUTOR.run(
+                        Lane::blocking,
                         &Daemon::async_wait_for_ready_all<LaunchReply, LaunchRequest>,
                         this,
                         server,
@@ -3241,12 +3585,14 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                 }
                 else
                 {
+                    finish_trace(name, config->data_directory);
                     status_promise->set_value(grpc::Status::OK);
                 }
             }
             catch (const std::exception& e)
             {
                 mp::top_catch_all(category, [this, &name]() {
+                    finish_trace(name, config->data_directory);
                     preparing_instances.erase(name);
                     release_resources(name);
                     operative_instances.erase(name);
@@ -3263,6 +3609,7 @@ void mp::Daemon::create_vm(const CreateRequest* request,
     auto make_vm_description = [this, server, request, name, checked_args, log_level]() mutable
         -> mp::VirtualMachineDescription {
         mpl::ClientLogger<CreateReply, CreateRequest> logger{log_level, *config->logger, server};
+        TraceScope trace_scope{name};
 
         try
         {
@@ -3293,13 +3640,13 @@ void mp::Daemon::create_vm(const CreateRequest* request,
             query = query_from(request, name);
             vm_desc.mem_size = checked_args.mem_size;
 
-            auto progress_monitor = [server](int progress_type, int percentage) {
+            auto progress_monitor = [this, server](int progress_type, int percentage) {
                 CreateReply create_reply;
                 create_reply.mutable_launch_progress()->set_percent_complete(
                     std::to_string(percentage));
                 create_reply.mutable_launch_progress()->set_type(
                     (CreateProgress::ProgressTypes)progress_type);
-                return server->Write(create_reply);
+                return !shutting_down.is_cancelled() && server->Write(create_reply);
             };
 
             auto prepare_action = [this, server, &name](const VMImage& source_image) -> VMImage {
@@ -3307,6 +3654,7 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                 reply.set_create_message("Preparing image for " + name);
                 server->Write(reply);
 
+                TraceSpan span{"prepare_source_image"};
                 return config->factory->prepare_source_image(source_image);
             };
 
@@ -3316,19 +3664,25 @@ void mp::Daemon::create_vm(const CreateRequest* request,
             if (!vm_desc.image.id.empty())
                 checksum = vm_desc.image.id;
 
-            auto vm_image =
-                config->vault->fetch_image(fetch_type,
-                                           query,
-                                           prepare_action,
-                                           progress_monitor,
-                                           checksum,
-                                           config->factory->get_instance_directory(name));
+            auto vm_image = [&] {
+                TraceSpan span{"fetch_image"};
+                return config->vault->fetch_image(fetch_type,
+                                                  query,
+                                                  prepare_action,
+                                                  progress_monitor,
+                                                  checksum,
+                                                  config->factory->get_instance_directory(name));
+            }();
 
-            const auto image_size = config->vault->minimum_image_size_for(vm_image.id);
-            vm_desc.disk_space = compute_final_image_size(
-                image_size,
-                vm_desc.disk_space.in_bytes() > 0 ? vm_desc.disk_space : checked_args.disk_space,
-                config->data_directory);
+            {
+                TraceSpan span{"compute_final_image_size"};
+                const auto image_size = config->vault->minimum_image_size_for(vm_image.id);
+                vm_desc.disk_space = compute_final_image_size(
+                    image_size,
+                    vm_desc.disk_space.in_bytes() > 0 ? vm_desc.disk_space
+                                                      : checked_args.disk_space,
+                    config->data_directory);
+            }
 
             reply.set_create_message("Configuring " + name);
             server->Write(reply);
@@ -3366,8 +3720,14 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                                                     checked_args.extra_interfaces);
 
             vm_desc.image = vm_image;
-            config->factory->configure(vm_desc);
-            config->factory->prepare_instance_image(vm_image, vm_desc);
+            {
+                TraceSpan span{"cloud_init_iso"};
+                config->factory->configure(vm_desc);
+            }
+            {
+                TraceSpan span{"prepare_instance_image"};
+                config->factory->prepare_instance_image(vm_image, vm_desc);
+            }
 
             // Everything went well, add the MAC addresses used in this instance.
             allocated_mac_addrs = std::move(new_macs);
@@ -3380,7 +3740,8 @@ void mp::Daemon::create_vm(const CreateRequest* request,
         }
     };
 
-    prepare_future_watcher->setFuture(QtConcurrent::run(make_vm_description));
+    // The image fetch waits on its download without holding a thread of the cpu lane
+    prepare_future_watcher->setFuture(MP_EXECUTOR.run(Lane::cpu, make_vm_description));
 }
 
 bool mp::Daemon::delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteReply& response)
@@ -3404,6 +3765,7 @@ bool mp::Daemon::delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteRepl
         {
             vm_instance_specs[name].deleted = true;
             deleted_instances[name] = std::move(instance);
+            publish_instance(name);
 
             instances_dirty = true;
             mpl::debug(category, "Instance deleted: {}", name);
@@ -3471,7 +3833,10 @@ grpc::Status mp::Daemon::switch_off_vm(VirtualMachine& vm)
     const auto& name = vm.get_name();
     delayed_shutdown_instances.erase(name);
 
+    const auto start = std::chrono::steady_clock::now();
     vm.shutdown(VirtualMachine::ShutdownPolicy::Poweroff);
+    MP_METRICS.instance_operation_durations.with("stop").observe(std::chrono::steady_clock::now() -
+                                                                 start);
 
     return grpc::Status::OK;
 }
@@ -3587,7 +3952,9 @@ mp::MountHandler::UPtr mp::Daemon::make_mount(VirtualMachine* vm,
                ? std::make_unique<SSHFSMountHandler>(vm,
                                                      config->ssh_key_provider.get(),
                                                      target,
-                                                     mount)
+                                                     mount,
+                                                     sshfs_checks,
+                                                     sshfs_servers)
                : vm->make_native_mount_handler(target, mount);
 }
 
@@ -3627,7 +3994,20 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
             return fmt::to_string(errors);
         }
         const auto vm = it->second;
-        vm->wait_until_ssh_up(timeout);
+
+        // Each stage can take minutes, which shutting down does not wait out
+        auto check_not_shutting_down = [this, &name] {
+            if (shutting_down.is_cancelled())
+                throw std::runtime_error{
+                    fmt::format("Stopped waiting for '{}', the daemon is shutting down", name)};
+        };
+
+        check_not_shutting_down();
+        {
+            TraceSpan span{name, "wait_until_ssh_up"};
+            vm->wait_until_ssh_up(timeout);
+        }
+        check_not_shutting_down();
 
         if (std::is_same<Reply, LaunchReply>::value)
         {
@@ -3638,7 +4018,9 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
                 server->Write(reply);
             }
 
+            TraceSpan span{name, "wait_for_cloud_init"};
             vm->wait_for_cloud_init(timeout);
+            check_not_shutting_down();
         }
 
         if (MP_SETTINGS.get_as<bool>(mp::mounts_key))
@@ -3646,21 +4028,51 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
             std::vector<std::string> invalid_mounts;
             fmt::memory_buffer warnings;
             auto& vm_mounts = mounts[name];
+
+            // Each mount waits for its own connection, so they are activated all at once
+            std::vector<std::string> activating_targets;
+            QFutureSynchronizer<std::exception_ptr> activations;
             for (auto& [target, mount] : vm_mounts)
+            {
+                if (mount->is_mount_managed_by_backend())
+                    continue;
+
+                activating_targets.push_back(target);
+                activations.addFuture(MP_EXECUTOR.run(
+                    Lane::blocking,
+                    [handler = mount.get(), server]() -> std::exception_ptr {
+                        try
+                        {
+                            handler->activate(server);
+                            return nullptr;
+                        }
+                        catch (...)
+                        {
+                            return std::current_exception();
+                        }
+                    }));
+            }
+
+            {
+                TraceSpan span{name, "activate_mounts"};
+                MP_EXECUTOR.wait_for(Lane::blocking, activations);
+            }
+
+            auto sshfs_missing = false;
+            const auto results = activations.futures();
+            for (std::size_t i = 0; i < activating_targets.size(); ++i)
                 try
                 {
-                    if (!mount->is_mount_managed_by_backend())
-                    {
-                        mount->activate(server);
-                    }
+                    if (const auto error = results[i].result())
+                        std::rethrow_exception(error);
                 }
                 catch (const mp::SSHFSMissingError&)
                 {
-                    add_fmt_to(errors, sshfs_error_template, name);
-                    break;
+                    sshfs_missing = true;
                 }
                 catch (const std::exception& e)
                 {
+                    const auto& target = activating_targets[i];
                     auto msg = fmt::format("Removing mount \"{}\" from '{}': {}\n",
                                            target,
                                            name,
@@ -3670,6 +4082,9 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
                     invalid_mounts.push_back(target);
                 }
 
+            if (sshfs_missing)
+                add_fmt_to(errors, sshfs_error_template, name);
+
             auto& vm_spec_mounts = vm_instance_specs[name].mounts;
             for (const auto& target : invalid_mounts)
             {
@@ -3715,7 +4130,8 @@ mp::Daemon::async_wait_for_ready_all(grpc::ServerReaderWriterInterface<Reply, Re
             }
             else
             {
-                auto future = QtConcurrent::run(
+                auto future = MP_EXECUTOR.run(
+                    Lane::blocking,
                     &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply, Request>,
                     this,
                     name,
@@ -3727,7 +4143,7 @@ mp::Daemon::async_wait_for_ready_all(grpc::ServerReaderWriterInterface<Reply, Re
         }
     }
 
-    start_synchronizer.waitForFinished();
+    MP_EXECUTOR.wait_for(Lane::blocking, start_synchronizer);
 
     fmt::memory_buffer warnings;
 
@@ -3791,12 +4207,68 @@ void mp::Daemon::update_manifests_all(const bool force_update)
     };
 
     utils::parallel_for_each(config->image_hosts, launch_update_manifests_from_vm_image_host);
+    manifests_published = true;
+}
+
+void mp::Daemon::reclaim_idle_memory()
+{
+    if (memory_reclaim_future.isRunning())
+        return;
+
+    using DenseInstance = std::pair<VirtualMachine::ShPtr, MemorySize>;
+    std::vector<DenseInstance> dense_instances;
+    for (const auto& [name, vm] : operative_instances)
+        if (const auto& spec = vm_instance_specs[name];
+            spec.memory_density && vm->current_state() == VirtualMachine::State::running)
+            dense_instances.emplace_back(vm, spec.mem_size);
+
+    if (dense_instances.empty())
+        return;
+
+    // Only probing the instances happens on the pool; QEMU's monitor is driven from this thread
+    auto reclaim = [this, dense_instances = std::move(dense_instances)] {
+        utils::parallel_for_each(dense_instances, [this](const DenseInstance& dense_instance) {
+            const auto& [vm, mem_size] = dense_instance;
+            try
+            {
+                const auto target =
+                    memory_density_target(vm->ssh_exec(memory_density_probe, true), mem_size);
+                QMetaObject::invokeMethod(
+                    this,
+                    [vm, target] {
+                        try
+                        {
+                            vm->set_balloon_target(target);
+                        }
+                        catch (const std::exception& e)
+                        {
+                            mpl::debug(category,
+                                       "Could not reclaim memory from {}: {}",
+                                       vm->get_name(),
+                                       e.what());
+                        }
+                    },
+                    Qt::QueuedConnection);
+            }
+            catch (const std::exception& e)
+            {
+                mpl::debug(category,
+                           "Could not reclaim memory from {}: {}",
+                           vm->get_name(),
+                           e.what());
+            }
+        });
+    };
+    memory_reclaim_future = MP_EXECUTOR.run(Lane::blocking, std::move(reclaim));
 }
 
 void mp::Daemon::wait_update_manifests_all_and_optionally_applied_force(
     const bool force_manifest_network_download)
 {
-    update_manifests_all_task.wait_ongoing_task_finish();
+    // Image hosts swap in refreshed manifests whole, so once there are any, lookups need not wait
+    // for a periodic refresh that is under way. Forced refreshes still queue behind it.
+    if (!manifests_published || force_manifest_network_download)
+        update_manifests_all_task.wait_ongoing_task_finish();
     if (force_manifest_network_download)
     {
         update_manifests_all_task.stop_timer();
@@ -3879,19 +4351,30 @@ void mp::Daemon::populate_instance_info(VirtualMachine& vm,
     timestamp->set_nanos(created_time.time().msec() * 1'000'000);
 
     if (!no_runtime_info && MP_UTILS.is_running(present_state))
+    {
         RuntimeInstanceInfoHelper::populate_runtime_info(vm,
                                                          info,
                                                          instance_info,
                                                          original_release,
                                                          vm_specs.num_cores != 1);
+
+        if (const auto host_memory = vm.host_memory_usage())
+            instance_info->set_host_memory_usage(std::to_string(host_memory->in_bytes()));
+    }
 }
 
 std::string mp::Daemon::dest_name_for_clone(const CloneRequest& request)
 {
-    return request.has_destination_name()
-               ? request.destination_name()
-               : generate_next_clone_name(vm_instance_specs.at(request.source_name()).clone_count,
-                                          request.source_name());
+    if (request.has_destination_name())
+        return request.destination_name();
+
+    // The count only goes up once a clone is done, so skip the names of those still being copied
+    auto clone_count = vm_instance_specs.at(request.source_name()).clone_count;
+    auto name = generate_next_clone_name(clone_count, request.source_name());
+    while (preparing_instances.count(name))
+        name = generate_next_clone_name(++clone_count, request.source_name());
+
+    return name;
 };
 
 grpc::Status mp::Daemon::validate_dest_name(const std::string& name)
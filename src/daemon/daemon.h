@@ -19,15 +19,19 @@
 
 #include "daemon_config.h"
 #include "daemon_rpc.h"
+#include "instance_watchers.h"
 
 #include <multipass/async_periodic_download_task.h>
 #include <multipass/delayed_shutdown_timer.h>
+#include <multipass/executor.h>
 #include <multipass/format.h>
 #include <multipass/mount_handler.h>
+#include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/virtual_machine.h>
 #include <multipass/vm_specs.h>
 #include <multipass/vm_status_monitor.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <memory>
@@ -172,8 +176,19 @@ public slots:
         grpc::ServerReaderWriterInterface<WaitReadyReply, WaitReadyRequest>* server,
         std::promise<grpc::Status>* status_promise);
 
+    virtual void metrics(const MetricsRequest* request,
+                         grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>* server,
+                         std::promise<grpc::Status>* status_promise);
+
+    // Streams for as long as the client watches, on the thread that serves it rather than the
+    // daemon's, so it must only touch the thread-safe instance watchers
+    virtual void watch(const WatchRequest* request,
+                       grpc::ServerReaderWriterInterface<WatchReply, WatchRequest>* server,
+                       std::promise<grpc::Status>* status_promise);
+
 private:
     void release_resources(const std::string& instance);
+    void publish_instance(const std::string& name);
     void create_vm(const CreateRequest* request,
                    grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
                    std::promise<grpc::Status>* status_promise,
@@ -227,6 +242,7 @@ private:
     QFutureWatcher<AsyncOperationStatus>* create_future_watcher(
         std::function<void()> const& finished_op = []() {});
     void update_manifests_all(const bool force_update = false);
+    void reclaim_idle_memory();
     void wait_update_manifests_all_and_optionally_applied_force(
         const bool force_manifest_network_download);
 
@@ -246,6 +262,9 @@ private:
     VMSpecs clone_spec(const VMSpecs& src_vm_spec,
                        const std::string& src_name,
                        const std::string& dest_name);
+    void finish_clone(const std::string& source_name,
+                      const std::string& destination_name,
+                      const VMSpecs& dest_spec);
 
     std::unique_ptr<const DaemonConfig> config;
 
@@ -261,8 +280,11 @@ private:
     std::unordered_map<std::string, std::unique_ptr<DelayedShutdownTimer>>
         delayed_shutdown_instances;
     std::unordered_set<std::string> allocated_mac_addrs;
+    InstanceWatchers instance_watchers;
     DaemonRpc daemon_rpc;
     QTimer source_images_maintenance_task;
+    // Set once every image host has published manifests; declared before the task that sets it
+    std::atomic_bool manifests_published{false};
     multipass::utils::AsyncPeriodicDownloadTask<void> update_manifests_all_task{
         "fetch manifest periodically",
         std::chrono::minutes(15),
@@ -275,9 +297,16 @@ private:
     std::unordered_map<std::string, QFuture<std::string>> async_running_futures;
     std::mutex start_mutex;
     std::unordered_set<std::string> preparing_instances;
+    std::unordered_multiset<std::string> cloning_sources; // kept as they are until copied
     QFuture<void> image_update_future;
+    CancellationToken shutting_down; // for downloads and readiness waits not to be waited out
+    QTimer memory_reclaim_task;
+    QFuture<void> memory_reclaim_future;
     SettingsHandler* instance_mod_handler;
     SettingsHandler* snapshot_mod_handler;
+    // Shared by the SSHFS mounts below, so they must outlive them
+    SSHFSChecks sshfs_checks;
+    SSHFSServers sshfs_servers;
     std::unordered_map<std::string, std::unordered_map<std::string, MountHandler::UPtr>> mounts;
     std::unordered_set<std::string> user_authorized_bridges;
 };
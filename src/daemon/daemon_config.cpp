@@ -162,7 +162,8 @@ std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
                  UbuntuVMImageRemote{"https://cdimage.ubuntu.com/",
                                      "ubuntu-core/",
                                      mp::image_mutators::core_mutator}}},
-            url_downloader.get()));
+            url_downloader.get(),
+            MP_UTILS.make_dir(cache_directory, "manifests")));
     }
     if (vault == nullptr)
     {
@@ -113,6 +113,7 @@ void mp::daemon::register_global_settings_handlers()
     settings.insert(std::make_unique<BasicSettingSpec>(bridged_interface_key, ""));
     settings.insert(
         std::make_unique<BoolSettingSpec>(mounts_key, MP_PLATFORM.default_privileged_mounts()));
+    settings.insert(std::make_unique<BoolSettingSpec>(mount_caching_key, "false"));
     settings.insert(std::make_unique<CustomSettingSpec>(driver_key,
                                                         MP_PLATFORM.default_driver(),
                                                         driver_interpreter));
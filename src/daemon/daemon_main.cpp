@@ -23,6 +23,7 @@
 
 #include <multipass/auto_join_thread.h>
 #include <multipass/constants.h>
+#include <multipass/executor.h>
 #include <multipass/logging/log.h>
 #include <multipass/platform_unix.h>
 #include <multipass/signal.h>
@@ -112,8 +113,10 @@ int main_impl(int argc, char* argv[], mp::Signal& app_ready_signal)
 
     auto exit_code = QCoreApplication::exec();
     // QConcurrent::run() invocations are dispatched through the global
-    // thread pool. Wait until all threads in the pool are properly cleaned up.
+    // thread pool or the executor's. Wait until all threads in them are properly cleaned up.
     QThreadPool::globalInstance()->waitForDone();
+    if (!MP_EXECUTOR.wait_for_done(std::chrono::seconds{30}))
+        mpl::warn("daemon", "Exiting with background tasks still running");
     mpl::info("daemon", "Goodbye!");
     return exit_code;
 }
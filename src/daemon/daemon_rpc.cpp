@@ -19,9 +19,12 @@
 
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/utils.h>
 
+#include <scope_guard.hpp>
+
 #include <chrono>
 #include <stdexcept>
 
@@ -31,6 +34,7 @@ namespace mpl = multipass::logging;
 namespace
 {
 constexpr auto category = "rpc";
+constexpr auto max_watchers = 32; // each one holds on to a server thread for as long as it watches
 
 bool check_is_server_running(const std::string& address)
 {
@@ -157,6 +161,7 @@ grpc::Status mp::DaemonRpc::create(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "create",
         std::bind(&DaemonRpc::on_create, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -168,6 +173,7 @@ grpc::Status mp::DaemonRpc::launch(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "launch",
         std::bind(&DaemonRpc::on_launch, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -179,6 +185,7 @@ grpc::Status mp::DaemonRpc::purge(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "purge",
         std::bind(&DaemonRpc::on_purge, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -190,6 +197,7 @@ grpc::Status mp::DaemonRpc::find(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "find",
         std::bind(&DaemonRpc::on_find, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -201,6 +209,7 @@ grpc::Status mp::DaemonRpc::info(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "info",
         std::bind(&DaemonRpc::on_info, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -212,6 +221,7 @@ grpc::Status mp::DaemonRpc::list(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "list",
         std::bind(&DaemonRpc::on_list, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -226,7 +236,9 @@ grpc::Status mp::DaemonRpc::clone(grpc::ServerContext* context,
         this->on_clone(&request, server, std::forward<decltype(arg)>(arg));
     };
 
-    return verify_client_and_dispatch_operation(adapted_on_clone, client_cert_from(context));
+    return verify_client_and_dispatch_operation("clone",
+                                                adapted_on_clone,
+                                                client_cert_from(context));
 }
 
 grpc::Status mp::DaemonRpc::networks(
@@ -237,6 +249,7 @@ grpc::Status mp::DaemonRpc::networks(
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "networks",
         std::bind(&DaemonRpc::on_networks, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -248,6 +261,7 @@ grpc::Status mp::DaemonRpc::mount(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "mount",
         std::bind(&DaemonRpc::on_mount, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -259,6 +273,7 @@ grpc::Status mp::DaemonRpc::recover(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "recover",
         std::bind(&DaemonRpc::on_recover, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -270,6 +285,7 @@ grpc::Status mp::DaemonRpc::ssh_info(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "ssh_info",
         std::bind(&DaemonRpc::on_ssh_info, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -281,6 +297,7 @@ grpc::Status mp::DaemonRpc::start(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "start",
         std::bind(&DaemonRpc::on_start, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -292,6 +309,7 @@ grpc::Status mp::DaemonRpc::stop(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "stop",
         std::bind(&DaemonRpc::on_stop, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -303,6 +321,7 @@ grpc::Status mp::DaemonRpc::suspend(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "suspend",
         std::bind(&DaemonRpc::on_suspend, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -314,6 +333,7 @@ grpc::Status mp::DaemonRpc::restart(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "restart",
         std::bind(&DaemonRpc::on_restart, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -325,6 +345,7 @@ grpc::Status mp::DaemonRpc::delet(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "delete",
         std::bind(&DaemonRpc::on_delete, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -336,6 +357,7 @@ grpc::Status mp::DaemonRpc::umount(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "umount",
         std::bind(&DaemonRpc::on_umount, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -347,6 +369,7 @@ grpc::Status mp::DaemonRpc::version(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "version",
         std::bind(&DaemonRpc::on_version, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -372,6 +395,7 @@ grpc::Status mp::DaemonRpc::get(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "get",
         std::bind(&DaemonRpc::on_get, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -408,6 +432,7 @@ grpc::Status mp::DaemonRpc::set(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "set",
         std::bind(&DaemonRpc::on_set, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -419,6 +444,7 @@ grpc::Status mp::DaemonRpc::keys(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "keys",
         std::bind(&DaemonRpc::on_keys, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -431,6 +457,7 @@ grpc::Status mp::DaemonRpc::snapshot(
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "snapshot",
         std::bind(&DaemonRpc::on_snapshot, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -442,6 +469,7 @@ grpc::Status mp::DaemonRpc::restore(grpc::ServerContext* context,
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "restore",
         std::bind(&DaemonRpc::on_restore, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -454,6 +482,7 @@ grpc::Status mp::DaemonRpc::daemon_info(
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "daemon_info",
         std::bind(&DaemonRpc::on_daemon_info, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
@@ -466,13 +495,49 @@ grpc::Status mp::DaemonRpc::wait_ready(
     server->Read(&request);
 
     return verify_client_and_dispatch_operation(
+        "wait_ready",
         std::bind(&DaemonRpc::on_wait_ready, this, &request, server, std::placeholders::_1),
         client_cert_from(context));
 }
 
+grpc::Status mp::DaemonRpc::metrics(grpc::ServerContext* context,
+                                    grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server)
+{
+    MetricsRequest request;
+    server->Read(&request);
+
+    return verify_client_and_dispatch_operation(
+        "metrics",
+        std::bind(&DaemonRpc::on_metrics, this, &request, server, std::placeholders::_1),
+        client_cert_from(context));
+}
+
+grpc::Status mp::DaemonRpc::watch(grpc::ServerContext* context,
+                                  grpc::ServerReaderWriter<WatchReply, WatchRequest>* server)
+{
+    if (++watchers > max_watchers)
+    {
+        --watchers;
+        return grpc::Status{grpc::StatusCode::RESOURCE_EXHAUSTED,
+                            "Too many clients are watching the instances, try again later"};
+    }
+    const auto release_watcher = sg::make_scope_guard([this]() noexcept { --watchers; });
+
+    WatchRequest request;
+    server->Read(&request);
+
+    // Watching lasts as long as the client wants, which says nothing about how the daemon fares
+    return verify_client_and_dispatch_operation(
+        std::nullopt,
+        std::bind(&DaemonRpc::on_watch, this, &request, server, std::placeholders::_1),
+        client_cert_from(context));
+}
+
 template <typename OperationSignal>
-grpc::Status mp::DaemonRpc::verify_client_and_dispatch_operation(OperationSignal signal,
-                                                                 const std::string& client_cert)
+grpc::Status mp::DaemonRpc::verify_client_and_dispatch_operation(
+    std::optional<std::string_view> rpc,
+    OperationSignal signal,
+    const std::string& client_cert)
 {
     if (server_socket_type == mp::ServerSocketType::unix && client_cert_store->empty())
     {
@@ -495,5 +560,12 @@ grpc::Status mp::DaemonRpc::verify_client_and_dispatch_operation(OperationSignal
             "(e.g. via 'multipass set local.passphrase')."};
     }
 
-    return emit_signal_and_wait_for_result(signal);
+    if (!rpc)
+        return emit_signal_and_wait_for_result(signal);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto status = emit_signal_and_wait_for_result(signal);
+    MP_METRICS.rpc_durations.with(*rpc).observe(std::chrono::steady_clock::now() - start);
+
+    return status;
 }
@@ -26,8 +26,11 @@
 
 #include <QObject>
 
+#include <atomic>
 #include <future>
 #include <memory>
+#include <optional>
+#include <string_view>
 
 namespace multipass
 {
@@ -135,16 +138,25 @@ signals:
     void on_wait_ready(const WaitReadyRequest* request,
                        grpc::ServerReaderWriter<WaitReadyReply, WaitReadyRequest>* server,
                        std::promise<grpc::Status>* status_promise);
+    void on_metrics(const MetricsRequest* request,
+                    grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server,
+                    std::promise<grpc::Status>* status_promise);
+    void on_watch(const WatchRequest* request,
+                  grpc::ServerReaderWriter<WatchReply, WatchRequest>* server,
+                  std::promise<grpc::Status>* status_promise);
 
 private:
+    // Times the operation under the given name, if any
     template <typename OperationSignal>
-    grpc::Status verify_client_and_dispatch_operation(OperationSignal signal,
+    grpc::Status verify_client_and_dispatch_operation(std::optional<std::string_view> rpc,
+                                                      OperationSignal signal,
                                                       const std::string& client_cert);
 
     const std::string server_address;
     const std::unique_ptr<grpc::Server> server;
     const ServerSocketType server_socket_type;
     CertStore* client_cert_store;
+    std::atomic_int watchers{0};
 
 protected:
     grpc::Status create(grpc::ServerContext* context,
@@ -207,5 +219,9 @@ protected:
     grpc::Status wait_ready(
         grpc::ServerContext* context,
         grpc::ServerReaderWriter<WaitReadyReply, WaitReadyRequest>* server) override;
+    grpc::Status metrics(grpc::ServerContext* context,
+                         grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server) override;
+    grpc::Status watch(grpc::ServerContext* context,
+                       grpc::ServerReaderWriter<WatchReply, WatchRequest>* server) override;
 };
 } // namespace multipass
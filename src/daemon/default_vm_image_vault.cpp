@@ -21,13 +21,16 @@
 #include <multipass/exceptions/create_image_exception.h>
 #include <multipass/exceptions/image_vault_exceptions.h>
 #include <multipass/exceptions/unsupported_image_exception.h>
+#include <multipass/executor.h>
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
 #include <multipass/json_utils.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/process/qemuimg_process_spec.h>
 #include <multipass/query.h>
+#include <multipass/tracing.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
 #include <multipass/url_downloader.h>
 #include <multipass/utils.h>
@@ -37,9 +40,9 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QUrl>
-#include <QtConcurrent/QtConcurrent>
 
 #include <exception>
+#include <type_traits>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -236,6 +239,27 @@ void persist_records(const T& records, const QString& path)
     }
     MP_FILEOPS.write_transactionally(path, QJsonDocument{json_records}.toJson());
 }
+
+// Waits for the future on behalf of whichever lane the caller runs on, so that the wait does not
+// hold up work queued behind it there
+template <typename T>
+T result_of(const QFuture<T>& future)
+{
+    if (const auto lane = MP_EXECUTOR.current_lane())
+        MP_EXECUTOR.wait_for(*lane, future);
+
+    if constexpr (std::is_void_v<T>)
+        future.waitForFinished();
+    else
+        return future.result();
+}
+
+// Hashing and decompressing images keep a core busy for a while, so they go on the cpu lane
+template <typename Function>
+auto compute(Function&& function)
+{
+    return result_of(MP_EXECUTOR.run(mp::Lane::cpu, std::forward<Function>(function)));
+}
 } // namespace
 
 mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hosts,
@@ -300,7 +324,8 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
 
         if (source_image.image_path.endsWith(".xz"))
         {
-            source_image.image_path = extract_image_from(source_image, monitor, save_dir);
+            source_image.image_path =
+                compute([&] { return extract_image_from(source_image, monitor, save_dir); });
         }
         else
         {
@@ -308,7 +333,9 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
         }
 
         vm_image = prepare(source_image);
-        vm_image.id = MP_IMAGE_VAULT_UTILS.compute_file_hash(vm_image.image_path).toStdString();
+        vm_image.id = compute([&] {
+            return MP_IMAGE_VAULT_UTILS.compute_file_hash(vm_image.image_path).toStdString();
+        });
 
         remove_source_images(source_image, vm_image);
 
@@ -349,6 +376,7 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
                 if (last_modified.isValid() &&
                     (last_modified.toString().toStdString() == record.image.release_date))
                 {
+                    MP_METRICS.image_vault_hits.add();
                     return finalize_image_records(query, record.image, id, save_dir);
                 }
             }
@@ -382,19 +410,21 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
                     QLocale::c().toString(last_modified, "yyyyMMdd"));
                 const auto image_dir = MP_UTILS.make_dir(images_dir, image_dir_name);
 
-                // Had to use std::bind here to workaround the 5 allowable function arguments
-                // constraint of QtConcurrent::run()
-                future = QtConcurrent::run(
-                    std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
-                              this,
-                              info,
-                              source_image,
-                              image_dir,
-                              fetch_type,
-                              prepare,
-                              monitor));
+                // std::bind passes its copies as lvalues, which the source image parameter needs
+                future = MP_EXECUTOR.run(
+                    Lane::blocking,
+                    in_trace_scope(
+                        std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
+                                  this,
+                                  info,
+                                  source_image,
+                                  image_dir,
+                                  fetch_type,
+                                  prepare,
+                                  monitor)));
 
                 in_progress_image_fetches[id] = future;
+                MP_METRICS.image_vault_misses.add();
             }
         }
         else
@@ -421,10 +451,12 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
                         const auto prepared_image = record.second.image;
                         try
                         {
-                            return finalize_image_records(query,
-                                                          prepared_image,
-                                                          record.first,
-                                                          save_dir);
+                            auto vm_image = finalize_image_records(query,
+                                                                   prepared_image,
+                                                                   record.first,
+                                                                   save_dir);
+                            MP_METRICS.image_vault_hits.add();
+                            return vm_image;
                         }
                         catch (const std::exception& e)
                         {
@@ -448,25 +480,27 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
                     MP_UTILS.make_dir(images_dir,
                                       QString("%1-%2").arg(info->release).arg(info->version));
 
-                // Had to use std::bind here to workaround the 5 allowable function arguments
-                // constraint of QtConcurrent::run()
-                future = QtConcurrent::run(
-                    std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
-                              this,
-                              *info,
-                              source_image,
-                              image_dir,
-                              fetch_type,
-                              prepare,
-                              monitor));
+                // std::bind passes its copies as lvalues, which the source image parameter needs
+                future = MP_EXECUTOR.run(
+                    Lane::blocking,
+                    in_trace_scope(
+                        std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
+                                  this,
+                                  *info,
+                                  source_image,
+                                  image_dir,
+                                  fetch_type,
+                                  prepare,
+                                  monitor)));
 
                 in_progress_image_fetches[id] = future;
+                MP_METRICS.image_vault_misses.add();
             }
         }
 
         try
         {
-            auto prepared_image = future.result();
+            auto prepared_image = result_of(future);
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
             in_progress_image_fetches.erase(id);
             return finalize_image_records(query, prepared_image, id, save_dir);
@@ -689,23 +723,29 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
 
     try
     {
-        url_downloader->download_to(info.image_location,
-                                    source_image.image_path,
-                                    info.size,
-                                    LaunchProgress::IMAGE,
-                                    monitor);
+        {
+            TraceSpan span{"download"};
+            url_downloader->download_to(info.image_location,
+                                        source_image.image_path,
+                                        info.size,
+                                        LaunchProgress::IMAGE,
+                                        monitor);
+        }
 
         if (info.verify)
         {
             mpl::debug(category, "Verifying hash \"{}\"", id);
             monitor(LaunchProgress::VERIFY, -1);
-            MP_IMAGE_VAULT_UTILS.verify_file_hash(source_image.image_path, id);
+            TraceSpan span{"verify"};
+            compute([&] { MP_IMAGE_VAULT_UTILS.verify_file_hash(source_image.image_path, id); });
         }
 
         if (source_image.image_path.endsWith(".xz"))
         {
-            source_image.image_path =
-                MP_IMAGE_VAULT_UTILS.extract_file(source_image.image_path, monitor, true);
+            TraceSpan span{"extract"};
+            source_image.image_path = compute([&] {
+                return MP_IMAGE_VAULT_UTILS.extract_file(source_image.image_path, monitor, true);
+            });
         }
 
         auto prepared_image = prepare(source_image);
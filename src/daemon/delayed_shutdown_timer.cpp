@@ -19,6 +19,7 @@
 #include <multipass/exceptions/ssh_exception.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/top_catch_all.h>
 
 namespace mp = multipass;
@@ -141,7 +142,11 @@ std::chrono::seconds mp::DelayedShutdownTimer::get_time_remaining()
 
 void mp::DelayedShutdownTimer::shutdown_instance()
 {
+    const auto start = std::chrono::steady_clock::now();
     stop_mounts(virtual_machine->get_name());
     virtual_machine->shutdown();
+    MP_METRICS.instance_operation_durations.with("stop").observe(std::chrono::steady_clock::now() -
+                                                                 start);
+
     emit finished();
 }
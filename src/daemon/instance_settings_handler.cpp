@@ -33,6 +33,8 @@ constexpr auto cpus_suffix = "cpus";
 constexpr auto mem_suffix = "memory";
 constexpr auto disk_suffix = "disk";
 constexpr auto bridged_suffix = "bridged";
+constexpr auto disk_profile_suffix = "disk-profile";
+constexpr auto memory_density_suffix = "memory-density";
 
 enum class Operation
 {
@@ -51,7 +53,13 @@ QRegularExpression make_key_regex()
     const auto instance_pattern = QStringLiteral("(?<instance>.+)");
     const auto prop_template = QStringLiteral("(?<property>%1)");
     const auto either_prop =
-        QStringList{cpus_suffix, mem_suffix, disk_suffix, bridged_suffix}.join("|");
+        QStringList{cpus_suffix,
+                    memory_density_suffix,
+                    mem_suffix,
+                    disk_profile_suffix,
+                    disk_suffix,
+                    bridged_suffix}
+            .join("|");
     const auto prop_pattern = prop_template.arg(either_prop);
 
     const auto key_template = QStringLiteral(R"(%1\.%2\.%3)");
@@ -100,13 +108,37 @@ pick_instance(InstanceMap& instances,
     }
 }
 
-void check_state_for_update(mp::VirtualMachine& instance)
+// Returns the limits to respect when the property is to be updated on the running instance
+std::optional<mp::VirtualMachine::LiveResizeLimits> check_state_for_update(
+    mp::VirtualMachine& instance,
+    const std::string& property)
 {
     auto st = instance.current_state();
-    if (st != mp::VirtualMachine::State::stopped && st != mp::VirtualMachine::State::off)
-        throw mp::InstanceStateSettingsException{operation_msg(Operation::Modify),
-                                                 instance.get_name(),
-                                                 "Instance must be stopped for modification"};
+    if (st == mp::VirtualMachine::State::stopped || st == mp::VirtualMachine::State::off)
+        return std::nullopt;
+
+    if (st == mp::VirtualMachine::State::running &&
+        (property == cpus_suffix || property == mem_suffix || property == disk_suffix))
+        if (auto limits = instance.live_resize_limits())
+            return limits;
+
+    throw mp::InstanceStateSettingsException{operation_msg(Operation::Modify),
+                                             instance.get_name(),
+                                             "Instance must be stopped for modification"};
+}
+
+template <typename T>
+void check_live_limits(const mp::VirtualMachine& instance,
+                       const T& value,
+                       const T& min,
+                       const T& max,
+                       const std::string& range)
+{
+    if (value < min || max < value)
+        throw mp::InstanceStateSettingsException{
+            operation_msg(Operation::Modify),
+            instance.get_name(),
+            fmt::format("Instance must be stopped for values outside {}", range)};
 }
 
 mp::MemorySize get_memory_size(const QString& key, const QString& val)
@@ -128,7 +160,8 @@ mp::MemorySize get_memory_size(const QString& key, const QString& val)
 void update_cpus(const QString& key,
                  const QString& val,
                  mp::VirtualMachine& instance,
-                 mp::VMSpecs& spec)
+                 mp::VMSpecs& spec,
+                 const std::optional<mp::VirtualMachine::LiveResizeLimits>& live_limits)
 {
     bool converted_ok = false;
     if (auto cpus = val.toInt(&converted_ok); !converted_ok || cpus < std::stoi(mp::min_cpu_cores))
@@ -139,6 +172,15 @@ void update_cpus(const QString& key,
                 .arg(mp::min_cpu_cores)};
     else if (cpus != spec.num_cores) // NOOP if equal
     {
+        if (live_limits)
+            check_live_limits(instance,
+                              cpus,
+                              live_limits->min_cores,
+                              live_limits->max_cores,
+                              fmt::format("{}-{} CPUs",
+                                          live_limits->min_cores,
+                                          live_limits->max_cores));
+
         instance.update_cpus(cpus);
         spec.num_cores = cpus;
     }
@@ -148,7 +190,8 @@ void update_mem(const QString& key,
                 const QString& val,
                 mp::VirtualMachine& instance,
                 mp::VMSpecs& spec,
-                const mp::MemorySize& size)
+                const mp::MemorySize& size,
+                const std::optional<mp::VirtualMachine::LiveResizeLimits>& live_limits)
 {
     if (size < mp::MemorySize{mp::min_memory_size})
         throw mp::InvalidSettingException{
@@ -157,6 +200,15 @@ void update_mem(const QString& key,
             QString("Memory less than %1 minimum not allowed").arg(mp::min_memory_size)};
     else if (size != spec.mem_size) // NOOP if equal
     {
+        if (live_limits)
+            check_live_limits(instance,
+                              size,
+                              live_limits->min_memory,
+                              live_limits->max_memory,
+                              fmt::format("{}-{} of memory",
+                                          live_limits->min_memory.human_readable(),
+                                          live_limits->max_memory.human_readable()));
+
         instance.resize_memory(size);
         spec.mem_size = size;
     }
@@ -177,6 +229,36 @@ void update_disk(const QString& key,
     }
 }
 
+void update_disk_profile(const QString& key,
+                         const QString& val,
+                         mp::VirtualMachine& instance,
+                         mp::VMSpecs& spec)
+{
+    auto profile = mp::disk_profile_from(val);
+    if (!profile)
+        throw mp::InvalidSettingException{key,
+                                          val,
+                                          "Disk profile must be one of: default, throughput"};
+    else if (*profile != spec.disk_profile) // NOOP if equal
+    {
+        instance.set_disk_profile(*profile);
+        spec.disk_profile = *profile;
+    }
+}
+
+void update_memory_density(const QString& key,
+                           const QString& val,
+                           mp::VirtualMachine& instance,
+                           mp::VMSpecs& spec)
+{
+    auto want_density = mp::BoolSettingSpec{key, "false"}.interpret(val) == "true";
+    if (want_density != spec.memory_density) // NOOP if equal
+    {
+        instance.set_memory_density(want_density);
+        spec.memory_density = want_density;
+    }
+}
+
 void update_bridged(const QString& key,
                     const QString& val,
                     const std::string& instance_name,
@@ -209,6 +291,7 @@ mp::InstanceSettingsHandler::InstanceSettingsHandler(
     std::unordered_map<std::string, VirtualMachine::ShPtr>& operative_instances,
     const std::unordered_map<std::string, VirtualMachine::ShPtr>& deleted_instances,
     const std::unordered_set<std::string>& preparing_instances,
+    const std::unordered_multiset<std::string>& cloning_sources,
     std::function<void()> instance_persister,
     std::function<bool(const std::string&)> is_bridged,
     std::function<void(const std::string&)> add_interface)
@@ -216,6 +299,7 @@ mp::InstanceSettingsHandler::InstanceSettingsHandler(
       operative_instances{operative_instances},
       deleted_instances{deleted_instances},
       preparing_instances{preparing_instances},
+      cloning_sources{cloning_sources},
       instance_persister{std::move(instance_persister)},
       is_bridged{is_bridged},
       add_interface{add_interface}
@@ -228,7 +312,13 @@ std::set<QString> mp::InstanceSettingsHandler::keys() const
 
     std::set<QString> ret;
     for (const auto& item : vm_instance_specs)
-        for (const auto& suffix : {cpus_suffix, mem_suffix, disk_suffix, bridged_suffix})
+        for (const auto& suffix :
+             {cpus_suffix,
+              mem_suffix,
+              disk_suffix,
+              disk_profile_suffix,
+              memory_density_suffix,
+              bridged_suffix})
             ret.insert(key_template.arg(item.first.c_str()).arg(suffix));
 
     return ret;
@@ -245,6 +335,10 @@ QString mp::InstanceSettingsHandler::get(const QString& key) const
     }
     if (property == cpus_suffix)
         return QString::number(spec.num_cores);
+    if (property == disk_profile_suffix)
+        return mp::disk_profile_name(spec.disk_profile);
+    if (property == memory_density_suffix)
+        return spec.memory_density ? "true" : "false";
     if (property == mem_suffix)
         return QString::fromStdString(
             spec.mem_size.human_readable()); /* TODO return in bytes when --raw
@@ -263,22 +357,31 @@ void mp::InstanceSettingsHandler::set(const QString& key, const QString& val)
                                         instance_name,
                                         "instance is being prepared"};
 
+    if (cloning_sources.count(instance_name))
+        throw InstanceSettingsException{operation_msg(Operation::Modify),
+                                        instance_name,
+                                        "instance is being cloned"};
+
     auto& instance =
         modify_instance(instance_name); // we need this first, to refuse updating deleted instances
     auto& spec = modify_spec(instance_name);
-    check_state_for_update(instance);
+    const auto live_limits = check_state_for_update(instance, property);
 
     if (property == cpus_suffix)
-        update_cpus(key, val, instance, spec);
+        update_cpus(key, val, instance, spec, live_limits);
     else if (property == bridged_suffix)
     {
         update_bridged(key, val, instance_name, is_bridged, add_interface);
     }
+    else if (property == disk_profile_suffix)
+        update_disk_profile(key, val, instance, spec);
+    else if (property == memory_density_suffix)
+        update_memory_density(key, val, instance, spec);
     else
     {
         auto size = get_memory_size(key, val);
         if (property == mem_suffix)
-            update_mem(key, val, instance, spec, size);
+            update_mem(key, val, instance, spec, size, live_limits);
         else
         {
             assert(property == disk_suffix);
@@ -41,6 +41,7 @@ public:
         std::unordered_map<std::string, VirtualMachine::ShPtr>& operative_instances,
         const std::unordered_map<std::string, VirtualMachine::ShPtr>& deleted_instances,
         const std::unordered_set<std::string>& preparing_instances,
+        const std::unordered_multiset<std::string>& cloning_sources,
         std::function<void()> instance_persister,
         std::function<bool(const std::string&)> is_bridged,
         std::function<void(const std::string&)> add_interface);
@@ -60,6 +61,7 @@ private:
     std::unordered_map<std::string, VirtualMachine::ShPtr>& operative_instances;
     const std::unordered_map<std::string, VirtualMachine::ShPtr>& deleted_instances;
     const std::unordered_set<std::string>& preparing_instances;
+    const std::unordered_multiset<std::string>& cloning_sources;
     std::function<void()> instance_persister;
     std::function<bool(const std::string&)> is_bridged;
     std::function<void(const std::string&)> add_interface;
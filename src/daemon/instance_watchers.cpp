@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "instance_watchers.h"
+
+namespace mp = multipass;
+
+struct mp::InstanceWatchers::Shared
+{
+    // Expects the mutex to be held
+    void mark(const std::string& name, Change change)
+    {
+        for (auto* subscription : subscriptions)
+        {
+            auto& pending = subscription->pending[name];
+            switch (change)
+            {
+            case Change::state:
+                pending.set_state_changed(true);
+                break;
+            case Change::metadata:
+                pending.set_metadata_changed(true);
+                break;
+            case Change::mounts:
+                pending.set_mounts_changed(true);
+                break;
+            case Change::snapshots:
+                pending.set_snapshots_changed(true);
+                break;
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<std::string, ListVMInstance> instances;
+    std::set<Subscription*> subscriptions;
+    bool closed = false;
+};
+
+mp::InstanceWatchers::Subscription::Subscription(std::shared_ptr<Shared> shared)
+    : shared{std::move(shared)}
+{
+}
+
+mp::InstanceWatchers::Subscription::~Subscription()
+{
+    std::lock_guard lock{shared->mutex};
+    shared->subscriptions.erase(this);
+}
+
+std::optional<mp::WatchReply> mp::InstanceWatchers::Subscription::next(
+    std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock{shared->mutex};
+    shared->changed.wait_for(lock, timeout, [this] { return shared->closed || !pending.empty(); });
+
+    if (shared->closed)
+        return std::nullopt;
+
+    // Changes carry the instance as it is when they are taken, not as it was when they were made
+    WatchReply reply;
+    for (auto& [name, change] : pending)
+    {
+        if (auto it = shared->instances.find(name); it != shared->instances.end())
+            *change.mutable_instance() = it->second;
+        else
+        {
+            change.mutable_instance()->set_name(name);
+            change.set_removed(true);
+        }
+
+        *reply.add_changes() = std::move(change);
+    }
+    pending.clear();
+
+    return reply;
+}
+
+mp::InstanceWatchers::InstanceWatchers() : shared{std::make_shared<Shared>()}
+{
+}
+
+mp::InstanceWatchers::~InstanceWatchers()
+{
+    close();
+}
+
+void mp::InstanceWatchers::put(const ListVMInstance& instance)
+{
+    {
+        std::lock_guard lock{shared->mutex};
+        shared->instances[instance.name()] = instance;
+        shared->mark(instance.name(), Change::state);
+    }
+
+    shared->changed.notify_all();
+}
+
+void mp::InstanceWatchers::set_status(const std::string& name, InstanceStatus::Status status)
+{
+    {
+        std::lock_guard lock{shared->mutex};
+        auto it = shared->instances.find(name);
+        if (it == shared->instances.end())
+            return;
+
+        auto* instance_status = it->second.mutable_instance_status();
+        if (instance_status->status() == status ||
+            instance_status->status() == InstanceStatus::DELETED)
+            return;
+
+        instance_status->set_status(status);
+        shared->mark(name, Change::state);
+    }
+
+    shared->changed.notify_all();
+}
+
+void mp::InstanceWatchers::notify(const std::string& name, Change change)
+{
+    {
+        std::lock_guard lock{shared->mutex};
+        if (!shared->instances.count(name))
+            return;
+
+        shared->mark(name, change);
+    }
+
+    shared->changed.notify_all();
+}
+
+void mp::InstanceWatchers::remove(const std::string& name)
+{
+    {
+        std::lock_guard lock{shared->mutex};
+        if (!shared->instances.erase(name))
+            return;
+
+        shared->mark(name, Change::state);
+    }
+
+    shared->changed.notify_all();
+}
+
+auto mp::InstanceWatchers::subscribe(WatchReply& first_reply) -> std::unique_ptr<Subscription>
+{
+    auto subscription = std::make_unique<Subscription>(shared);
+
+    std::lock_guard lock{shared->mutex};
+    auto* snapshot = first_reply.mutable_snapshot();
+    for (const auto& [_, instance] : shared->instances)
+        *snapshot->add_instances() = instance;
+
+    shared->subscriptions.insert(subscription.get());
+
+    return subscription;
+}
+
+void mp::InstanceWatchers::close()
+{
+    {
+        std::lock_guard lock{shared->mutex};
+        shared->closed = true;
+    }
+
+    shared->changed.notify_all();
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/disabled_copy_move.h>
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace multipass
+{
+// What clients watching the instances get told, kept apart from the daemon's own bookkeeping so
+// that backends can update it from their threads and watchers can read it from theirs. A watcher
+// first gets the instances as they are, then what changes. Changes to an instance that a watcher
+// has not taken yet merge into one, so a slow watcher holds at most one pending change per
+// instance and never holds up the others, or whoever reports the change.
+class InstanceWatchers : private DisabledCopyMove
+{
+    struct Shared;
+
+public:
+    enum class Change
+    {
+        state,
+        metadata,
+        mounts,
+        snapshots
+    };
+
+    class Subscription : private DisabledCopyMove
+    {
+    public:
+        explicit Subscription(std::shared_ptr<Shared> shared);
+        ~Subscription();
+
+        // Waits for changes. A reply without any means none came in time; nullopt, that the
+        // watchers were closed.
+        std::optional<WatchReply> next(std::chrono::milliseconds timeout);
+
+    private:
+        friend struct Shared;
+
+        std::shared_ptr<Shared> shared;
+        std::map<std::string, InstanceChange> pending; // guarded by the shared mutex
+    };
+
+    InstanceWatchers();
+    ~InstanceWatchers();
+
+    // Records the instance as it now is, e.g. once created, deleted or recovered
+    void put(const ListVMInstance& instance);
+    // Ignored for unknown instances and deleted ones, whose backends may still report their states
+    void set_status(const std::string& name, InstanceStatus::Status status);
+    void notify(const std::string& name, Change change);
+    void remove(const std::string& name);
+
+    // The first reply holds the instances as they are, and the subscription gets what changes after
+    std::unique_ptr<Subscription> subscribe(WatchReply& first_reply);
+
+    // Ends all subscriptions, present and future
+    void close();
+
+private:
+    std::shared_ptr<Shared> shared;
+};
+} // namespace multipass
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "memory_density_policy.h"
+
+#include <multipass/format.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto idle_load = 0.1;
+constexpr auto min_target_bytes = 512LL << 20;
+
+// Active pages are those the guest touched recently; unlike MemTotal-MemAvailable, they do not
+// count pages already handed back to the balloon
+long long active_bytes(std::istringstream& meminfo)
+{
+    std::string key;
+    long long kilobytes;
+    std::string unit;
+    while (meminfo >> key >> kilobytes)
+    {
+        if (key == "Active:")
+            return kilobytes * 1024;
+
+        std::getline(meminfo, unit);
+    }
+
+    throw std::runtime_error{"Could not find active memory in guest meminfo"};
+}
+} // namespace
+
+mp::MemorySize mp::memory_density_target(const std::string& probe_output,
+                                         const MemorySize& mem_size)
+{
+    std::istringstream stream{probe_output};
+
+    double load1;
+    if (!(stream >> load1))
+        throw std::runtime_error{fmt::format("Could not parse guest load from: {}", probe_output)};
+
+    std::string rest_of_loadavg;
+    std::getline(stream, rest_of_loadavg);
+
+    const auto active = active_bytes(stream);
+    if (load1 >= idle_load)
+        return mem_size;
+
+    const auto target = std::max(active / 2 * 3, min_target_bytes);
+    return MemorySize::from_bytes(std::min(target, mem_size.in_bytes()));
+}
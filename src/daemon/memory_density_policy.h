@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/memory_size.h>
+
+#include <string>
+
+namespace multipass
+{
+// The command whose output memory_density_target() expects, run inside the guest
+inline constexpr auto memory_density_probe = "cat /proc/loadavg /proc/meminfo";
+
+// Picks the balloon target for an instance in memory density mode from what the guest reports:
+// an idle guest is shrunk towards its working set plus headroom, a busy one gets all of its memory
+// back. Throws std::runtime_error if the probe output cannot be parsed.
+MemorySize memory_density_target(const std::string& probe_output, const MemorySize& mem_size);
+} // namespace multipass
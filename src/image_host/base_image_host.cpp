@@ -44,7 +44,6 @@ auto mp::BaseVMImageHost::info_for_full_hash(const std::string& full_hash) -> VM
 
 void mp::BaseVMImageHost::update_manifests(const bool force_update)
 {
-    clear();
     fetch_manifests(force_update);
 }
 
@@ -130,7 +130,7 @@ mp::CustomManifest::CustomManifest(std::vector<VMImageInfo>&& images)
 mp::CustomVMImageHost::CustomVMImageHost(URLDownloader* downloader)
     : BaseVMImageHost{downloader},
       arch{QSysInfo::currentCpuArchitecture()},
-      manifest{},
+      manifest{std::make_shared<const CustomManifest>(std::vector<VMImageInfo>{})},
       remote{no_remote}
 {
 }
@@ -174,15 +174,17 @@ std::vector<std::string> mp::CustomVMImageHost::supported_remotes()
 
 void mp::CustomVMImageHost::for_each_entry_do_impl(const Action& action)
 {
-    for (const auto& info : manifest.second->products)
+    const auto custom_manifest = manifest_from(remote);
+    for (const auto& info : custom_manifest->products)
     {
-        action(manifest.first, info);
+        action(remote, info);
     }
 }
 
 mp::VMImageInfo mp::CustomVMImageHost::info_for_full_hash_impl(const std::string& full_hash)
 {
-    for (const auto& product : manifest.second->products)
+    const auto custom_manifest = manifest_from(remote);
+    for (const auto& product : custom_manifest->products)
     {
         if (multipass::utils::iequals(product.id.toStdString(), full_hash))
         {
@@ -197,9 +199,11 @@ void mp::CustomVMImageHost::fetch_manifests(const bool force_update)
 {
     try
     {
-        auto custom_manifest = std::make_unique<mp::CustomManifest>(
+        auto custom_manifest = std::make_shared<const mp::CustomManifest>(
             fetch_image_info(arch, url_downloader, force_update));
-        manifest = std::make_pair(no_remote, std::move(custom_manifest));
+
+        std::lock_guard lock{manifest_mutex};
+        manifest = std::move(custom_manifest);
     }
     catch (mp::DownloadException& e)
     {
@@ -207,16 +211,13 @@ void mp::CustomVMImageHost::fetch_manifests(const bool force_update)
     }
 }
 
-void mp::CustomVMImageHost::clear()
-{
-    manifest = std::pair<std::string, std::unique_ptr<CustomManifest>>{};
-}
-
-mp::CustomManifest* mp::CustomVMImageHost::manifest_from(const std::string& remote_name)
+auto mp::CustomVMImageHost::manifest_from(const std::string& remote_name) const
+    -> std::shared_ptr<const CustomManifest>
 {
-    if (remote_name != manifest.first)
+    if (remote_name != remote)
         throw std::runtime_error(
             fmt::format("Remote \"{}\" is unknown or unreachable.", remote_name));
 
-    return manifest.second.get();
+    std::lock_guard lock{manifest_mutex};
+    return manifest;
 }
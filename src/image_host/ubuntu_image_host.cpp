@@ -20,25 +20,33 @@
 #include <multipass/exceptions/image_not_found_exception.h>
 #include <multipass/exceptions/manifest_exceptions.h>
 #include <multipass/exceptions/unsupported_image_exception.h>
+#include <multipass/executor.h>
 #include <multipass/image_host/ubuntu_image_host.h>
+#include <multipass/logging/log.h>
 #include <multipass/platform.h>
 #include <multipass/query.h>
 #include <multipass/settings/settings.h>
 #include <multipass/simple_streams_index.h>
 #include <multipass/url_downloader.h>
 #include <multipass/utils.h>
+#include <multipass/version.h>
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
 #include <QUrl>
 
 #include <algorithm>
-#include <unordered_set>
 
 namespace mp = multipass;
+namespace mpl = multipass::logging;
 
 namespace
 {
+constexpr auto category = "ubuntu image host";
 constexpr auto index_path = "streams/v1/index.json";
 
 auto download_manifest(const QString& host_url,
@@ -52,6 +60,22 @@ auto download_manifest(const QString& host_url,
     return json_manifest;
 }
 
+// Identifies everything a parsed manifest derives from. The version stands in for the mutators and
+// the parsing code, which may change between releases.
+QByteArray manifest_fingerprint(const QByteArray& json_from_official,
+                                const std::optional<QByteArray>& json_from_mirror,
+                                const QString& host_url)
+{
+    QCryptographicHash hash{QCryptographicHash::Sha256};
+    hash.addData(QByteArrayView{mp::version_string});
+    hash.addData(host_url.toUtf8());
+    hash.addData(json_from_official);
+    if (json_from_mirror)
+        hash.addData(json_from_mirror.value());
+
+    return hash.result();
+}
+
 auto key_from(const std::string& search_string)
 {
     auto key = QString::fromStdString(search_string);
@@ -63,8 +87,11 @@ auto key_from(const std::string& search_string)
 
 mp::UbuntuVMImageHost::UbuntuVMImageHost(
     std::vector<std::pair<std::string, UbuntuVMImageRemote>> remotes,
-    URLDownloader* downloader)
-    : BaseVMImageHost{downloader}, remotes{std::move(remotes)}
+    URLDownloader* downloader,
+    const QString& manifest_cache_dir)
+    : BaseVMImageHost{downloader},
+      remotes{std::move(remotes)},
+      manifest_cache_dir{manifest_cache_dir}
 {
 }
 
@@ -103,10 +130,11 @@ std::vector<std::pair<std::string, mp::VMImageInfo>> mp::UbuntuVMImageHost::all_
     }
 
     std::vector<std::pair<std::string, mp::VMImageInfo>> images;
+    const auto manifests = current_manifests();
 
     for (const auto& remote_name : remotes_to_search)
     {
-        auto* manifest = manifest_from(remote_name);
+        const auto* manifest = manifest_from(*manifests, remote_name);
 
         if (const auto* info = match_alias(key, *manifest); info)
         {
@@ -117,15 +145,18 @@ std::vector<std::pair<std::string, mp::VMImageInfo>> mp::UbuntuVMImageHost::all_
         }
         else
         {
-            std::unordered_set<std::string> found_hashes;
+            const auto& by_id = manifest->products_by_id;
+            const QString* last_found = nullptr;
 
-            for (const auto& entry : manifest->products)
+            for (auto it = by_id.lower_bound(key); it != by_id.end() && it->first.startsWith(key);
+                 ++it)
             {
-                if (entry.id.startsWith(key) && (entry.supported || query.allow_unsupported) &&
-                    found_hashes.find(entry.id.toStdString()) == found_hashes.end())
+                const auto& entry = *it->second;
+                if ((entry.supported || query.allow_unsupported) &&
+                    (!last_found || *last_found != it->first))
                 {
                     images.emplace_back(remote_name, entry);
-                    found_hashes.insert(entry.id.toStdString());
+                    last_found = &it->first;
                 }
             }
         }
@@ -136,14 +167,15 @@ std::vector<std::pair<std::string, mp::VMImageInfo>> mp::UbuntuVMImageHost::all_
 
 mp::VMImageInfo mp::UbuntuVMImageHost::info_for_full_hash_impl(const std::string& full_hash)
 {
-    for (const auto& manifest : manifests)
+    const auto key = QString::fromStdString(full_hash).toLower();
+
+    const auto manifests = current_manifests();
+    for (const auto& manifest : *manifests)
     {
-        for (const auto& product : manifest.second->products)
+        if (auto it = manifest.second->products_by_id.find(key);
+            it != manifest.second->products_by_id.end())
         {
-            if (multipass::utils::iequals(product.id.toStdString(), full_hash))
-            {
-                return product;
-            }
+            return *it->second;
         }
     }
 
@@ -154,7 +186,8 @@ std::vector<mp::VMImageInfo> mp::UbuntuVMImageHost::all_images_for(const std::st
                                                                    const bool allow_unsupported)
 {
     std::vector<mp::VMImageInfo> images;
-    auto manifest = manifest_from(remote_name);
+    const auto manifests = current_manifests();
+    const auto* manifest = manifest_from(*manifests, remote_name);
 
     for (const auto& entry : manifest->products)
     {
@@ -173,7 +206,8 @@ std::vector<mp::VMImageInfo> mp::UbuntuVMImageHost::all_images_for(const std::st
 
 void mp::UbuntuVMImageHost::for_each_entry_do_impl(const Action& action)
 {
-    for (const auto& [remote_name, manifest] : manifests)
+    const auto manifests = current_manifests();
+    for (const auto& [remote_name, manifest] : *manifests)
     {
         for (const auto& product : manifest->products)
         {
@@ -182,6 +216,18 @@ void mp::UbuntuVMImageHost::for_each_entry_do_impl(const Action& action)
     }
 }
 
+void mp::UbuntuVMImageHost::for_each_aliased_entry_do(const Action& action)
+{
+    const auto manifests = current_manifests();
+    for (const auto& [remote_name, manifest] : *manifests)
+    {
+        for (const auto* product : manifest->aliased_products)
+        {
+            action(remote_name, *product);
+        }
+    }
+}
+
 std::vector<std::string> mp::UbuntuVMImageHost::supported_remotes()
 {
     std::vector<std::string> supported_remotes;
@@ -215,14 +261,22 @@ void mp::UbuntuVMImageHost::fetch_manifests(const bool force_update)
                 manifest_bytes_from_mirror = std::make_optional(bytes);
             }
 
+            const auto host_url = mirror_site.value_or(official_site);
+            const auto fingerprint = manifest_fingerprint(manifest_bytes_from_official,
+                                                          manifest_bytes_from_mirror,
+                                                          host_url);
+            if (auto manifest = load_cached_manifest(remote_name, fingerprint))
+                return std::make_pair(remote_name, std::move(manifest));
+
             auto manifest = mp::SimpleStreamsManifest::fromJson(
                 manifest_bytes_from_official,
                 manifest_bytes_from_mirror,
-                mirror_site.value_or(official_site),
+                host_url,
                 // TODO: Remove `= remote_info` part once snap clang is updated to >15
                 [&remote_info = remote_info](VMImageInfo& info) {
                     return remote_info.apply_image_mutator(info);
                 });
+            save_cached_manifest(remote_name, fingerprint, *manifest);
 
             return std::make_pair(remote_name, std::move(manifest));
         }
@@ -242,19 +296,30 @@ void mp::UbuntuVMImageHost::fetch_manifests(const bool force_update)
         return {};
     };
 
-    auto local_manifests = mp::utils::parallel_transform(remotes, fetch_one_remote);
-    // append local_manifests to manifests
-    manifests.insert(manifests.end(),
-                     std::make_move_iterator(local_manifests.begin()),
-                     std::make_move_iterator(local_manifests.end()));
+    // Build the new set off to the side; if any remote throws, the current set stays published
+    auto fetched_manifests = mp::utils::parallel_transform(remotes, fetch_one_remote);
+
+    auto new_manifests = std::make_shared<Manifests>();
+    for (auto& fetched : fetched_manifests)
+    {
+        // Remotes that failed to update are left out, as if they were unreachable
+        if (fetched.second)
+            new_manifests->push_back(std::move(fetched));
+    }
+
+    std::lock_guard lock{manifests_mutex};
+    manifests = std::move(new_manifests);
 }
 
-void mp::UbuntuVMImageHost::clear()
+auto mp::UbuntuVMImageHost::current_manifests() const -> std::shared_ptr<const Manifests>
 {
-    manifests.clear();
+    std::lock_guard lock{manifests_mutex};
+    return manifests;
 }
 
-mp::SimpleStreamsManifest* mp::UbuntuVMImageHost::manifest_from(const std::string& remote)
+const mp::SimpleStreamsManifest* mp::UbuntuVMImageHost::manifest_from(
+    const Manifests& manifests,
+    const std::string& remote) const
 {
     const auto it = std::find_if(
         manifests.cbegin(),
@@ -283,6 +348,48 @@ const mp::VMImageInfo* mp::UbuntuVMImageHost::match_alias(
     return nullptr;
 }
 
+std::unique_ptr<mp::SimpleStreamsManifest> mp::UbuntuVMImageHost::load_cached_manifest(
+    const std::string& remote_name,
+    const QByteArray& fingerprint) const
+{
+    if (manifest_cache_dir.isEmpty())
+        return nullptr;
+
+    QFile file{QDir{manifest_cache_dir}.filePath(QString::fromStdString(remote_name))};
+    if (!file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    const auto data = file.readAll();
+    if (!data.startsWith(fingerprint))
+        return nullptr;
+
+    try
+    {
+        return SimpleStreamsManifest::fromBinary(data.sliced(fingerprint.size()));
+    }
+    catch (const GenericManifestException& e)
+    {
+        mpl::debug(category, "Ignoring cached manifest for \"{}\": {}", remote_name, e.what());
+        return nullptr;
+    }
+}
+
+void mp::UbuntuVMImageHost::save_cached_manifest(const std::string& remote_name,
+                                                 const QByteArray& fingerprint,
+                                                 const SimpleStreamsManifest& manifest) const
+{
+    if (manifest_cache_dir.isEmpty())
+        return;
+
+    QSaveFile file{QDir{manifest_cache_dir}.filePath(QString::fromStdString(remote_name))};
+    if (!file.open(QIODevice::WriteOnly) || file.write(fingerprint + manifest.toBinary()) == -1 ||
+        !file.commit())
+        mpl::warn(category,
+                  "Could not cache manifest for \"{}\": {}",
+                  remote_name,
+                  file.errorString());
+}
+
 mp::UbuntuVMImageRemote::UbuntuVMImageRemote(std::string official_host,
                                              std::string uri,
                                              std::optional<QString> mirror_key)
@@ -22,6 +22,7 @@
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
@@ -29,6 +30,7 @@
 #include <QDir>
 #include <QEventLoop>
 #include <QFile>
+#include <QLocale>
 #include <QNetworkDiskCache>
 #include <QNetworkReply>
 #include <QTimer>
@@ -43,6 +45,7 @@ namespace
 {
 constexpr auto category = "url downloader";
 using NetworkReplyUPtr = std::unique_ptr<QNetworkReply>;
+using RawHeaders = QList<QNetworkReply::RawHeaderPair>;
 
 auto make_network_manager(const mp::Path& cache_dir_path)
 {
@@ -70,6 +73,51 @@ auto make_network_manager(const mp::Path& cache_dir_path)
     return out;
 }
 
+// Validators of a previously cached reply, so that refreshing an unchanged resource costs a 304
+// rather than a full transfer
+RawHeaders revalidation_headers(QNetworkAccessManager* manager, const QUrl& url)
+{
+    RawHeaders headers;
+
+    auto cache = manager->cache();
+    if (!cache)
+        return headers;
+
+    const auto meta_data = cache->metaData(url);
+    if (!meta_data.isValid())
+        return headers;
+
+    for (const auto& [name, value] : meta_data.rawHeaders())
+    {
+        if (name.compare("ETag", Qt::CaseInsensitive) == 0)
+            headers.append({"If-None-Match", value});
+    }
+
+    if (const auto last_modified = meta_data.lastModified(); last_modified.isValid())
+        headers.append(
+            {"If-Modified-Since",
+             QLocale::c()
+                 .toString(last_modified.toUTC(), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'"))
+                 .toLatin1()});
+
+    // Having our own Cache-Control stops Qt from replacing it with no-cache for AlwaysNetwork
+    if (!headers.isEmpty())
+        headers.append({"Cache-Control", "max-age=0"});
+
+    return headers;
+}
+
+QByteArray cached_data(QNetworkAccessManager* manager, const QUrl& url)
+{
+    if (auto cache = manager->cache())
+    {
+        if (std::unique_ptr<QIODevice> data{cache->data(url)}; data)
+            return data->readAll();
+    }
+
+    return {};
+}
+
 void wait_for_reply(QNetworkReply* reply, QTimer& download_timeout)
 {
     QEventLoop event_loop;
@@ -93,7 +141,8 @@ QByteArray download(QNetworkAccessManager* manager,
                     ErrorAction&& on_error,
                     const std::atomic_bool& abort_download,
                     const QNetworkRequest::CacheLoadControl cache_load_control =
-                        QNetworkRequest::CacheLoadControl::PreferNetwork)
+                        QNetworkRequest::CacheLoadControl::PreferNetwork,
+                    const RawHeaders& extra_headers = {})
 {
     QTimer download_timeout;
     download_timeout.setInterval(timeout);
@@ -109,6 +158,8 @@ QByteArray download(QNetworkAccessManager* manager,
                                                          multipass::version_string,
                                                          mp::platform::host_version(),
                                                          QSysInfo::currentCpuArchitecture())));
+    for (const auto& [name, value] : extra_headers)
+        request.setRawHeader(name, value);
 
     NetworkReplyUPtr reply{manager->get(request)};
 
@@ -170,7 +221,23 @@ QByteArray download(QNetworkAccessManager* manager,
                url.toString(),
                reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool());
 
-    return reply->readAll();
+    // Qt normally answers a 304 with the cached contents itself, but it is not guaranteed to when
+    // it did not add the validators on its own
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+    {
+        mpl::trace(category, "{} not modified", url.toString());
+
+        if (auto data = reply->readAll(); !data.isEmpty())
+            return data;
+
+        return cached_data(manager, adjusted_url);
+    }
+
+    auto data = reply->readAll();
+    if (!reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool())
+        MP_METRICS.downloaded_bytes.add(data.size());
+
+    return data;
 }
 
 template <typename Time>
@@ -291,7 +358,9 @@ void mp::URLDownloader::download_to(const QUrl& url,
         else
             return;
 
-        if (MP_FILEOPS.write(file, reply->readAll()) < 0)
+        const auto data = reply->readAll();
+        MP_METRICS.downloaded_bytes.add(data.size());
+        if (MP_FILEOPS.write(file, data) < 0)
         {
             mpl::error(category, "error writing image: {}", file.errorString());
             abort_download = true;
@@ -332,9 +401,14 @@ QByteArray mp::URLDownloader::download(const QUrl& url, const bool force_update)
         download_timeout.start();
     };
 
+    // Forcing an update skips Qt's freshness check but still revalidates whatever is cached, so
+    // that unchanged resources are not transferred again
     const QNetworkRequest::CacheLoadControl cache_load_control =
         force_update ? QNetworkRequest::CacheLoadControl::AlwaysNetwork
                      : QNetworkRequest::CacheLoadControl::PreferNetwork;
+    const auto extra_headers = force_update
+                                   ? revalidation_headers(manager.get(), make_http_url_https(url))
+                                   : RawHeaders{};
 
     return ::download(
         manager.get(),
@@ -344,7 +418,8 @@ QByteArray mp::URLDownloader::download(const QUrl& url, const bool force_update)
         on_download,
         [] {},
         abort_downloads,
-        cache_load_control);
+        cache_load_control,
+        extra_headers);
 }
 
 QDateTime mp::URLDownloader::last_modified(const QUrl& url)
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "null_virtual_machine.h"
+#include "null_snapshot.h"
+
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
+#include <multipass/exceptions/virtual_machine_state_exceptions.h>
+#include <multipass/logging/log.h>
+#include <multipass/utils.h>
+#include <multipass/vm_status_monitor.h>
+
+#include <array>
+#include <functional>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+// Stable per name, so that an instance keeps its address across daemon restarts. Taken from
+// TEST-NET-1 (RFC 5737), which no host can own, so nothing ever answers on it.
+mp::IPAddress fake_ip_for(const std::string& name)
+{
+    const auto hash = std::hash<std::string>{}(name);
+    return mp::IPAddress{std::array<uint8_t, 4>{192, 0, 2, static_cast<uint8_t>(hash % 254 + 1)}};
+}
+} // namespace
+
+mp::NullVirtualMachine::NullVirtualMachine(const VirtualMachineDescription& desc,
+                                           VMStatusMonitor& monitor,
+                                           const SSHKeyProvider& key_provider,
+                                           const Path& instance_dir,
+                                           const NullLatencies& latencies)
+    : BaseVirtualMachine{desc.vm_name, key_provider, instance_dir},
+      desc{desc},
+      monitor{&monitor},
+      latencies{latencies},
+      ip{fake_ip_for(desc.vm_name)}
+{
+}
+
+void mp::NullVirtualMachine::start()
+{
+    {
+        std::lock_guard lock{state_mutex};
+        state = State::starting;
+        handle_state_update();
+    }
+
+    MP_UTILS.sleep_for(latencies.start);
+}
+
+void mp::NullVirtualMachine::shutdown(ShutdownPolicy shutdown_policy)
+{
+    std::unique_lock lock{state_mutex};
+
+    try
+    {
+        check_state_for_shutdown(shutdown_policy);
+    }
+    catch (const VMStateIdempotentException& e)
+    {
+        mpl::log_message(mpl::Level::info, vm_name, e.what());
+        return;
+    }
+
+    if (shutdown_policy != ShutdownPolicy::Poweroff)
+        MP_UTILS.sleep_for(latencies.stop);
+
+    state = State::stopped;
+    handle_state_update();
+    monitor->on_shutdown();
+}
+
+void mp::NullVirtualMachine::suspend()
+{
+    std::lock_guard lock{state_mutex};
+    if (state == State::running || state == State::delayed_shutdown)
+    {
+        MP_UTILS.sleep_for(latencies.stop);
+        state = State::suspended;
+        handle_state_update();
+    }
+    else if (state == State::stopped)
+    {
+        mpl::info(vm_name, "Ignoring suspend issued while stopped");
+    }
+
+    monitor->on_suspend();
+}
+
+mp::VirtualMachine::State mp::NullVirtualMachine::current_state()
+{
+    return state;
+}
+
+// There is no guest to connect to, so whatever would use SSH (mounts, shells) is refused outright
+int mp::NullVirtualMachine::ssh_port()
+{
+    throw NotImplementedOnThisBackendException{"SSH"};
+}
+
+std::string mp::NullVirtualMachine::ssh_hostname(std::chrono::milliseconds /*timeout*/)
+{
+    throw NotImplementedOnThisBackendException{"SSH"};
+}
+
+std::string mp::NullVirtualMachine::ssh_username()
+{
+    return desc.ssh_username;
+}
+
+std::optional<mp::IPAddress> mp::NullVirtualMachine::management_ipv4()
+{
+    return ip;
+}
+
+std::vector<mp::IPAddress> mp::NullVirtualMachine::get_all_ipv4()
+{
+    return {ip};
+}
+
+std::string mp::NullVirtualMachine::ssh_exec(const std::string& cmd, bool whisper)
+{
+    if (!whisper)
+        mpl::trace(vm_name, "Pretending to run: {}", cmd);
+
+    MP_UTILS.sleep_for(latencies.ssh);
+    return {};
+}
+
+void mp::NullVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds /*timeout*/)
+{
+    MP_UTILS.sleep_for(latencies.ssh);
+
+    std::lock_guard lock{state_mutex};
+    if (state == State::starting || state == State::restarting)
+    {
+        state = State::running;
+        handle_state_update();
+        monitor->on_resume();
+    }
+}
+
+void mp::NullVirtualMachine::wait_for_cloud_init(std::chrono::milliseconds /*timeout*/)
+{
+}
+
+void mp::NullVirtualMachine::handle_state_update()
+{
+    monitor->persist_state_for(vm_name, state);
+}
+
+void mp::NullVirtualMachine::update_cpus(int num_cores)
+{
+    desc.num_cores = num_cores;
+}
+
+void mp::NullVirtualMachine::resize_memory(const MemorySize& new_size)
+{
+    desc.mem_size = new_size;
+}
+
+void mp::NullVirtualMachine::resize_disk(const MemorySize& new_size)
+{
+    desc.disk_space = new_size;
+}
+
+auto mp::NullVirtualMachine::make_specific_snapshot(const QString& filename)
+    -> std::shared_ptr<Snapshot>
+{
+    return std::make_shared<NullSnapshot>(filename, *this, desc);
+}
+
+auto mp::NullVirtualMachine::make_specific_snapshot(const std::string& snapshot_name,
+                                                    const std::string& comment,
+                                                    const std::string& instance_id,
+                                                    const VMSpecs& specs,
+                                                    std::shared_ptr<Snapshot> parent)
+    -> std::shared_ptr<Snapshot>
+{
+    return std::make_shared<NullSnapshot>(snapshot_name,
+                                          comment,
+                                          instance_id,
+                                          std::move(parent),
+                                          specs,
+                                          *this);
+}
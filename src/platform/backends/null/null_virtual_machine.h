@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <shared/base_virtual_machine.h>
+
+#include <multipass/virtual_machine_description.h>
+
+#include <chrono>
+
+namespace multipass
+{
+class VMStatusMonitor;
+
+// How long the null backend pretends each operation takes
+struct NullLatencies
+{
+    std::chrono::milliseconds start{0};
+    std::chrono::milliseconds stop{0};
+    std::chrono::milliseconds ssh{0}; // per command, and to come up
+    std::chrono::milliseconds snapshot{0};
+};
+
+// An instance without a guest, for exercising the daemon without a hypervisor. It goes through the
+// usual states after the configured delays; commands succeed with no output.
+class NullVirtualMachine final : public BaseVirtualMachine
+{
+public:
+    NullVirtualMachine(const VirtualMachineDescription& desc,
+                       VMStatusMonitor& monitor,
+                       const SSHKeyProvider& key_provider,
+                       const Path& instance_dir,
+                       const NullLatencies& latencies);
+
+    void start() override;
+    void shutdown(ShutdownPolicy shutdown_policy = ShutdownPolicy::Powerdown) override;
+    void suspend() override;
+    State current_state() override;
+    int ssh_port() override;
+    std::string ssh_hostname(std::chrono::milliseconds timeout) override;
+    std::string ssh_username() override;
+    std::optional<IPAddress> management_ipv4() override;
+    std::vector<IPAddress> get_all_ipv4() override;
+    std::string ssh_exec(const std::string& cmd, bool whisper = false) override;
+    void wait_until_ssh_up(std::chrono::milliseconds timeout) override;
+    void wait_for_cloud_init(std::chrono::milliseconds timeout) override;
+    void handle_state_update() override;
+    void update_cpus(int num_cores) override;
+    void resize_memory(const MemorySize& new_size) override;
+    void resize_disk(const MemorySize& new_size) override;
+
+    const NullLatencies& get_latencies() const;
+
+protected:
+    std::shared_ptr<Snapshot> make_specific_snapshot(const QString& filename) override;
+    std::shared_ptr<Snapshot> make_specific_snapshot(const std::string& snapshot_name,
+                                                     const std::string& comment,
+                                                     const std::string& instance_id,
+                                                     const VMSpecs& specs,
+                                                     std::shared_ptr<Snapshot> parent) override;
+
+private:
+    VirtualMachineDescription desc;
+    VMStatusMonitor* monitor;
+    const NullLatencies latencies;
+    const IPAddress ip;
+};
+} // namespace multipass
+
+inline auto multipass::NullVirtualMachine::get_latencies() const -> const NullLatencies&
+{
+    return latencies;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "null_virtual_machine_factory.h"
+#include "null_vm_image_vault.h"
+
+#include <multipass/utils.h>
+#include <multipass/virtual_machine_description.h>
+
+namespace mp = multipass;
+
+namespace
+{
+std::chrono::milliseconds latency_from_env(const char* name)
+{
+    return std::chrono::milliseconds{qEnvironmentVariableIntValue(name)};
+}
+
+mp::NullLatencies latencies_from_env()
+{
+    return {latency_from_env("MULTIPASS_NULL_START_MS"),
+            latency_from_env("MULTIPASS_NULL_STOP_MS"),
+            latency_from_env("MULTIPASS_NULL_SSH_MS"),
+            latency_from_env("MULTIPASS_NULL_SNAPSHOT_MS")};
+}
+} // namespace
+
+mp::NullVirtualMachineFactory::NullVirtualMachineFactory(const Path& data_dir)
+    : BaseVirtualMachineFactory(
+          MP_UTILS.derive_instances_dir(data_dir, get_backend_directory_name(), instances_subdir)),
+      latencies{latencies_from_env()}
+{
+}
+
+auto mp::NullVirtualMachineFactory::create_virtual_machine(const VirtualMachineDescription& desc,
+                                                           const SSHKeyProvider& key_provider,
+                                                           VMStatusMonitor& monitor)
+    -> VirtualMachine::UPtr
+{
+    return std::make_unique<NullVirtualMachine>(desc,
+                                                monitor,
+                                                key_provider,
+                                                get_instance_directory(desc.vm_name),
+                                                latencies);
+}
+
+void mp::NullVirtualMachineFactory::prepare_networking(
+    std::vector<NetworkInterface>& /*extra_interfaces*/)
+{
+}
+
+mp::VMImage mp::NullVirtualMachineFactory::prepare_source_image(const VMImage& source_image)
+{
+    return source_image;
+}
+
+void mp::NullVirtualMachineFactory::prepare_instance_image(
+    const VMImage& /*instance_image*/,
+    const VirtualMachineDescription& /*desc*/)
+{
+}
+
+void mp::NullVirtualMachineFactory::hypervisor_health_check()
+{
+}
+
+auto mp::NullVirtualMachineFactory::create_image_vault(std::vector<VMImageHost*> /*image_hosts*/,
+                                                       URLDownloader* /*downloader*/,
+                                                       const Path& /*cache_dir_path*/,
+                                                       const Path& /*data_dir_path*/,
+                                                       const days& /*days_to_expire*/)
+    -> VMImageVault::UPtr
+{
+    return std::make_unique<NullVMImageVault>(
+        [this](const std::string& name) { return get_instance_directory(name); });
+}
+
+void mp::NullVirtualMachineFactory::remove_resources_for_impl(const std::string& /*name*/)
+{
+    // all there is lives in the instance directory, which the base removes
+}
+
+auto mp::NullVirtualMachineFactory::clone_vm_impl(const std::string& /*source_vm_name*/,
+                                                  const VMSpecs& /*src_vm_specs*/,
+                                                  const VirtualMachineDescription& desc,
+                                                  VMStatusMonitor& monitor,
+                                                  const SSHKeyProvider& key_provider)
+    -> VirtualMachine::UPtr
+{
+    return create_virtual_machine(desc, key_provider, monitor);
+}
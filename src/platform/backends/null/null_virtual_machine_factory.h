@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "null_virtual_machine.h"
+
+#include <shared/base_virtual_machine_factory.h>
+
+namespace multipass
+{
+// A backend without a hypervisor, to run the daemon under load with as many instances as wanted.
+// The simulated latencies come from the MULTIPASS_NULL_{START,STOP,SSH,SNAPSHOT}_MS environment
+// variables and default to nothing.
+class NullVirtualMachineFactory final : public BaseVirtualMachineFactory
+{
+public:
+    explicit NullVirtualMachineFactory(const Path& data_dir);
+
+    VirtualMachine::UPtr create_virtual_machine(const VirtualMachineDescription& desc,
+                                                const SSHKeyProvider& key_provider,
+                                                VMStatusMonitor& monitor) override;
+
+    void prepare_networking(std::vector<NetworkInterface>& extra_interfaces) override;
+    VMImage prepare_source_image(const VMImage& source_image) override;
+    void prepare_instance_image(const VMImage& instance_image,
+                                const VirtualMachineDescription& desc) override;
+    void hypervisor_health_check() override;
+    QString get_backend_directory_name() const override
+    {
+        return "null";
+    };
+    QString get_backend_version_string() const override
+    {
+        return "null";
+    };
+    VMImageVault::UPtr create_image_vault(std::vector<VMImageHost*> image_hosts,
+                                          URLDownloader* downloader,
+                                          const Path& cache_dir_path,
+                                          const Path& data_dir_path,
+                                          const days& days_to_expire) override;
+
+protected:
+    void remove_resources_for_impl(const std::string& name) override;
+
+private:
+    VirtualMachine::UPtr clone_vm_impl(const std::string& source_vm_name,
+                                       const VMSpecs& src_vm_specs,
+                                       const VirtualMachineDescription& desc,
+                                       VMStatusMonitor& monitor,
+                                       const SSHKeyProvider& key_provider) override;
+
+    const NullLatencies latencies;
+};
+} // namespace multipass
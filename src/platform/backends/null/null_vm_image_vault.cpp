@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "null_vm_image_vault.h"
+
+#include <multipass/query.h>
+#include <multipass/vm_image.h>
+
+#include <QDir>
+#include <QFile>
+
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto image_filename = "null.img";
+constexpr auto release = "null";
+
+mp::Path image_path_in(const mp::Path& dir)
+{
+    return QDir{dir}.filePath(image_filename);
+}
+
+mp::VMImage image_in(const mp::Path& dir)
+{
+    const auto path = image_path_in(dir);
+    if (QFile file{path};
+        !file.exists() && !(QDir{}.mkpath(dir) && file.open(QIODevice::WriteOnly)))
+        throw std::runtime_error{"Could not create the null image in " + dir.toStdString()};
+
+    return {path, release, release, release, {}, "Null", {release}};
+}
+} // namespace
+
+mp::NullVMImageVault::NullVMImageVault(InstanceDirectory instance_dir_for)
+    : instance_dir_for{std::move(instance_dir_for)}
+{
+}
+
+mp::VMImage mp::NullVMImageVault::fetch_image(const FetchType& /*fetch_type*/,
+                                              const Query& /*query*/,
+                                              const PrepareAction& /*prepare*/,
+                                              const ProgressMonitor& /*monitor*/,
+                                              const std::optional<std::string>& /*checksum*/,
+                                              const Path& save_dir)
+{
+    return image_in(save_dir);
+}
+
+void mp::NullVMImageVault::remove(const std::string& /*name*/)
+{
+    // the image goes with the instance directory
+}
+
+bool mp::NullVMImageVault::has_record_for(const std::string& name)
+{
+    return QFile::exists(image_path_in(instance_dir_for(name)));
+}
+
+void mp::NullVMImageVault::prune_expired_images()
+{
+}
+
+void mp::NullVMImageVault::update_images(const FetchType& /*fetch_type*/,
+                                         const PrepareAction& /*prepare*/,
+                                         const ProgressMonitor& /*monitor*/)
+{
+}
+
+mp::MemorySize mp::NullVMImageVault::minimum_image_size_for(const std::string& /*id*/)
+{
+    return MemorySize{};
+}
+
+void mp::NullVMImageVault::clone(const std::string& /*source_instance_name*/,
+                                 const std::string& destination_instance_name)
+{
+    image_in(instance_dir_for(destination_instance_name));
+}
+
+mp::VMImageHost* mp::NullVMImageVault::image_host_for(const std::string& /*remote_name*/) const
+{
+    return nullptr;
+}
+
+auto mp::NullVMImageVault::all_info_for(const Query& query) const
+    -> std::vector<std::pair<std::string, VMImageInfo>>
+{
+    // whatever was asked for exists
+    VMImageInfo info{{QString::fromStdString(query.release)},
+                     "Null",
+                     release,
+                     "Null",
+                     release,
+                     true,
+                     {},
+                     release,
+                     {},
+                     {},
+                     0,
+                     false};
+    return {{query.remote_name, std::move(info)}};
+}
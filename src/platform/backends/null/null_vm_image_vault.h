@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <multipass/vm_image_vault.h>
+
+#include <functional>
+
+namespace multipass
+{
+// Hands out empty images instantly, without any image host. An instance has an image for as long
+// as its directory holds one.
+class NullVMImageVault final : public VMImageVault
+{
+public:
+    using InstanceDirectory = std::function<Path(const std::string& name)>;
+    explicit NullVMImageVault(InstanceDirectory instance_dir_for);
+
+    VMImage fetch_image(const FetchType& fetch_type,
+                        const Query& query,
+                        const PrepareAction& prepare,
+                        const ProgressMonitor& monitor,
+                        const std::optional<std::string>& checksum,
+                        const Path& save_dir) override;
+    void remove(const std::string& name) override;
+    bool has_record_for(const std::string& name) override;
+    void prune_expired_images() override;
+    void update_images(const FetchType& fetch_type,
+                       const PrepareAction& prepare,
+                       const ProgressMonitor& monitor) override;
+    MemorySize minimum_image_size_for(const std::string& id) override;
+    void clone(const std::string& source_instance_name,
+               const std::string& destination_instance_name) override;
+    VMImageHost* image_host_for(const std::string& remote_name) const override;
+    std::vector<std::pair<std::string, VMImageInfo>> all_info_for(
+        const Query& query) const override;
+
+private:
+    InstanceDirectory instance_dir_for;
+};
+} // namespace multipass
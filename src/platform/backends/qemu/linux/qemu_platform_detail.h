@@ -40,6 +40,8 @@ public:
     void remove_resources_for(const std::string& name) override;
     void platform_health_check() override;
     QStringList vm_platform_args(const VirtualMachineDescription& vm_desc) override;
+    QString vcpu_hotplug_driver() const override;
+    QString virtiofsd_path() const override;
     bool is_network_supported(const std::string& network_type) const override;
     bool needs_network_prep() const override;
     std::string create_bridge_with(const NetworkInterfaceInfo& interface) const override;
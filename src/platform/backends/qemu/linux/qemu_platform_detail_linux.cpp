@@ -17,16 +17,21 @@
 
 #include "qemu_platform_detail.h"
 
+#include <multipass/exceptions/snap_environment_exception.h>
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/platform.h>
+#include <multipass/snap_utils.h>
 #include <multipass/utils.h>
 
 #include <shared/linux/backend_utils.h>
 
 #include <QCoreApplication>
 #include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -36,6 +41,8 @@ namespace
 {
 constexpr auto category = "qemu platform";
 const QString multipass_bridge_name{"mpqemubr0"};
+constexpr auto vhost_net_device = "/dev/vhost-net";
+constexpr int max_net_queues = 8; // beyond this, extra queues mostly add interrupt overhead
 
 // An interface name can only be 15 characters, so this generates a hash of the
 // VM instance name with a "tap-" prefix and then truncates it.
@@ -47,11 +54,35 @@ auto generate_tap_device_name(const std::string& vm_name)
     return QString::fromStdString(tap_name);
 }
 
-void create_tap_device(const QString& tap_name, const QString& bridge_name)
+bool is_multi_queue_tap(const QString& tap_name)
 {
-    if (!MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_name}))
+    // Lines look like "tap-1234: tap vnet_hdr multi_queue persist"
+    const auto tuntaps =
+        QString::fromStdString(MP_UTILS.run_cmd_for_output("ip", {"tuntap", "show"}));
+    for (const auto& line : tuntaps.split('\n'))
+        if (line.startsWith(tap_name + ':'))
+            return line.contains("multi_queue");
+
+    return false;
+}
+
+void create_tap_device(const QString& tap_name, const QString& bridge_name, bool multi_queue)
+{
+    auto exists = MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_name});
+    if (exists && multi_queue && !is_multi_queue_tap(tap_name))
     {
-        MP_UTILS.run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
+        // QEMU cannot attach several queues to a tap created without them
+        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", tap_name});
+        exists = false;
+    }
+
+    if (!exists)
+    {
+        auto add_args = QStringList{"tuntap", "add", tap_name, "mode", "tap"};
+        if (multi_queue)
+            add_args << "multi_queue";
+
+        MP_UTILS.run_cmd_for_status("ip", add_args);
         MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
         MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
     }
@@ -169,7 +200,17 @@ QStringList mp::QemuPlatformDetail::vm_platform_args(const VirtualMachineDescrip
 {
     // Configure and generate the args for the default network interface
     auto tap_device_name = generate_tap_device_name(vm_desc.vm_name);
-    create_tap_device(tap_device_name, bridge_name);
+
+    // Have in-kernel vhost workers serve a queue pair per vCPU, unless vhost-net is unavailable
+    const auto vhost = MP_FILEOPS.exists(QFileInfo{vhost_net_device});
+    const auto queues = vhost ? std::clamp(vm_desc.num_cores, 1, max_net_queues) : 1;
+    if (!vhost)
+        mpl::debug(category,
+                   "{} is unavailable, {} falls back to single-queue userspace networking",
+                   vhost_net_device,
+                   vm_desc.vm_name);
+
+    create_tap_device(tap_device_name, bridge_name, queues > 1);
 
     name_to_net_device_map.emplace(vm_desc.vm_name,
                                    std::make_pair(tap_device_name, vm_desc.default_mac_address));
@@ -194,13 +235,34 @@ QStringList mp::QemuPlatformDetail::vm_platform_args(const VirtualMachineDescrip
     opts << "--enable-kvm"
          // Pass host CPU flags to VM
          << "-cpu"
-         << "host"
-         // Set up the network related args
-         << "-nic"
-         << QString::fromStdString(
-                fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
-                            tap_device_name,
-                            vm_desc.default_mac_address));
+         << "host";
+
+    // Set up the network related args
+    if (vhost)
+    {
+        // "-nic" cannot turn on multi-queue in the device, so the backend and device are set apart.
+        // The device keeps the name "-nic" gives it, which the network reset after resuming uses.
+        opts << "-netdev"
+             << QString::fromStdString(
+                    fmt::format("tap,id=net0,ifname={},script=no,downscript=no,vhost=on,queues={}",
+                                tap_device_name,
+                                queues))
+             << "-device"
+             << QString::fromStdString(
+                    fmt::format("virtio-net-pci,id=virtio-net-pci.0,netdev=net0,mac={}{}",
+                                vm_desc.default_mac_address,
+                                // a vector per queue each way, plus config and control
+                                queues > 1 ? fmt::format(",mq=on,vectors={}", 2 * queues + 2)
+                                           : ""));
+    }
+    else
+    {
+        opts << "-nic"
+             << QString::fromStdString(
+                    fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
+                                tap_device_name,
+                                vm_desc.default_mac_address));
+    }
 
     const auto bridge_helper_exec_path =
         QDir(QCoreApplication::applicationDirPath()).filePath(BRIDGE_HELPER_EXEC_NAME_CPP);
@@ -223,6 +285,33 @@ mp::QemuPlatform::UPtr mp::QemuPlatformFactory::make_qemu_platform(const Path& d
     return std::make_unique<mp::QemuPlatformDetail>(data_dir);
 }
 
+QString mp::QemuPlatformDetail::vcpu_hotplug_driver() const
+{
+#if defined Q_PROCESSOR_X86
+    return "host-x86_64-cpu"; // matches the "-cpu host" in vm_platform_args
+#else
+    return {};
+#endif
+}
+
+QString mp::QemuPlatformDetail::virtiofsd_path() const
+{
+    QString root_dir; // either "" or $SNAP
+    try
+    {
+        root_dir = mpu::snap_dir();
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+    }
+
+    // Only the Rust rewrite is looked for; the C helper that came with QEMU takes other options
+    if (const QFileInfo info{root_dir + "/usr/libexec/virtiofsd"}; info.isExecutable())
+        return info.filePath();
+
+    return {};
+}
+
 bool mp::QemuPlatformDetail::is_network_supported(const std::string& network_type) const
 {
     return network_type == "bridge" || network_type == "ethernet";
@@ -16,6 +16,7 @@
  */
 
 #include "qemu_mount_handler.h"
+#include "qemu_virtiofsd_process_spec.h"
 
 #include <multipass/utils.h>
 
@@ -28,6 +29,17 @@ namespace mpu = multipass::utils;
 namespace
 {
 constexpr auto category = "qemu-mount-handler";
+constexpr auto default_instance_id = 1000;
+
+// The host and instance ids of the single mapping a native mount takes
+std::pair<int, int> resolved_mapping_from(const mp::id_mappings& mappings)
+{
+    if (mappings.empty())
+        return {default_instance_id, default_instance_id};
+
+    const auto host_id = mappings.front().first;
+    return {host_id, *mp::IdMap{mappings, default_instance_id}.instance_id_for(host_id)};
+}
 } // namespace
 
 namespace multipass
@@ -38,6 +50,7 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
                                    VMMount mount_spec)
     : MountHandler{vm, ssh_key_provider, std::move(mount_spec), target},
       vm_mount_args{vm->modifiable_mount_args()},
+      vm_virtiofsd_args{vm->modifiable_virtiofsd_args()},
       // Create a reproducible unique mount tag for each mount. The cmd arg can only be 31 bytes
       // long so part of the uuid must be truncated. First character of tag must also be
       // alphabetical.
@@ -46,6 +59,7 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
     auto state = vm->current_state();
     if (state == VirtualMachine::State::suspended && vm_mount_args.find(tag) != vm_mount_args.end())
     {
+        virtiofs = vm_virtiofsd_args.find(tag) != vm_virtiofsd_args.end();
         mpl::info(category,
                   "Found native mount {} => {} in '{}' while suspended",
                   source,
@@ -70,18 +84,32 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
               target,
               vm->get_name());
 
-    const auto uid_map = this->mount_spec.get_uid_mappings().empty()
-                             ? std::make_pair(1000, 1000)
-                             : this->mount_spec.get_uid_mappings()[0];
-    const auto gid_map = this->mount_spec.get_gid_mappings().empty()
-                             ? std::make_pair(1000, 1000)
-                             : this->mount_spec.get_gid_mappings()[0];
-    const auto uid_arg = QString("uid_map=%1:%2,")
-                             .arg(uid_map.first)
-                             .arg(uid_map.second == -1 ? 1000 : uid_map.second);
-    const auto gid_arg = QString{"gid_map=%1:%2,"}
-                             .arg(gid_map.first)
-                             .arg(gid_map.second == -1 ? 1000 : gid_map.second);
+    const auto [host_uid, instance_uid] =
+        resolved_mapping_from(this->mount_spec.get_uid_mappings());
+    const auto [host_gid, instance_gid] =
+        resolved_mapping_from(this->mount_spec.get_gid_mappings());
+
+    if (vm->supports_virtiofs())
+    {
+        mpl::debug(category, "serving {} over virtio-fs", source);
+
+        virtiofs = true;
+        const auto socket_path =
+            QemuVirtiofsdProcessSpec::socket_path_for(vm->instance_directory(), tag);
+        const auto qtag = QString::fromStdString(tag);
+        vm_mount_args[tag] = {source,
+                              {"-chardev",
+                               QString{"socket,id=%1,path=%2"}.arg(qtag, socket_path),
+                               "-device",
+                               QString{"vhost-user-fs-pci,chardev=%1,tag=%1"}.arg(qtag)}};
+        vm_virtiofsd_args[tag] = {
+            QString{"--translate-uid=map:%1:%2:1"}.arg(instance_uid).arg(host_uid),
+            QString{"--translate-gid=map:%1:%2:1"}.arg(instance_gid).arg(host_gid)};
+        return;
+    }
+
+    const auto uid_arg = QString("uid_map=%1:%2,").arg(host_uid).arg(instance_uid);
+    const auto gid_arg = QString{"gid_map=%1:%2,"}.arg(host_gid).arg(instance_gid);
     vm_mount_args[tag] = {source,
                           {"-virtfs",
                            QString::fromStdString(fmt::format(
@@ -97,13 +125,17 @@ try
 {
     return active &&
            !SSHSession{vm->ssh_hostname(), vm->ssh_port(), vm->ssh_username(), *ssh_key_provider}
-                .exec(fmt::format("findmnt --type 9p | grep '{} {}'", target, tag))
+                .exec(fmt::format("findmnt --type {} | grep '{} {}'",
+                                  virtiofs ? "virtiofs" : "9p",
+                                  target,
+                                  tag))
                 .exit_code();
 }
 catch (const std::exception& e)
 {
     mpl::warn(category,
-              "Failed checking 9p mount \"{}\" in instance '{}': {}",
+              "Failed checking {} mount \"{}\" in instance '{}': {}",
+              virtiofs ? "virtiofs" : "9p",
               target,
               vm->get_name(),
               e.what());
@@ -140,9 +172,11 @@ void QemuMountHandler::activate_impl(ServerVariant, std::chrono::milliseconds)
 
     MP_UTILS.run_in_ssh_session(
         session,
-        fmt::format("sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912",
-                    tag,
-                    target));
+        virtiofs ? fmt::format("sudo mount -t virtiofs {} {}", tag, target)
+                 : fmt::format(
+                       "sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912",
+                       tag,
+                       target));
 }
 
 void QemuMountHandler::deactivate_impl(bool force)
@@ -169,5 +203,6 @@ QemuMountHandler::~QemuMountHandler()
 {
     deactivate(/*force=*/true);
     vm_mount_args.erase(tag);
+    vm_virtiofsd_args.erase(tag);
 }
 } // namespace multipass
@@ -38,7 +38,9 @@ public:
 
 private:
     QemuVirtualMachine::MountArgs& vm_mount_args;
+    QemuVirtualMachine::VirtiofsdArgs& vm_virtiofsd_args;
     std::string tag;
+    bool virtiofs{false}; // over virtio-fs when the host has virtiofsd, 9p otherwise
 };
 
 } // namespace multipass
@@ -53,6 +53,16 @@ public:
     {
         return {};
     };
+    // The -device driver for vCPUs plugged into a running instance; empty if unsupported
+    virtual QString vcpu_hotplug_driver() const
+    {
+        return {};
+    };
+    // The virtiofsd binary serving native mounts over virtio-fs; empty if unsupported
+    virtual QString virtiofsd_path() const
+    {
+        return {};
+    };
     virtual bool is_network_supported(const std::string& network_type) const = 0;
     virtual bool needs_network_prep() const = 0;
     virtual std::string create_bridge_with(const NetworkInterfaceInfo& interface) const = 0;
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_virtiofsd_process_spec.h"
+
+#include <multipass/exceptions/snap_environment_exception.h>
+#include <multipass/format.h>
+#include <multipass/snap_utils.h>
+
+#include <QFileInfo>
+
+#include <stdexcept>
+#include <sys/un.h>
+
+namespace mp = multipass;
+namespace mpu = multipass::utils;
+
+mp::QemuVirtiofsdProcessSpec::QemuVirtiofsdProcessSpec(const QString& program,
+                                                       const std::string& shared_dir,
+                                                       const QString& socket_path,
+                                                       const QStringList& extra_arguments)
+    : virtiofsd_program{program},
+      shared_dir{QString::fromStdString(shared_dir)},
+      socket_path{socket_path},
+      extra_arguments{extra_arguments}
+{
+}
+
+QString mp::QemuVirtiofsdProcessSpec::socket_path_for(const QDir& instance_dir,
+                                                      const std::string& tag)
+{
+    auto socket_path = instance_dir.filePath(QString::fromStdString(tag.substr(0, 9)) + ".sock");
+    if (socket_path.toUtf8().size() >= static_cast<qsizetype>(sizeof(sockaddr_un::sun_path)))
+        throw std::runtime_error{fmt::format(
+            "The path to the virtio-fs socket is too long for a Unix socket: {}", socket_path)};
+
+    return socket_path;
+}
+
+QString mp::QemuVirtiofsdProcessSpec::program() const
+{
+    return virtiofsd_program;
+}
+
+QStringList mp::QemuVirtiofsdProcessSpec::arguments() const
+{
+    // AppArmor confines the helper to the shared directory, so it needs no sandbox of its own
+    return QStringList() << QString("--socket-path=%1").arg(socket_path)
+                         << QString("--shared-dir=%1").arg(shared_dir) << "--sandbox=none"
+                         << "--cache=auto"
+                         << "--announce-submounts" << extra_arguments;
+}
+
+QString mp::QemuVirtiofsdProcessSpec::apparmor_profile() const
+{
+    QString profile_template(R"END(
+#include <tunables/global>
+profile %1 flags=(attach_disconnected) {
+  #include <abstractions/base>
+
+  # serve files with their owners and permissions
+  capability chown,
+  capability dac_override,
+  capability dac_read_search,
+  capability fowner,
+  capability fsetid,
+  capability mknod,
+  capability setgid,
+  capability setuid,
+
+  # Allow multipassd send virtiofsd signals
+  signal (receive) peer=%2,
+
+  @{PROC}/sys/fs/nr_open r,
+  owner @{PROC}/@{pid}/fd/ r,
+  owner @{PROC}/@{pid}/mountinfo r,
+
+  # binary and its libs
+  %3 ixr,
+  %4/{,usr/}lib/{,@{multiarch}/}{,**/}*.so* rm,
+
+  # vhost-user socket shared with qemu
+  %5 rw,
+
+  # allow full access just to the user-specified mount directory on the host
+  %6/ rw,
+  %6/** rwlk,
+}
+    )END");
+
+    /* Customisations depending on if running inside snap or not */
+    QString root_dir;    // root directory: either "" or $SNAP
+    QString signal_peer; // who can send kill signal to virtiofsd
+
+    try
+    {
+        root_dir = mpu::snap_dir();
+        signal_peer = "snap.multipass.multipassd";
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+        signal_peer = "unconfined";
+    }
+
+    return profile_template.arg(apparmor_profile_name(),
+                                signal_peer,
+                                program(),
+                                root_dir,
+                                socket_path,
+                                shared_dir);
+}
+
+QString mp::QemuVirtiofsdProcessSpec::identifier() const
+{
+    // One helper per mount of each instance; the socket lives in the instance directory
+    const QFileInfo socket_info{socket_path};
+    return socket_info.dir().dirName() + '.' + socket_info.completeBaseName();
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/process/process_spec.h>
+
+#include <QDir>
+#include <QStringList>
+
+#include <string>
+
+namespace multipass
+{
+
+// The virtiofsd helper serving one virtio-fs native mount to the instance through a vhost-user
+// socket; it exits by itself once QEMU disconnects
+class QemuVirtiofsdProcessSpec : public ProcessSpec
+{
+public:
+    explicit QemuVirtiofsdProcessSpec(const QString& program,
+                                      const std::string& shared_dir,
+                                      const QString& socket_path,
+                                      const QStringList& extra_arguments);
+
+    // Unix socket paths are short, so the name only carries the first part of the mount tag. Throws
+    // std::runtime_error when the instance directory is too deep for it to fit all the same.
+    static QString socket_path_for(const QDir& instance_dir, const std::string& tag);
+
+    QString program() const override;
+    QStringList arguments() const override;
+
+    QString apparmor_profile() const override;
+    QString identifier() const override;
+
+private:
+    const QString virtiofsd_program;
+    const QString shared_dir;
+    const QString socket_path;
+    const QStringList extra_arguments;
+};
+
+} // namespace multipass
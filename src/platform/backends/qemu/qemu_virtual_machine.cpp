@@ -19,11 +19,13 @@
 #include "qemu_img_utils.h"
 #include "qemu_mount_handler.h"
 #include "qemu_snapshot.h"
+#include "qemu_virtiofsd_process_spec.h"
 #include "qemu_vm_process_spec.h"
 #include "qemu_vmstate_process_spec.h"
 
 #include <multipass/exceptions/internal_timeout_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
+#include <multipass/executor.h>
 #include <multipass/format.h>
 #include <multipass/ip_address.h>
 #include <multipass/logging/log.h>
@@ -34,6 +36,7 @@
 #include <multipass/vm_mount.h>
 #include <multipass/vm_status_monitor.h>
 
+#include <QDeadlineTimer>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -41,6 +44,7 @@
 #include <QProcess>
 #include <QString>
 #include <QTemporaryFile>
+#include <QThread>
 
 #include <cassert>
 
@@ -58,9 +62,21 @@ constexpr auto arguments_key = "arguments";
 constexpr auto mount_data_key = "mount_data";
 constexpr auto mount_source_key = "source";
 constexpr auto mount_arguments_key = "arguments";
+constexpr auto mount_virtiofsd_arguments_key = "virtiofsd_arguments";
+constexpr auto disk_profile_key = "disk_profile";
+
+constexpr auto dimm_prefix = "dimm";
+constexpr auto memory_backend_prefix = "mem";
+constexpr auto hotplug_memory_alignment = 128LL * 1024 * 1024; // guests online memory in blocks
+// Room to grow live is capped at this multiple of the size the instance boots with, so that QEMU
+// does not reserve CPU slots and guest address space for the whole host
+constexpr auto hotplug_headroom_factor = 4;
+constexpr auto qmp_reply_timeout = 5s;
+constexpr auto device_release_timeout = 10s; // guests have to offline what they give back
 
 constexpr int shutdown_timeout = 300000;   // unit: ms, 5 minute timeout for shutdown/suspend
 constexpr int kill_process_timeout = 5000; // unit: ms, 5 seconds timeout for killing the process
+constexpr auto virtiofsd_socket_timeout = 5s;
 
 QString get_vm_machine(const QJsonObject& metadata)
 {
@@ -104,10 +120,29 @@ auto mount_args_from_json(const QJsonObject& object)
     return mount_args;
 }
 
+auto virtiofsd_args_from_json(const QJsonObject& object)
+{
+    mp::QemuVirtualMachine::VirtiofsdArgs virtiofsd_args;
+    auto mount_data_map = object[mount_data_key].toObject();
+    for (const auto& tag : mount_data_map.keys())
+    {
+        const auto mount_data = mount_data_map[tag].toObject();
+        if (!mount_data.contains(mount_virtiofsd_arguments_key))
+            continue;
+
+        auto args = mount_data[mount_virtiofsd_arguments_key].toArray();
+        if (!std::all_of(args.begin(), args.end(), std::mem_fn(&QJsonValueRef::isString)))
+            continue;
+        virtiofsd_args[tag.toStdString()] = QVariant{args.toVariantList()}.toStringList();
+    }
+    return virtiofsd_args;
+}
+
 auto make_qemu_process(const mp::VirtualMachineDescription& desc,
                        const std::optional<QJsonObject>& resume_metadata,
                        const mp::QemuVirtualMachine::MountArgs& mount_args,
-                       const QStringList& platform_args)
+                       const QStringList& platform_args,
+                       const std::optional<mp::VirtualMachine::LiveResizeLimits>& hotplug_headroom)
 {
     if (!QFile::exists(desc.image.image_path) || !QFile::exists(desc.cloud_init_iso))
     {
@@ -124,7 +159,11 @@ auto make_qemu_process(const mp::VirtualMachineDescription& desc,
     }
 
     auto process_spec =
-        std::make_unique<mp::QemuVMProcessSpec>(desc, platform_args, mount_args, resume_data);
+        std::make_unique<mp::QemuVMProcessSpec>(desc,
+                                                platform_args,
+                                                mount_args,
+                                                resume_data,
+                                                hotplug_headroom);
     auto process = mp::platform::make_process(std::move(process_spec));
 
     mpl::debug(desc.vm_name, "process working dir '{}'", process->working_directory());
@@ -140,6 +179,14 @@ auto qmp_execute_json(const QString& cmd)
     return QJsonDocument(qmp).toJson();
 }
 
+auto qmp_execute_json(const QString& cmd, const QJsonObject& args)
+{
+    QJsonObject qmp;
+    qmp.insert("execute", cmd);
+    qmp.insert("arguments", args);
+    return QJsonDocument(qmp).toJson();
+}
+
 auto hmc_to_qmp_json(const QString& command_line)
 {
     auto qmp = QJsonDocument::fromJson(qmp_execute_json("human-monitor-command")).object();
@@ -180,30 +227,106 @@ auto get_qemu_machine_type(const QStringList& platform_args)
     return machine_type;
 }
 
-auto mount_args_to_json(const mp::QemuVirtualMachine::MountArgs& mount_args)
+auto mount_args_to_json(const mp::QemuVirtualMachine::MountArgs& mount_args,
+                        const mp::QemuVirtualMachine::VirtiofsdArgs& virtiofsd_args)
 {
     QJsonObject object;
     for (const auto& [tag, mount_data] : mount_args)
     {
         const auto& [source, args] = mount_data;
-        object[QString::fromStdString(tag)] =
-            QJsonObject{{mount_source_key, QString::fromStdString(source)},
-                        {mount_arguments_key, QJsonArray::fromStringList(args)}};
+        QJsonObject data{{mount_source_key, QString::fromStdString(source)},
+                         {mount_arguments_key, QJsonArray::fromStringList(args)}};
+        if (const auto it = virtiofsd_args.find(tag); it != virtiofsd_args.end())
+            data[mount_virtiofsd_arguments_key] = QJsonArray::fromStringList(it->second);
+
+        object[QString::fromStdString(tag)] = data;
     }
     return object;
 }
 
 auto generate_metadata(const QStringList& platform_args,
                        const QStringList& proc_args,
-                       const mp::QemuVirtualMachine::MountArgs& mount_args)
+                       const mp::QemuVirtualMachine::MountArgs& mount_args,
+                       const mp::QemuVirtualMachine::VirtiofsdArgs& virtiofsd_args,
+                       mp::DiskProfile disk_profile)
 {
     QJsonObject metadata;
     metadata[machine_type_key] = get_qemu_machine_type(platform_args);
     metadata[arguments_key] = QJsonArray::fromStringList(proc_args);
-    metadata[mount_data_key] = mount_args_to_json(mount_args);
+    metadata[mount_data_key] = mount_args_to_json(mount_args, virtiofsd_args);
+    metadata[disk_profile_key] = mp::disk_profile_name(disk_profile);
     return metadata;
 }
 
+// The value following an option, e.g. "2,maxcpus=8" for "-smp"
+QString option_value(const QStringList& args, const QString& option)
+{
+    const auto index = args.indexOf(option);
+    return index >= 0 && index + 1 < args.size() ? args[index + 1] : QString{};
+}
+
+// The value of a property within an option value, e.g. "8" for "maxcpus" in "2,maxcpus=8"
+QString property_value(const QString& option_value, const QString& property)
+{
+    for (const auto& entry : option_value.split(','))
+        if (entry.startsWith(property + '='))
+            return entry.mid(property.size() + 1);
+
+    return {};
+}
+
+// Recover the headroom the instance was booted with from its recorded arguments
+std::optional<mp::VirtualMachine::LiveResizeLimits> hotplug_limits_from(const QStringList& args)
+{
+    const auto smp = option_value(args, "-smp");
+    const auto mem = option_value(args, "-m");
+    const auto max_cpus = property_value(smp, "maxcpus");
+    const auto max_mem = property_value(mem, "maxmem");
+    if (max_cpus.isEmpty() || max_mem.isEmpty())
+        return std::nullopt;
+
+    try
+    {
+        return mp::VirtualMachine::LiveResizeLimits{
+            smp.section(',', 0, 0).toInt(),
+            max_cpus.toInt(),
+            mp::MemorySize{mem.section(',', 0, 0).toStdString()},
+            mp::MemorySize{max_mem.toStdString()}};
+    }
+    catch (const std::exception&)
+    {
+        return std::nullopt;
+    }
+}
+
+// The DIMMs plugged in while running, in order of insertion, as pairs of index and size in bytes
+std::vector<std::pair<int, long long>> hotplugged_dimms(const QStringList& args)
+{
+    std::vector<std::pair<int, long long>> dimms;
+    for (auto i = args.indexOf("-object"); i >= 0 && i + 1 < args.size();
+         i = args.indexOf("-object", i + 1))
+    {
+        const auto id = property_value(args[i + 1], "id");
+        if (id.startsWith(memory_backend_prefix))
+            dimms.emplace_back(id.mid(qstrlen(memory_backend_prefix)).toInt(),
+                               property_value(args[i + 1], "size").toLongLong());
+    }
+
+    return dimms;
+}
+
+void remove_option_with_id(QStringList& args, const QString& option, const QString& id)
+{
+    for (auto i = args.indexOf(option); i >= 0 && i + 1 < args.size();
+         i = args.indexOf(option, i))
+    {
+        if (property_value(args[i + 1], "id") == id)
+            args.remove(i, 2);
+        else
+            ++i;
+    }
+}
+
 QStringList extract_snapshot_tags(const QByteArray& snapshot_list_output_stream)
 {
     QStringList lines = QString{snapshot_list_output_stream}.split('\n');
@@ -248,7 +371,8 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
       desc{desc},
       qemu_platform{qemu_platform},
       monitor{&monitor},
-      mount_args{mount_args_from_json(monitor.retrieve_metadata_for(vm_name))}
+      mount_args{mount_args_from_json(monitor.retrieve_metadata_for(vm_name))},
+      virtiofsd_args{virtiofsd_args_from_json(monitor.retrieve_metadata_for(vm_name))}
 {
     connect_vm_signals();
 
@@ -261,12 +385,14 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
 
 mp::QemuVirtualMachine::~QemuVirtualMachine()
 {
+    root_filesystem_growth.waitForFinished(); // it goes through this instance's SSH session
+
     if (vm_process)
     {
         update_shutdown_status = false;
 
         mp::top_catch_all(vm_name, [this]() {
-            if (state == State::running)
+            if (state == State::running && virtiofsd_processes.empty())
             {
                 suspend();
             }
@@ -301,9 +427,16 @@ void mp::QemuVirtualMachine::start()
 
         monitor->update_metadata_for(
             vm_name,
-            generate_metadata(qemu_platform->vmstate_platform_args(), proc_args, mount_args));
+            generate_metadata(qemu_platform->vmstate_platform_args(),
+                              proc_args,
+                              mount_args,
+                              virtiofsd_args,
+                              desc.disk_profile));
     }
 
+    // QEMU connects to the virtio-fs helpers as it starts, so they need to be listening first
+    start_virtiofsd_processes();
+
     vm_process->start();
     connect_vm_signals();
 
@@ -411,6 +544,11 @@ void mp::QemuVirtualMachine::suspend()
 {
     if ((state == State::running || state == State::delayed_shutdown) && vm_process->running())
     {
+        // QEMU cannot save the state of vhost-user-fs devices, so savevm would fail
+        if (!virtiofsd_processes.empty())
+            throw std::runtime_error{"Instances with virtio-fs mounts cannot be suspended, stop "
+                                     "the instance or unmount them first"};
+
         if (update_shutdown_status)
         {
             state = State::suspending;
@@ -530,12 +668,27 @@ void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout
 
 void mp::QemuVirtualMachine::initialize_vm_process()
 {
+    std::optional<LiveResizeLimits> hotplug_headroom;
+    if (!qemu_platform->vcpu_hotplug_driver().isEmpty())
+        hotplug_headroom = LiveResizeLimits{
+            desc.num_cores,
+            std::max(desc.num_cores,
+                     std::min(QThread::idealThreadCount(),
+                              hotplug_headroom_factor * desc.num_cores)),
+            desc.mem_size,
+            std::max(desc.mem_size,
+                     MemorySize::from_bytes(
+                         std::min(MP_PLATFORM.get_total_ram(),
+                                  hotplug_headroom_factor * desc.mem_size.in_bytes())))};
+
+    qmp_output.clear();
     vm_process = make_qemu_process(
         desc,
         ((state == State::suspended) ? std::make_optional(monitor->retrieve_metadata_for(vm_name))
                                      : std::nullopt),
         mount_args,
-        qemu_platform->vm_platform_args(desc));
+        qemu_platform->vm_platform_args(desc),
+        hotplug_headroom);
 
     QObject::connect(vm_process.get(), &Process::started, [this]() {
         mpl::info(vm_name, "process started");
@@ -543,44 +696,65 @@ void mp::QemuVirtualMachine::initialize_vm_process()
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_output, [this]() {
-        auto qmp_output = vm_process->read_all_standard_output();
-        mpl::debug(vm_name, "QMP: {}", qmp_output);
-        auto qmp_object = QJsonDocument::fromJson(qmp_output.split('\n').first()).object();
-        auto event = qmp_object["event"];
-
-        if (!event.isNull())
+        const auto output = vm_process->read_all_standard_output();
+        mpl::debug(vm_name, "QMP: {}", output);
+
+        // Messages end with a newline and may be split across reads, so only whole lines are
+        // parsed and the rest waits for the next read
+        qmp_output += output;
+        const auto end = qmp_output.lastIndexOf('\n');
+        if (end == -1)
+            return;
+
+        const auto lines = qmp_output.first(end).split('\n');
+        qmp_output.remove(0, end + 1);
+        for (const auto& line : lines)
         {
-            if (event.toString() == "RESET" && state != State::restarting)
-            {
-                mpl::info(vm_name, "VM restarting");
-                on_restart();
-            }
-            else if (event.toString() == "POWERDOWN")
-            {
-                mpl::info(vm_name, "VM powering down");
-            }
-            else if (event.toString() == "SHUTDOWN")
-            {
-                mpl::info(vm_name, "VM shut down");
-            }
-            else if (event.toString() == "STOP")
+            auto qmp_object = QJsonDocument::fromJson(line).object();
+            auto event = qmp_object["event"];
+
+            if (qmp_object.contains("id"))
             {
-                mpl::info(vm_name, "VM suspending");
+                qmp_replies.insert(qmp_object["id"].toString(), qmp_object); // see execute_qmp
             }
-            else if (event.toString() == "RESUME")
+            else if (!event.isNull())
             {
-                mpl::info(vm_name, "VM suspended");
-                if (state == State::suspending || state == State::running)
+                if (event.toString() == "RESET" && state != State::restarting)
+                {
+                    mpl::info(vm_name, "VM restarting");
+                    on_restart();
+                }
+                else if (event.toString() == "POWERDOWN")
                 {
-                    vm_process->kill();
-                    on_suspend();
+                    mpl::info(vm_name, "VM powering down");
+                }
+                else if (event.toString() == "SHUTDOWN")
+                {
+                    mpl::info(vm_name, "VM shut down");
+                }
+                else if (event.toString() == "STOP")
+                {
+                    mpl::info(vm_name, "VM suspending");
+                }
+                else if (event.toString() == "RESUME")
+                {
+                    mpl::info(vm_name, "VM suspended");
+                    if (state == State::suspending || state == State::running)
+                    {
+                        vm_process->kill();
+                        on_suspend();
+                    }
+                }
+                else if (event.toString() == "DEVICE_DELETED")
+                {
+                    on_device_deleted(qmp_object["data"].toObject()["device"].toString());
                 }
             }
-        }
-        else if (qmp_object.contains("error"))
-        {
-            const auto error = qmp_object["error"].toObject();
-            mpl::error(vm_name, "QMP error: {}", error["desc"].toString());
+            else if (qmp_object.contains("error"))
+            {
+                const auto error = qmp_object["error"].toObject();
+                mpl::error(vm_name, "QMP error: {}", error["desc"].toString());
+            }
         }
     });
 
@@ -649,6 +823,46 @@ void mp::QemuVirtualMachine::initialize_vm_process()
     });
 }
 
+void mp::QemuVirtualMachine::start_virtiofsd_processes()
+{
+    virtiofsd_processes.clear(); // the previous ones quit along with QEMU
+
+    for (const auto& [tag, extra_args] : virtiofsd_args)
+    {
+        const auto source = mount_args.find(tag);
+        if (source == mount_args.end())
+            continue;
+
+        const auto socket_path = QemuVirtiofsdProcessSpec::socket_path_for(instance_dir, tag);
+        QFile::remove(socket_path); // left behind if the helper did not get to clean up
+
+        auto process = mp::platform::make_process(
+            std::make_unique<QemuVirtiofsdProcessSpec>(qemu_platform->virtiofsd_path(),
+                                                       source->second.first,
+                                                       socket_path,
+                                                       extra_args));
+        mpl::debug(vm_name, "virtiofsd arguments '{}'", process->arguments().join(", "));
+        process->start();
+        if (!process->wait_for_started())
+            throw std::runtime_error{fmt::format("failed to start virtiofsd: {}",
+                                                 process->error_string())};
+
+        const auto deadline = std::chrono::steady_clock::now() + virtiofsd_socket_timeout;
+        while (!QFile::exists(socket_path))
+        {
+            if (!process->running() || std::chrono::steady_clock::now() > deadline)
+                throw std::runtime_error{
+                    fmt::format("virtiofsd failed to serve \"{}\": {}",
+                                source->second.first,
+                                process->read_all_standard_error())};
+
+            QThread::msleep(10);
+        }
+
+        virtiofsd_processes.push_back(std::move(process));
+    }
+}
+
 void mp::QemuVirtualMachine::connect_vm_signals()
 {
     std::unique_lock lock{vm_signal_mutex};
@@ -725,11 +939,163 @@ void mp::QemuVirtualMachine::disconnect_vm_signals()
 void mp::QemuVirtualMachine::update_cpus(int num_cores)
 {
     assert(num_cores > 0);
+
+    if (live_resize_limits())
+    {
+        // Plugged vCPUs are recorded as "-device" arguments, so that resuming recreates them
+        auto args = live_arguments();
+        const auto driver = qemu_platform->vcpu_hotplug_driver();
+        const auto id_of = [](int core) { return QString{"cpu%1"}.arg(core); };
+        const auto plug = [this, &driver, &id_of](int core) {
+            mpl::debug(vm_name, "Plugging in vCPU {}", id_of(core));
+            execute_qmp("device_add",
+                        {{"driver", driver},
+                         {"id", id_of(core)},
+                         {"socket-id", 0},
+                         {"core-id", core},
+                         {"thread-id", 0}});
+        };
+
+        // Either all the vCPUs change or none do, so that the instance matches what was recorded
+        auto core = desc.num_cores;
+        try
+        {
+            for (; core < num_cores; ++core)
+            {
+                plug(core);
+                args << "-device"
+                     << QString{"%1,id=%2,socket-id=0,core-id=%3,thread-id=0"}
+                            .arg(driver, id_of(core))
+                            .arg(core);
+            }
+
+            for (; core > num_cores; --core)
+            {
+                mpl::debug(vm_name, "Unplugging vCPU {}", id_of(core - 1));
+                unplug_device(id_of(core - 1));
+                remove_option_with_id(args, "-device", id_of(core - 1));
+            }
+        }
+        catch (const std::exception&)
+        {
+            mp::top_catch_all(vm_name, [this, &core, &plug, &id_of] {
+                for (; core > desc.num_cores; --core)
+                    unplug_device(id_of(core - 1));
+                for (; core < desc.num_cores; ++core)
+                    plug(core);
+            });
+            throw;
+        }
+
+        persist_live_arguments(args);
+    }
+
     desc.num_cores = num_cores;
 }
 
 void mp::QemuVirtualMachine::resize_memory(const MemorySize& new_size)
 {
+    if (live_resize_limits())
+    {
+        auto args = live_arguments();
+        auto dimms = hotplugged_dimms(args);
+
+        const auto plug = [this](int index, long long size) {
+            const auto backend_id = QString{"%1%2"}.arg(memory_backend_prefix).arg(index);
+            const auto dimm_id = QString{"%1%2"}.arg(dimm_prefix).arg(index);
+            mpl::debug(vm_name, "Plugging in {} of memory as {}", size, dimm_id);
+
+            // virtio-fs helpers map guest memory, so it all needs to be shareable with them
+            QJsonObject backend{{"id", backend_id}, {"size", size}};
+            QString backend_option{"memory-backend-ram,id=%1,size=%2"};
+            if (virtiofsd_args.empty())
+            {
+                backend["qom-type"] = "memory-backend-ram";
+            }
+            else
+            {
+                backend["qom-type"] = "memory-backend-memfd";
+                backend["share"] = true;
+                backend_option = "memory-backend-memfd,id=%1,size=%2,share=on";
+            }
+
+            execute_qmp("object-add", backend);
+            try
+            {
+                execute_qmp("device_add",
+                            {{"driver", "pc-dimm"}, {"id", dimm_id}, {"memdev", backend_id}});
+            }
+            catch (const std::exception&)
+            {
+                mp::top_catch_all(vm_name, [this, &backend_id] {
+                    execute_qmp("object-del", {{"id", backend_id}});
+                });
+                throw;
+            }
+
+            return QStringList{"-object",
+                               backend_option.arg(backend_id).arg(size),
+                               "-device",
+                               QString{"pc-dimm,id=%1,memdev=%2"}.arg(dimm_id, backend_id)};
+        };
+
+        if (new_size > desc.mem_size)
+        {
+            const auto size = new_size.in_bytes() - desc.mem_size.in_bytes();
+            if (size % hotplug_memory_alignment)
+                throw std::runtime_error{
+                    fmt::format("The memory of a running instance can only grow in multiples of {}",
+                                MemorySize::from_bytes(hotplug_memory_alignment).human_readable())};
+            if (static_cast<int>(dimms.size()) >= QemuVMProcessSpec::hotplug_memory_slots)
+                throw std::runtime_error{"No memory slots left, stop the instance to resize it"};
+
+            args << plug(dimms.empty() ? 0 : dimms.back().first + 1, size);
+        }
+        else
+        {
+            // Only whole DIMMs can go, most recent first
+            auto excess = desc.mem_size.in_bytes() - new_size.in_bytes();
+            auto first_removed = dimms.end();
+            while (excess > 0 && first_removed != dimms.begin() &&
+                   std::prev(first_removed)->second <= excess)
+                excess -= (--first_removed)->second;
+
+            if (excess)
+                throw std::runtime_error{
+                    "The memory of a running instance can only shrink back by what was added while "
+                    "running, stop the instance to resize it"};
+
+            auto it = dimms.end();
+            try
+            {
+                for (; it != first_removed; --it)
+                {
+                    const auto index = std::prev(it)->first;
+                    const auto dimm_id = QString{"%1%2"}.arg(dimm_prefix).arg(index);
+                    mpl::debug(vm_name, "Unplugging {}", dimm_id);
+
+                    // the memory backend follows once the guest releases the DIMM
+                    unplug_device(dimm_id);
+                    remove_option_with_id(args, "-device", dimm_id);
+                    remove_option_with_id(args,
+                                          "-object",
+                                          QString{"%1%2"}.arg(memory_backend_prefix).arg(index));
+                }
+            }
+            catch (const std::exception&)
+            {
+                // give back what the guest already released, so that the instance keeps its size
+                mp::top_catch_all(vm_name, [&it, &dimms, &plug] {
+                    for (; it != dimms.end(); ++it)
+                        plug(it->first, it->second);
+                });
+                throw;
+            }
+        }
+
+        persist_live_arguments(args);
+    }
+
     desc.mem_size = new_size;
 }
 
@@ -737,10 +1103,157 @@ void mp::QemuVirtualMachine::resize_disk(const MemorySize& new_size)
 {
     assert(new_size > desc.disk_space);
 
-    mp::backend::resize_instance_image(new_size, desc.image.image_path);
+    if (live_resize_limits())
+    {
+        mpl::debug(vm_name, "Growing the disk to {}", new_size.human_readable());
+        execute_qmp("block_resize", {{"device", "hda"}, {"size", new_size.in_bytes()}});
+
+        // the profile the instance was booted with determines what the guest sees
+        const auto metadata = monitor->retrieve_metadata_for(vm_name);
+        const auto booted_profile = mp::disk_profile_from(metadata[disk_profile_key].toString())
+                                        .value_or(DiskProfile::standard);
+
+        // cloud-init would otherwise only grow the root filesystem on the next boot. That is
+        // best-effort, so it is left to run in the background rather than hold up the daemon.
+        root_filesystem_growth.waitForFinished();
+        root_filesystem_growth = MP_EXECUTOR.run(Lane::blocking, [this, booted_profile] {
+            try
+            {
+                ssh_exec(booted_profile == DiskProfile::throughput
+                             ? "sudo sh -c 'growpart /dev/vda 1 && resize2fs /dev/vda1'"
+                             : "sudo sh -c 'echo 1 > /sys/class/block/sda/device/rescan && "
+                               "growpart /dev/sda 1 && resize2fs /dev/sda1'");
+            }
+            catch (const std::exception& e)
+            {
+                mpl::warn(vm_name,
+                          "Failed to grow the root filesystem before restart: {}",
+                          e.what());
+            }
+        });
+    }
+    else
+        mp::backend::resize_instance_image(new_size, desc.image.image_path);
+
     desc.disk_space = new_size;
 }
 
+auto mp::QemuVirtualMachine::live_resize_limits() const -> std::optional<LiveResizeLimits>
+{
+    if (state != State::running || !vm_process || !vm_process->running() ||
+        qemu_platform->vcpu_hotplug_driver().isEmpty())
+        return std::nullopt;
+
+    return hotplug_limits_from(live_arguments());
+}
+
+QStringList mp::QemuVirtualMachine::live_arguments() const
+{
+    return get_arguments(monitor->retrieve_metadata_for(vm_name));
+}
+
+void mp::QemuVirtualMachine::persist_live_arguments(const QStringList& args)
+{
+    auto metadata = monitor->retrieve_metadata_for(vm_name);
+    metadata[arguments_key] = QJsonArray::fromStringList(args);
+    monitor->update_metadata_for(vm_name, metadata);
+}
+
+void mp::QemuVirtualMachine::on_device_deleted(const QString& device)
+{
+    mpl::debug(vm_name, "Device {} removed", device);
+    deleted_devices.insert(device);
+
+    if (device.startsWith(dimm_prefix))
+        vm_process->write(qmp_execute_json(
+            "object-del",
+            {{"id", memory_backend_prefix + device.mid(qstrlen(dimm_prefix))}}));
+}
+
+// Commands carry an id for QEMU to echo in its reply, which the output handler files away
+QJsonObject mp::QemuVirtualMachine::execute_qmp(const QString& cmd, const QJsonObject& args)
+{
+    const auto id = QString{"mp-%1"}.arg(++qmp_command_id);
+    vm_process->write(
+        QJsonDocument(QJsonObject{{"execute", cmd}, {"arguments", args}, {"id", id}}).toJson());
+
+    if (!wait_for_qmp(qmp_reply_timeout, [this, &id] { return qmp_replies.contains(id); }))
+        throw std::runtime_error{fmt::format("QEMU did not answer {} in time", cmd)};
+
+    const auto reply = qmp_replies.take(id);
+    if (reply.contains("error"))
+        throw std::runtime_error{
+            fmt::format("{} failed: {}", cmd, reply["error"].toObject()["desc"].toString())};
+
+    return reply["return"].toObject();
+}
+
+// QEMU's output is handled as soon as it is read, so waiting for it is enough to see it through
+bool mp::QemuVirtualMachine::wait_for_qmp(std::chrono::milliseconds timeout,
+                                          const std::function<bool()>& done)
+{
+    QDeadlineTimer deadline{timeout};
+    while (!done())
+    {
+        if (deadline.hasExpired() || !vm_process->running())
+            return false;
+
+        vm_process->wait_for_ready_read(std::chrono::milliseconds{deadline.remainingTime()});
+    }
+
+    return true;
+}
+
+// Unplugging needs the guest to let go of the device, which QEMU only reports as an event
+void mp::QemuVirtualMachine::unplug_device(const QString& id)
+{
+    deleted_devices.remove(id);
+    execute_qmp("device_del", {{"id", id}});
+
+    if (!wait_for_qmp(device_release_timeout, [this, &id] { return deleted_devices.contains(id); }))
+        throw std::runtime_error{fmt::format("The instance did not release {} in time", id)};
+}
+
+void mp::QemuVirtualMachine::set_disk_profile(DiskProfile profile)
+{
+    desc.disk_profile = profile; // takes effect on the next boot
+}
+
+void mp::QemuVirtualMachine::set_memory_density(bool enabled)
+{
+    desc.memory_density = enabled; // takes effect on the next boot
+}
+
+void mp::QemuVirtualMachine::set_balloon_target(const MemorySize& target)
+{
+    if (!desc.memory_density || !vm_process || !vm_process->running())
+        throw std::runtime_error{"Memory can only be reclaimed from running instances in memory "
+                                 "density mode"};
+
+    mpl::debug(vm_name, "Setting the balloon target to {}", target.human_readable());
+    vm_process->write(qmp_execute_json("balloon", {{"value", target.in_bytes()}}));
+}
+
+std::optional<mp::MemorySize> mp::QemuVirtualMachine::host_memory_usage() const
+{
+#ifdef __linux__
+    if (!vm_process || !vm_process->running())
+        return std::nullopt;
+
+    QFile status{QString{"/proc/%1/status"}.arg(vm_process->process_id())};
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+        return std::nullopt;
+
+    // e.g. "VmRSS:	  123456 kB"
+    for (auto line = status.readLine(); !line.isEmpty(); line = status.readLine())
+        if (line.startsWith("VmRSS:"))
+            return MemorySize::from_bytes(line.mid(6).trimmed().split(' ').first().toLongLong() *
+                                          1024);
+#endif
+
+    return std::nullopt; // elsewhere, there is no /proc to read the resident set from
+}
+
 void mp::QemuVirtualMachine::add_network_interface(int /* not used on this backend */,
                                                    const std::string& default_mac_addr,
                                                    const NetworkInterface& extra_interface)
@@ -771,6 +1284,16 @@ mp::QemuVirtualMachine::MountArgs& mp::QemuVirtualMachine::modifiable_mount_args
     return mount_args;
 }
 
+mp::QemuVirtualMachine::VirtiofsdArgs& mp::QemuVirtualMachine::modifiable_virtiofsd_args()
+{
+    return virtiofsd_args;
+}
+
+bool mp::QemuVirtualMachine::supports_virtiofs() const
+{
+    return !qemu_platform->virtiofsd_path().isEmpty();
+}
+
 auto mp::QemuVirtualMachine::make_specific_snapshot(const std::string& snapshot_name,
                                                     const std::string& comment,
                                                     const std::string& instance_id,
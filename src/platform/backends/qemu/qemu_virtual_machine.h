@@ -25,11 +25,17 @@
 #include <multipass/process/process.h>
 #include <multipass/virtual_machine_description.h>
 
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 
 #include <chrono>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
@@ -41,6 +47,8 @@ class QemuVirtualMachine : public QObject, public BaseVirtualMachine
     Q_OBJECT
 public:
     using MountArgs = std::unordered_map<std::string, std::pair<std::string, QStringList>>;
+    // Extra virtiofsd arguments for the mounts (by tag) that go over virtio-fs rather than 9p
+    using VirtiofsdArgs = std::unordered_map<std::string, QStringList>;
 
     QemuVirtualMachine(const VirtualMachineDescription& desc,
                        QemuPlatform* qemu_platform,
@@ -63,10 +71,17 @@ public:
     void update_cpus(int num_cores) override;
     void resize_memory(const MemorySize& new_size) override;
     void resize_disk(const MemorySize& new_size) override;
+    std::optional<LiveResizeLimits> live_resize_limits() const override;
+    void set_disk_profile(DiskProfile profile) override;
+    void set_memory_density(bool enabled) override;
+    void set_balloon_target(const MemorySize& target) override;
+    std::optional<MemorySize> host_memory_usage() const override;
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) override;
     virtual MountArgs& modifiable_mount_args();
+    virtual VirtiofsdArgs& modifiable_virtiofsd_args();
+    virtual bool supports_virtiofs() const;
     std::unique_ptr<MountHandler> make_native_mount_handler(const std::string& target,
                                                             const VMMount& mount) override;
 signals:
@@ -100,11 +115,19 @@ private:
     void on_suspend();
     void on_restart();
     void initialize_vm_process();
+    void start_virtiofsd_processes();
 
     void connect_vm_signals();
     void disconnect_vm_signals();
     void fetch_ip(std::chrono::milliseconds timeout);
 
+    QStringList live_arguments() const;
+    void persist_live_arguments(const QStringList& args);
+    void on_device_deleted(const QString& device);
+    QJsonObject execute_qmp(const QString& cmd, const QJsonObject& args);
+    bool wait_for_qmp(std::chrono::milliseconds timeout, const std::function<bool()>& done);
+    void unplug_device(const QString& id);
+
     void remove_snapshots_from_backend() const;
 
     VirtualMachineDescription desc;
@@ -112,11 +135,18 @@ private:
     QemuPlatform* qemu_platform;
     VMStatusMonitor* monitor;
     MountArgs mount_args;
+    VirtiofsdArgs virtiofsd_args;
+    std::vector<std::unique_ptr<Process>> virtiofsd_processes;
     bool update_shutdown_status{true};
     bool is_starting_from_suspend{false};
     bool force_shutdown{false};
     std::mutex vm_signal_mutex;
     bool vm_signals_connected{false};
     std::chrono::steady_clock::time_point network_deadline;
+    QByteArray qmp_output; // a message QEMU has not finished writing yet
+    int qmp_command_id{0};
+    QHash<QString, QJsonObject> qmp_replies;
+    QSet<QString> deleted_devices;
+    QFuture<void> root_filesystem_growth;
 };
 } // namespace multipass
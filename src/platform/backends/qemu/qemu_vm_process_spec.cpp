@@ -18,20 +18,89 @@
 #include "qemu_vm_process_spec.h"
 
 #include <multipass/exceptions/snap_environment_exception.h>
+#include <multipass/file_ops.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/snap_utils.h>
 #include <shared/linux/backend_utils.h>
 
+#include <QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <fcntl.h>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
 
+namespace
+{
+constexpr auto qcow2_default_cluster_bits = 16u;
+
+// The cluster size recorded in the image's qcow2 header, or the default one if it can't be read
+std::uint64_t qcow2_cluster_size(const QString& image_path)
+{
+    std::array<uchar, 24> header{}; // magic, version, backing file offset and size, cluster bits
+    const auto named_fd = MP_FILEOPS.open_fd(image_path.toStdString(), O_RDONLY, 0);
+    if (named_fd->fd == -1 ||
+        MP_FILEOPS.read(named_fd->fd, header.data(), header.size()) != int(header.size()) ||
+        qFromBigEndian<quint32>(header.data()) != 0x514649fb) // "QFI\xfb"
+        return std::uint64_t{1} << qcow2_default_cluster_bits;
+
+    auto cluster_bits = qFromBigEndian<quint32>(header.data() + 20);
+    if (cluster_bits < 9 || cluster_bits > 21) // outside what QEMU supports
+        cluster_bits = qcow2_default_cluster_bits;
+
+    return std::uint64_t{1} << cluster_bits;
+}
+
+// An L2 cache covering the whole image: 8 bytes per cluster, in whole clusters
+std::uint64_t l2_cache_size_for(std::uint64_t disk_size, std::uint64_t cluster_size)
+{
+    const auto l2_bytes = (disk_size + cluster_size - 1) / cluster_size * 8;
+    return (l2_bytes + cluster_size - 1) / cluster_size * cluster_size;
+}
+
+// How to bypass the host page cache. Native AIO needs cache=none, i.e. O_DIRECT, which some
+// filesystems (e.g. tmpfs) refuse, so it is only used where the image can be opened that way.
+QString disk_cache_options_for(const QString& image_path)
+{
+#if defined Q_OS_LINUX
+    if (MP_FILEOPS.open_fd(image_path.toStdString(), O_RDONLY | O_DIRECT, 0)->fd != -1)
+        return "cache=none,aio=native";
+
+    return "cache=writeback,aio=threads";
+#else
+    return "cache=none,aio=threads";
+#endif
+}
+
+// Whether any mount goes over virtio-fs, whose helpers need to map guest memory
+bool has_vhost_user_mounts(const mp::QemuVirtualMachine::MountArgs& mount_args)
+{
+    return std::any_of(mount_args.begin(), mount_args.end(), [](const auto& entry) {
+        const auto& args = entry.second.second;
+        return std::any_of(args.begin(), args.end(), [](const QString& arg) {
+            return arg.startsWith("vhost-user-fs-pci");
+        });
+    });
+}
+} // namespace
+
 mp::QemuVMProcessSpec::QemuVMProcessSpec(const mp::VirtualMachineDescription& desc,
                                          const QStringList& platform_args,
                                          const mp::QemuVirtualMachine::MountArgs& mount_args,
-                                         const std::optional<ResumeData>& resume_data)
-    : desc{desc}, platform_args{platform_args}, mount_args{mount_args}, resume_data{resume_data}
+                                         const std::optional<ResumeData>& resume_data,
+                                         const std::optional<VirtualMachine::LiveResizeLimits>&
+                                             hotplug_headroom)
+    : desc{desc},
+      platform_args{platform_args},
+      mount_args{mount_args},
+      resume_data{resume_data},
+      hotplug_headroom{hotplug_headroom}
 {
 }
 
@@ -66,20 +135,75 @@ QStringList mp::QemuVMProcessSpec::arguments() const
         auto mem_size =
             QString::number(desc.mem_size.in_megabytes()) + 'M'; /* flooring here; format documented
 in `man qemu-system`, under `-m` option; including suffix to avoid relying on default unit */
+        auto cpus = QString::number(desc.num_cores);
+
+        if (hotplug_headroom)
+        {
+            // Leave room for vCPUs and DIMMs to be plugged in while running
+            cpus += QString{",sockets=1,cores=%1,threads=1,maxcpus=%1"}.arg(
+                hotplug_headroom->max_cores);
+            mem_size += QString{",slots=%1,maxmem=%2M"}.arg(hotplug_memory_slots).arg(
+                hotplug_headroom->max_memory.in_megabytes());
+        }
 
         args << platform_args;
         // The VM image itself
-        args << "-device"
-             << "virtio-scsi-pci,id=scsi0"
-             << "-drive"
-             << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda")
-                    .arg(desc.image.image_path)
-             << "-device"
-             << "scsi-hd,drive=hda,bus=scsi0.0";
+        if (desc.disk_profile == DiskProfile::throughput)
+        {
+            // A dedicated I/O thread with a queue per vCPU, bypassing the host page cache where
+            // possible, and an L2 cache covering the whole image
+            const auto l2_cache_size =
+                l2_cache_size_for(desc.disk_space.in_bytes(),
+                                  qcow2_cluster_size(desc.image.image_path));
+            args << "-object"
+                 << "iothread,id=iothread0"
+                 << "-drive"
+                 << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda,%2,l2-cache-size=%3")
+                        .arg(desc.image.image_path, disk_cache_options_for(desc.image.image_path))
+                        .arg(l2_cache_size)
+                 << "-device"
+                 << QString("virtio-blk-pci,drive=hda,iothread=iothread0,num-queues=%1")
+                        .arg(desc.num_cores);
+        }
+        else
+        {
+            args << "-device"
+                 << "virtio-scsi-pci,id=scsi0"
+                 << "-drive"
+                 << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda")
+                        .arg(desc.image.image_path)
+                 << "-device"
+                 << "scsi-hd,drive=hda,bus=scsi0.0";
+        }
         // Number of cpu cores
-        args << "-smp" << QString::number(desc.num_cores);
+        args << "-smp" << cpus;
         // Memory to use for VM
         args << "-m" << mem_size;
+        if (has_vhost_user_mounts(mount_args))
+        {
+            // Guest RAM that the virtio-fs helpers can map. KSM leaves shared mappings alone, so it
+            // is not marked mergeable even in memory density mode.
+            args << "-object"
+                 << QString("memory-backend-memfd,id=ram0,size=%1M,share=on")
+                        .arg(desc.mem_size.in_megabytes())
+                 << "-machine"
+                 << "memory-backend=ram0";
+        }
+        else if (desc.memory_density)
+        {
+            // Let KSM merge identical guest pages
+            args << "-object"
+                 << QString("memory-backend-ram,id=ram0,size=%1M,merge=on")
+                        .arg(desc.mem_size.in_megabytes())
+                 << "-machine"
+                 << "memory-backend=ram0";
+        }
+        if (desc.memory_density)
+        {
+            // Have the guest hand free pages back
+            args << "-device"
+                 << "virtio-balloon-pci,id=balloon0,free-page-reporting=on,deflate-on-oom=on";
+        }
         // Control interface
         args << "-qmp"
              << "stdio";
@@ -138,6 +262,7 @@ profile %1 flags=(attach_disconnected) {
   signal (receive) peer=%2,
 
   /dev/net/tun rw,
+  /dev/vhost-net rw,
   /dev/kvm rw,
   /dev/ptmx rw,
   /dev/kqemu rw,
@@ -200,9 +325,16 @@ profile %1 flags=(attach_disconnected) {
 
     for (const auto& [_, mount_data] : mount_args)
     {
-        const auto& [source_path, __] = mount_data;
+        const auto& [source_path, args] = mount_data;
         mount_dirs += QString::fromStdString(source_path) + "/ rw,\n  ";
         mount_dirs += QString::fromStdString(source_path) + "/** rwlk,\n  ";
+
+        // and to the sockets of the virtio-fs helpers serving them
+        for (const auto& arg : args)
+            if (arg.startsWith("socket,"))
+                for (const auto& property : arg.split(','))
+                    if (property.startsWith("path="))
+                        mount_dirs += property.mid(5) + " rw,\n  ";
     }
 
     try
@@ -37,12 +37,16 @@ public:
         QStringList arguments;
     };
 
+    static constexpr int hotplug_memory_slots = 16;
+
     static QString default_machine_type();
 
     explicit QemuVMProcessSpec(const VirtualMachineDescription& desc,
                                const QStringList& platform_args,
                                const QemuVirtualMachine::MountArgs& mount_args,
-                               const std::optional<ResumeData>& resume_data);
+                               const std::optional<ResumeData>& resume_data,
+                               const std::optional<VirtualMachine::LiveResizeLimits>&
+                                   hotplug_headroom = std::nullopt);
 
     QStringList arguments() const override;
 
@@ -54,6 +58,7 @@ private:
     const QStringList platform_args;
     const QemuVirtualMachine::MountArgs mount_args;
     const std::optional<ResumeData> resume_data;
+    const std::optional<VirtualMachine::LiveResizeLimits> hotplug_headroom;
 };
 
 } // namespace multipass
@@ -366,10 +366,8 @@ std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::get_snapshot(int ind
 {
     const std::unique_lock lock{snapshot_mutex};
 
-    auto index_matcher = [index](const auto& elem) { return elem.second->get_index() == index; };
-    if (auto it = std::find_if(snapshots.begin(), snapshots.end(), index_matcher);
-        it != snapshots.end())
-        return it->second;
+    if (auto it = snapshot_tree.find(index); it != snapshot_tree.end() && it->second.snapshot)
+        return it->second.snapshot;
 
     throw std::runtime_error{fmt::format(
         "No snapshot with given index in instance; instance name: {}; snapshot index: {}",
@@ -405,6 +403,9 @@ void mp::BaseVirtualMachine::take_snapshot_rollback_helper(SnapshotMap::iterator
         head_snapshot = std::move(old_head);
     }
 
+    if (it->second)
+        unindex_snapshot(*it->second);
+
     snapshots.erase(it);
 }
 
@@ -446,6 +447,7 @@ std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::take_snapshot(
 
     ++snapshot_count;
     persist_generic_snapshot_info();
+    index_snapshot(ret);
 
     rollback_on_failure.dismiss();
     log_latest_snapshot(std::move(lock));
@@ -524,14 +526,47 @@ void mp::BaseVirtualMachine::delete_snapshot_helper(std::shared_ptr<Snapshot>& s
 void mp::BaseVirtualMachine::update_parents(std::shared_ptr<Snapshot>& deleted_parent,
                                             std::vector<Snapshot*>& updated_parents)
 {
+    auto node_it = snapshot_tree.find(deleted_parent->get_index());
+    if (node_it == snapshot_tree.end() || node_it->second.snapshot != deleted_parent)
+        return;
+
     auto new_parent = deleted_parent->get_parent();
-    for (auto& [ignore, other] : snapshots)
+    for (const auto child_index : node_it->second.children)
     {
-        if (other->get_parent() == deleted_parent)
-        {
-            other->set_parent(new_parent);
-            updated_parents.push_back(other.get());
-        }
+        auto& other = snapshot_tree.at(child_index).snapshot;
+        other->set_parent(new_parent);
+        updated_parents.push_back(other.get());
+    }
+}
+
+void mp::BaseVirtualMachine::index_snapshot(const std::shared_ptr<Snapshot>& snapshot)
+{
+    const auto index = snapshot->get_index();
+    auto parent_index = snapshot->get_parents_index();
+    if (!snapshot_tree.count(parent_index))
+        parent_index = 0;
+
+    if (snapshot_tree.try_emplace(index, SnapshotNode{snapshot, parent_index, {}}).second)
+        snapshot_tree[parent_index].children.insert(index);
+}
+
+void mp::BaseVirtualMachine::unindex_snapshot(const Snapshot& snapshot)
+{
+    auto node_it = snapshot_tree.find(snapshot.get_index());
+    if (node_it == snapshot_tree.end() || node_it->second.snapshot.get() != &snapshot)
+        return; // never made it into the tree
+
+    const auto index = node_it->first;
+    auto node = std::move(node_it->second);
+    snapshot_tree.erase(node_it);
+
+    // the parent adopts the children of the removed snapshot
+    auto& parent = snapshot_tree[node.parent_index];
+    parent.children.erase(index);
+    for (const auto child_index : node.children)
+    {
+        snapshot_tree.at(child_index).parent_index = node.parent_index;
+        parent.children.insert(child_index);
     }
 }
 
@@ -584,10 +619,119 @@ void mp::BaseVirtualMachine::delete_snapshot(const std::string& name)
     auto snapshot = it->second;
     delete_snapshot_helper(snapshot);
 
+    unindex_snapshot(*snapshot);
     snapshots.erase(it); // doesn't throw
     mpl::debug(vm_name, "Snapshot deleted: {}", name);
 }
 
+// Deletes several snapshots at once. Survivors whose ancestors are deleted go straight to their
+// closest surviving ancestor, so each of them is persisted once, however many ancestors it loses.
+// Snapshots are erased children-first; if erasing one fails, those that were already erased stay
+// deleted and the tree is rearranged around them only.
+void mp::BaseVirtualMachine::delete_snapshots(const std::vector<std::string>& names)
+{
+    const std::unique_lock lock{snapshot_mutex};
+
+    DoomedSnapshots doomed;
+    for (const auto& name : names)
+    {
+        auto it = snapshots.find(name);
+        if (it == snapshots.end())
+            throw NoSuchSnapshotException{vm_name, name};
+
+        doomed.emplace(it->second->get_index(), it->second);
+    }
+
+    std::set<int> all_doomed, erased;
+    for (const auto& [index, snapshot] : doomed)
+        all_doomed.insert(index);
+
+    const auto head_path = derive_head_path(instance_dir);
+    const auto old_head = head_snapshot;
+    AssignedParents assigned_parents;
+
+    try
+    {
+        rehome_snapshots(doomed, all_doomed, old_head, head_path, assigned_parents);
+
+        for (const auto& [index, snapshot] : doomed)
+        {
+            snapshot->erase();
+            erased.insert(index);
+        }
+    }
+    catch (...)
+    {
+        top_catch_all(vm_name, [&] {
+            rehome_snapshots(doomed, erased, old_head, head_path, assigned_parents);
+        });
+        forget_snapshots(doomed, erased);
+
+        throw;
+    }
+
+    forget_snapshots(doomed, erased);
+}
+
+void mp::BaseVirtualMachine::rehome_snapshots(const DoomedSnapshots& doomed,
+                                              const std::set<int>& gone,
+                                              const std::shared_ptr<Snapshot>& old_head,
+                                              const Path& head_path,
+                                              AssignedParents& assigned_parents)
+{
+    auto closest_survivor = [this, &gone](int index) {
+        while (gone.count(index))
+            index = snapshot_tree.at(index).parent_index;
+
+        return snapshot_tree.at(index).snapshot; // null when reaching the root
+    };
+
+    for (const auto& [index, snapshot] : doomed)
+    {
+        for (const auto child_index : snapshot_tree.at(index).children)
+        {
+            if (gone.count(child_index))
+                continue;
+
+            auto& child = snapshot_tree.at(child_index).snapshot;
+            auto new_parent = closest_survivor(index);
+
+            auto assigned_it = assigned_parents.find(child.get());
+            const auto& current_parent =
+                assigned_it == assigned_parents.end() ? snapshot : assigned_it->second;
+
+            if (new_parent != current_parent)
+            {
+                child->set_parent(new_parent);
+                assigned_parents[child.get()] = std::move(new_parent);
+            }
+        }
+    }
+
+    auto new_head = old_head && gone.count(old_head->get_index())
+                        ? closest_survivor(old_head->get_index())
+                        : old_head;
+    if (new_head != head_snapshot)
+    {
+        head_snapshot = std::move(new_head);
+        persist_head_snapshot_index(head_path);
+    }
+}
+
+void mp::BaseVirtualMachine::forget_snapshots(const DoomedSnapshots& doomed,
+                                              const std::set<int>& gone)
+{
+    for (const auto& [index, snapshot] : doomed) // children before parents
+    {
+        if (gone.count(index))
+        {
+            unindex_snapshot(*snapshot);
+            snapshots.erase(snapshot->get_name());
+            mpl::debug(vm_name, "Snapshot deleted: {}", snapshot->get_name());
+        }
+    }
+}
+
 void mp::BaseVirtualMachine::load_snapshots()
 {
     const std::unique_lock lock{snapshot_mutex};
@@ -606,9 +750,14 @@ std::vector<std::string> mp::BaseVirtualMachine::get_childrens_names(const Snaps
 {
     std::vector<std::string> children;
 
-    for (const auto& snapshot : view_snapshots())
-        if (snapshot->get_parent().get() == parent)
-            children.push_back(snapshot->get_name());
+    const std::unique_lock lock{snapshot_mutex};
+    if (auto node_it = snapshot_tree.find(parent ? parent->get_index() : 0);
+        node_it != snapshot_tree.end() && node_it->second.snapshot.get() == parent)
+    {
+        children.reserve(node_it->second.children.size());
+        for (const auto child_index : node_it->second.children)
+            children.push_back(snapshot_tree.at(child_index).snapshot->get_name());
+    }
 
     return children;
 }
@@ -662,6 +811,8 @@ void mp::BaseVirtualMachine::load_snapshot(const QString& filename)
         mpl::warn(vm_name, "Snapshot name taken: {}", name);
         throw SnapshotNameTakenException{vm_name, name};
     }
+
+    index_snapshot(snapshot);
 }
 
 auto mp::BaseVirtualMachine::make_common_file_rollback(const Path& file_path,
@@ -24,9 +24,11 @@
 #include <multipass/utils.h>
 #include <multipass/virtual_machine.h>
 
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <set>
 #include <unordered_map>
 
 namespace multipass
@@ -51,6 +53,18 @@ public:
     void wait_for_cloud_init(std::chrono::milliseconds timeout) override;
 
     std::vector<IPAddress> get_all_ipv4() override;
+    void set_disk_profile(DiskProfile profile) override
+    {
+        throw NotImplementedOnThisBackendException("disk profiles");
+    }
+    void set_memory_density(bool enabled) override
+    {
+        throw NotImplementedOnThisBackendException("memory density");
+    }
+    void set_balloon_target(const MemorySize& target) override
+    {
+        throw NotImplementedOnThisBackendException("memory density");
+    }
     void add_network_interface(int index,
                                const std::string& default_mac_addr,
                                const NetworkInterface& extra_interface) override
@@ -78,6 +92,7 @@ public:
                                                   const std::string& comment) override;
     void rename_snapshot(const std::string& old_name, const std::string& new_name) override;
     void delete_snapshot(const std::string& name) override;
+    void delete_snapshots(const std::vector<std::string>& names) override;
     void restore_snapshot(const std::string& name, VMSpecs& specs) override;
     void load_snapshots() override;
     std::vector<std::string> get_childrens_names(const Snapshot* parent) const override;
@@ -123,6 +138,18 @@ protected:
 private:
     using SnapshotMap = std::unordered_map<std::string, std::shared_ptr<Snapshot>>;
 
+    // A node in the snapshot tree, keyed by snapshot index. Index 0 is reserved for a root node
+    // without snapshot, which parents the snapshots that have no parent.
+    struct SnapshotNode
+    {
+        std::shared_ptr<Snapshot> snapshot;
+        int parent_index = 0;
+        std::set<int> children;
+    };
+    using SnapshotTree = std::unordered_map<int, SnapshotNode>;
+    using DoomedSnapshots = std::map<int, std::shared_ptr<Snapshot>, std::greater<>>;
+    using AssignedParents = std::unordered_map<Snapshot*, std::shared_ptr<Snapshot>>;
+
     template <typename LockT>
     void log_latest_snapshot(LockT lock) const;
 
@@ -168,6 +195,15 @@ private:
 
     void delete_snapshot_helper(std::shared_ptr<Snapshot>& snapshot);
 
+    void index_snapshot(const std::shared_ptr<Snapshot>& snapshot);
+    void unindex_snapshot(const Snapshot& snapshot);
+    void rehome_snapshots(const DoomedSnapshots& doomed,
+                          const std::set<int>& gone,
+                          const std::shared_ptr<Snapshot>& old_head,
+                          const Path& head_path,
+                          AssignedParents& assigned_parents);
+    void forget_snapshots(const DoomedSnapshots& doomed, const std::set<int>& gone);
+
     utils::TimeoutAction try_to_ssh();
     void ssh_and_cross_to_running();
     void timeout_ssh();
@@ -183,6 +219,7 @@ private:
     std::string saved_error_msg = "";
     std::optional<SSHSession> ssh_session = std::nullopt;
     SnapshotMap snapshots;
+    SnapshotTree snapshot_tree{{0, SnapshotNode{}}};
     std::shared_ptr<Snapshot> head_snapshot = nullptr;
     int snapshot_count = 0; // tracks the number of snapshots ever taken (regardless of deletes)
     mutable std::recursive_mutex snapshot_mutex;
@@ -26,8 +26,65 @@
 #include <multipass/vm_specs.h>
 #include <multipass/yaml_node_utils.h>
 
+#include <QFile>
+
+#include <vector>
+
 namespace mp = multipass;
 namespace mpu = multipass::utils;
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr auto clone_progress_type = 0; // cloning reports a single kind of progress
+constexpr auto copy_chunk_size = 8 << 20; // between progress reports
+
+template <typename OnChunkCopied>
+void copy_file_reporting_progress(const fs::path& source,
+                                  const fs::path& destination,
+                                  OnChunkCopied&& on_chunk_copied)
+{
+    QFile in{QString::fromStdString(source.string())};
+    QFile out{QString::fromStdString(destination.string())};
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        throw std::runtime_error{
+            fmt::format("Cannot copy {} to {}", source.string(), destination.string())};
+
+    // In the kernel where the host can, sharing extents on file systems with reflinks
+    long long copied = 0;
+    while (true)
+    {
+        const auto chunk = mp::platform::copy_file_data(in.handle(),
+                                                        copied,
+                                                        out.handle(),
+                                                        copied,
+                                                        copy_chunk_size);
+        if (chunk < 0 && copied == 0)
+            break; // not something the host can do, go through memory instead
+        if (chunk < 0)
+            throw std::runtime_error{
+                fmt::format("Cannot copy {} to {}", source.string(), destination.string())};
+        if (chunk == 0)
+            return;
+
+        copied += chunk;
+        if (!on_chunk_copied(static_cast<std::uintmax_t>(chunk)))
+            throw std::runtime_error{"Clone cancelled"};
+    }
+
+    std::vector<char> buffer(copy_chunk_size);
+    while (const auto read = in.read(buffer.data(), buffer.size()))
+    {
+        if (read < 0)
+            throw std::runtime_error{fmt::format("Cannot read from {}", source.string())};
+        if (out.write(buffer.data(), read) != read)
+            throw std::runtime_error{fmt::format("Cannot write to {}", destination.string())};
+
+        if (!on_chunk_copied(static_cast<std::uintmax_t>(read)))
+            throw std::runtime_error{"Clone cancelled"};
+    }
+}
+} // namespace
 
 const mp::Path mp::BaseVirtualMachineFactory::instances_subdir = "vault/instances";
 
@@ -97,11 +154,7 @@ mp::VirtualMachine::UPtr mp::BaseVirtualMachineFactory::clone_bare_vm(
     const multipass::SSHKeyProvider& key_provider,
     VMStatusMonitor& monitor)
 {
-    const std::filesystem::path src_instance_dir{get_instance_directory(src_name).toStdString()};
     const std::filesystem::path dest_instance_dir{get_instance_directory(dest_name).toStdString()};
-
-    copy_instance_dir_with_essential_files(src_instance_dir, dest_instance_dir);
-
     const fs::path cloud_init_path = dest_instance_dir / cloud_init_file_name;
 
     MP_CLOUD_INIT_FILE_OPS.update_identifiers(dest_spec.default_mac_address,
@@ -122,7 +175,9 @@ mp::VirtualMachine::UPtr mp::BaseVirtualMachineFactory::clone_bare_vm(
                                                {},
                                                {},
                                                {},
-                                               {}};
+                                               {},
+                                               dest_spec.disk_profile,
+                                               dest_spec.memory_density};
 
     mp::VirtualMachine::UPtr cloned_instance =
         clone_vm_impl(src_name, src_spec, dest_vm_desc, monitor, key_provider);
@@ -130,13 +185,24 @@ mp::VirtualMachine::UPtr mp::BaseVirtualMachineFactory::clone_bare_vm(
     return cloned_instance;
 }
 
+void mp::BaseVirtualMachineFactory::clone_instance_files(const std::string& src_name,
+                                                         const std::string& dest_name,
+                                                         const ProgressMonitor& monitor)
+{
+    copy_instance_dir_with_essential_files(get_instance_directory(src_name).toStdString(),
+                                           get_instance_directory(dest_name).toStdString(),
+                                           monitor);
+}
+
 void mp::BaseVirtualMachineFactory::copy_instance_dir_with_essential_files(
     const fs::path& source_instance_dir_path,
-    const fs::path& dest_instance_dir_path)
+    const fs::path& dest_instance_dir_path,
+    const ProgressMonitor& monitor)
 {
     assert(fs::exists(source_instance_dir_path) && fs::is_directory(source_instance_dir_path));
 
-    fs::create_directory(dest_instance_dir_path);
+    std::vector<fs::path> essential_files;
+    std::uintmax_t total_bytes = 0;
     for (const auto& entry : fs::directory_iterator(source_instance_dir_path))
     {
         // snapshot files are intentionally skipped;
@@ -146,8 +212,28 @@ void mp::BaseVirtualMachineFactory::copy_instance_dir_with_essential_files(
             entry.path().extension().string() == ".img" ||
             entry.path().extension().string() == ".qcow2")
         {
-            const fs::path dest_file_path = dest_instance_dir_path / entry.path().filename();
-            fs::copy(entry.path(), dest_file_path, fs::copy_options::update_existing);
+            essential_files.push_back(entry.path());
+            total_bytes += entry.file_size();
         }
     }
+
+    fs::create_directory(dest_instance_dir_path);
+
+    std::uintmax_t copied_bytes = 0;
+    auto last_percentage = -1;
+    const auto on_chunk_copied = [&](std::uintmax_t bytes) {
+        copied_bytes += bytes;
+        const auto percentage =
+            total_bytes ? static_cast<int>(copied_bytes * 100 / total_bytes) : 100;
+        if (percentage == last_percentage)
+            return true;
+
+        last_percentage = percentage;
+        return monitor(clone_progress_type, percentage);
+    };
+
+    for (const auto& file : essential_files)
+        copy_file_reporting_progress(file,
+                                     dest_instance_dir_path / file.filename(),
+                                     on_chunk_copied);
 }
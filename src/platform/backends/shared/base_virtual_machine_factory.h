@@ -34,6 +34,9 @@ class BaseVirtualMachineFactory : public VirtualMachineFactory
 {
 public:
     explicit BaseVirtualMachineFactory(const Path& instances_dir);
+    void clone_instance_files(const std::string& src_name,
+                              const std::string& dest_name,
+                              const ProgressMonitor& monitor) override final;
     VirtualMachine::UPtr clone_bare_vm(const VMSpecs& src_spec,
                                        const VMSpecs& dest_spec,
                                        const std::string& src_name,
@@ -102,7 +105,8 @@ private:
                                                VMStatusMonitor& monitor,
                                                const SSHKeyProvider& key_provider);
     static void copy_instance_dir_with_essential_files(const fs::path& source_instance_dir_path,
-                                                       const fs::path& dest_instance_dir_path);
+                                                       const fs::path& dest_instance_dir_path,
+                                                       const ProgressMonitor& monitor);
 
     Path instances_dir;
 };
@@ -87,6 +87,11 @@ public:
         mp::AppArmor::aa_change_onexec_forksafe(aa_exec_str.c_str());
     }
 
+    void reload_apparmor_profile() final
+    {
+        apparmor.load_policy(process_spec->apparmor_profile().toLatin1()); // replaces the old one
+    }
+
     ~AppArmoredProcess()
     {
         try
@@ -31,16 +31,6 @@ namespace mpu = multipass::utils;
 
 namespace
 {
-QString serialise_id_mappings(const mp::id_mappings& xid_mappings)
-{
-    QString out;
-    for (auto ids : xid_mappings)
-    {
-        out += QString("%1:%2,").arg(ids.first).arg(ids.second);
-    }
-    return out;
-}
-
 QByteArray gen_hash(const std::string& path)
 {
     // need to return unique name for each mount.  The target directory string will be unique,
@@ -67,8 +57,8 @@ QStringList mp::SSHFSServerProcessSpec::arguments() const
                          << QString::fromStdString(config.username)
                          << QString::fromStdString(config.source_path)
                          << QString::fromStdString(config.target_path)
-                         << serialise_id_mappings(config.uid_mappings)
-                         << serialise_id_mappings(config.gid_mappings)
+                         << QString::fromStdString(mp::serialise_id_mappings(config.uid_mappings))
+                         << QString::fromStdString(mp::serialise_id_mappings(config.gid_mappings))
                          << QString::number(static_cast<int>(mp::logging::get_logging_level()));
 }
 
@@ -76,6 +66,14 @@ QProcessEnvironment mp::SSHFSServerProcessSpec::environment() const
 {
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("KEY", QString::fromStdString(config.private_key));
+    if (config.cache)
+        env.insert("SSHFS_CACHE", "1");
+    if (!config.sshfs_exec_line.empty())
+    {
+        env.insert("SSHFS_EXEC", QString::fromStdString(config.sshfs_exec_line));
+        env.insert("INSTANCE_UID", QString::number(config.instance_uid));
+        env.insert("INSTANCE_GID", QString::number(config.instance_gid));
+    }
     return env;
 }
 
@@ -120,10 +118,8 @@ profile %1 flags=(attach_disconnected) {
     # CLASSIC ONLY: need to specify required libs from core snap
     /{,var/lib/snapd/}snap/core18/*/{,usr/}lib/@{multiarch}/{,**/}*.so* rm,
 
-    # allow full access just to this user-specified source directory on the host
-    %4/ rw,
-    %4/** rwlk,
-}
+    # allow full access just to the user-specified source directories on the host
+%4}
     )END");
 
     /* Customisations depending on if running inside snap or not */
@@ -144,10 +140,14 @@ profile %1 flags=(attach_disconnected) {
         signal_peer = "unconfined";
     }
 
-    return profile_template.arg(apparmor_profile_name(),
-                                signal_peer,
-                                root_dir,
-                                QString::fromStdString(config.source_path));
+    const auto source_paths =
+        config.source_paths ? *config.source_paths : std::vector{config.source_path};
+    QString source_rules;
+    for (const auto& source_path : source_paths)
+        source_rules +=
+            QString{"    %1/ rw,\n    %1/** rwlk,\n"}.arg(QString::fromStdString(source_path));
+
+    return profile_template.arg(apparmor_profile_name(), signal_peer, root_dir, source_rules);
 }
 
 QString mp::SSHFSServerProcessSpec::identifier() const
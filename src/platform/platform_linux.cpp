@@ -36,6 +36,10 @@
 #include "backends/virtualbox/virtualbox_virtual_machine_factory.h"
 #endif
 
+#ifdef NULL_ENABLED
+#include "backends/null/null_virtual_machine_factory.h"
+#endif
+
 #ifdef MULTIPASS_JOURNALD_ENABLED
 #include "logger/journald_logger.h"
 #else
@@ -262,6 +266,9 @@ bool mp::platform::Platform::is_backend_supported(const QString& backend) const
     return
 #ifdef VIRTUALBOX_ENABLED
         backend == "virtualbox" ||
+#endif
+#ifdef NULL_ENABLED
+        backend == "null" ||
 #endif
         backend == "qemu";
 }
@@ -410,6 +417,11 @@ mp::VirtualMachineFactory::UPtr mp::platform::vm_backend(const mp::Path& data_di
         return std::make_unique<VirtualBoxVirtualMachineFactory>(data_dir);
 #endif
 
+#if NULL_ENABLED
+    if (driver == QStringLiteral("null"))
+        return std::make_unique<NullVirtualMachineFactory>(data_dir);
+#endif
+
     throw std::runtime_error(fmt::format("Unsupported virtualization driver: {}", driver));
 }
 
@@ -35,6 +35,10 @@
 #include "backends/virtualbox/virtualbox_virtual_machine_factory.h"
 #endif
 
+#ifdef NULL_ENABLED
+#include "backends/null/null_virtual_machine_factory.h"
+#endif
+
 #include "shared/macos/process_factory.h"
 #include "shared/sshfs_server_process_spec.h"
 #include <daemon/default_vm_image_vault.h>
@@ -221,6 +225,9 @@ bool mp::platform::Platform::is_backend_supported(const QString& backend) const
 #endif
 #ifdef VIRTUALBOX_ENABLED
         backend == "virtualbox" ||
+#endif
+#ifdef NULL_ENABLED
+        backend == "null" ||
 #endif
         false;
 }
@@ -297,6 +304,12 @@ mp::VirtualMachineFactory::UPtr mp::platform::vm_backend(const mp::Path& data_di
         return std::make_unique<QemuVirtualMachineFactory>(data_dir);
 #endif
     }
+    else if (driver == QStringLiteral("null"))
+    {
+#if NULL_ENABLED
+        return std::make_unique<NullVirtualMachineFactory>(data_dir);
+#endif
+    }
 
     throw std::runtime_error(fmt::format("Unsupported virtualization driver: {}", driver));
 }
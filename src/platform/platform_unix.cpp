@@ -24,9 +24,14 @@
 
 #include <grp.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+
 #include <libssh/sftp.h>
 
 namespace mp = multipass;
@@ -54,6 +59,62 @@ sftp_attributes_struct stat_to_attr(const struct stat* st)
 
     return attr;
 }
+
+sftp_statvfs_struct statvfs_to_sftp(const struct statvfs& buf)
+{
+    sftp_statvfs_struct st{};
+
+    st.f_bsize = buf.f_bsize;
+    st.f_frsize = buf.f_frsize;
+    st.f_blocks = buf.f_blocks;
+    st.f_bfree = buf.f_bfree;
+    st.f_bavail = buf.f_bavail;
+    st.f_files = buf.f_files;
+    st.f_ffree = buf.f_ffree;
+    st.f_favail = buf.f_favail;
+    st.f_fsid = buf.f_fsid;
+    st.f_flag = buf.f_flag;
+    st.f_namemax = buf.f_namemax;
+
+    return st;
+}
+
+// Copies through a buffer, for when the kernel cannot do it for us
+long long copy_through_buffer(int in_fd,
+                              long long in_offset,
+                              int out_fd,
+                              long long out_offset,
+                              unsigned long long length)
+{
+    std::array<char, 65536> buffer;
+    unsigned long long copied = 0;
+
+    while (length == 0 || copied < length)
+    {
+        const auto wanted = length ? std::min<unsigned long long>(buffer.size(), length - copied)
+                                   : buffer.size();
+        const auto r = ::pread(in_fd, buffer.data(), wanted, in_offset + copied);
+        if (r < 0)
+            return -1;
+        if (r == 0)
+            break;
+
+        for (ssize_t written = 0; written < r;)
+        {
+            const auto w = ::pwrite(out_fd,
+                                    buffer.data() + written,
+                                    r - written,
+                                    out_offset + copied + written);
+            if (w < 0)
+                return -1;
+            written += w;
+        }
+
+        copied += r;
+    }
+
+    return copied;
+}
 } // namespace
 
 int mp::platform::Platform::chown(const char* path, unsigned int uid, unsigned int gid) const
@@ -193,6 +254,113 @@ int mp::platform::symlink_attr_from(const char* path, sftp_attributes_struct* at
     return 0;
 }
 
+int mp::platform::entry_attr_from(const char* path, sftp_attributes_struct* attr)
+{
+    return symlink_attr_from(path, attr);
+}
+
+int mp::platform::statvfs_from(const char* path, sftp_statvfs_struct* st)
+{
+    struct statvfs buf
+    {
+    };
+
+    if (const auto ret = ::statvfs(path, &buf); ret < 0)
+        return ret;
+
+    *st = statvfs_to_sftp(buf);
+
+    return 0;
+}
+
+int mp::platform::fstatvfs_from(int fd, sftp_statvfs_struct* st)
+{
+    struct statvfs buf
+    {
+    };
+
+    if (const auto ret = ::fstatvfs(fd, &buf); ret < 0)
+        return ret;
+
+    *st = statvfs_to_sftp(buf);
+
+    return 0;
+}
+
+int mp::platform::sync_file(int fd)
+{
+    return ::fsync(fd);
+}
+
+bool mp::platform::same_file(int fd, int other_fd)
+{
+    struct stat st
+    {
+    };
+    struct stat other_st
+    {
+    };
+
+    return ::fstat(fd, &st) == 0 && ::fstat(other_fd, &other_st) == 0 &&
+           st.st_dev == other_st.st_dev && st.st_ino == other_st.st_ino;
+}
+
+long long mp::platform::copy_file_data(int in_fd,
+                                       long long in_offset,
+                                       int out_fd,
+                                       long long out_offset,
+                                       unsigned long long length)
+{
+#ifdef __linux__
+    // In the kernel, and sharing extents where the file system supports reflinks
+    constexpr auto max_chunk = 1ull << 30;
+    unsigned long long copied = 0;
+
+    while (length == 0 || copied < length)
+    {
+        loff_t in = in_offset + copied, out = out_offset + copied;
+        const auto wanted = length ? std::min(max_chunk, length - copied) : max_chunk;
+        const auto r = ::copy_file_range(in_fd, &in, out_fd, &out, wanted, 0);
+
+        if (r < 0)
+        {
+            // Within a single file, the kernel refuses overlapping ranges, which a forward copy
+            // through a buffer would overwrite before reading
+            if (const auto error = errno; error == EINVAL && same_file(in_fd, out_fd))
+            {
+                errno = error;
+                return -1;
+            }
+
+            // Not between these files, e.g. across file systems or onto one open for appending,
+            // so the rest goes through a buffer
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP ||
+                errno == EBADF)
+                break;
+
+            return -1;
+        }
+
+        if (r == 0)
+            return copied;
+
+        copied += r;
+    }
+
+    if (length && copied == length)
+        return copied;
+#else
+    constexpr unsigned long long copied = 0;
+#endif
+
+    const auto rest = copy_through_buffer(in_fd,
+                                          in_offset + copied,
+                                          out_fd,
+                                          out_offset + copied,
+                                          length ? length - copied : 0);
+    return rest < 0 ? -1 : copied + rest;
+}
+
 mp::platform::PosixSignal::PosixSignal(const PrivatePass& pass) noexcept : Singleton(pass)
 {
 }
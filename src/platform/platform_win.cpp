@@ -48,6 +48,7 @@
 #include <json/json.h>
 
 #include <aclapi.h>
+#include <io.h>
 #include <sddl.h>
 #include <shlobj_core.h>
 #include <windows.h>
@@ -997,6 +998,46 @@ int mp::platform::symlink_attr_from(const char* path, sftp_attributes_struct* at
     return 0;
 }
 
+int mp::platform::entry_attr_from(const char* /*path*/, sftp_attributes_struct* /*attr*/)
+{
+    return -1; // ownership and permissions need Qt's translation here
+}
+
+int mp::platform::statvfs_from(const char* /*path*/, sftp_statvfs_struct* /*st*/)
+{
+    return -1;
+}
+
+int mp::platform::fstatvfs_from(int /*fd*/, sftp_statvfs_struct* /*st*/)
+{
+    return -1;
+}
+
+int mp::platform::sync_file(int fd)
+{
+    return _commit(fd);
+}
+
+bool mp::platform::same_file(int fd, int other_fd)
+{
+    BY_HANDLE_FILE_INFORMATION info, other_info;
+    return GetFileInformationByHandle(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), &info) &&
+           GetFileInformationByHandle(reinterpret_cast<HANDLE>(_get_osfhandle(other_fd)),
+                                      &other_info) &&
+           info.dwVolumeSerialNumber == other_info.dwVolumeSerialNumber &&
+           info.nFileIndexHigh == other_info.nFileIndexHigh &&
+           info.nFileIndexLow == other_info.nFileIndexLow;
+}
+
+long long mp::platform::copy_file_data(int /*in_fd*/,
+                                       long long /*in_offset*/,
+                                       int /*out_fd*/,
+                                       long long /*out_offset*/,
+                                       unsigned long long /*length*/)
+{
+    return -1;
+}
+
 std::function<std::optional<int>(const std::function<bool()>&)> mp::platform::make_quit_watchdog(
     const std::chrono::milliseconds& timeout)
 {
@@ -223,6 +223,10 @@ void mp::BasicProcess::setup_child_process()
 {
 }
 
+void mp::BasicProcess::reload_apparmor_profile()
+{
+}
+
 void mp::BasicProcess::handle_started()
 {
     pid = process.processId(); // save this, so we know it even after finished
@@ -23,12 +23,18 @@
 #include <multipass/settings/persistent_settings_handler.h>
 
 #include <cassert>
+#include <system_error>
 
 namespace mp = multipass;
 namespace mpl = mp::logging;
+namespace fs = std::filesystem;
 
 namespace
 {
+// A file modified this recently may be modified again without its stamp changing, given coarse
+// timestamps, so what is read from it is not cached until it settles
+constexpr auto racy_window = std::chrono::seconds{2};
+
 std::unique_ptr<mp::WrappedQSettings> persistent_settings(const QString& filename)
 {
     return mp::WrappedQSettingsFactory::instance().make_wrapped_qsettings(filename,
@@ -47,6 +53,8 @@ bool exists_but_unreadable(const QString& filename)
             portable, we need to account for a zero errno on the remaining platforms */
 }
 
+// This opens the file once more, on top of QSettings. Gets only come here on cache misses, that is
+// after the file changed, which is also when it may have become unreadable.
 void check_status(const mp::WrappedQSettings& qsettings, const QString& attempted_operation)
 {
     auto status = qsettings.status();
@@ -111,8 +119,50 @@ QString mp::PersistentSettingsHandler::get(const QString& key) const
 {
     const auto& setting_spec =
         get_setting(key); // make sure the key is valid before reading from disk
+
+    // Stamped before reading, so that a change in between invalidates what we read next time
+    const auto current_stamp = stamp();
+    {
+        std::lock_guard<std::mutex> lock{cache_mutex};
+        if (cache_stamp != current_stamp)
+        {
+            cache.clear();
+            cache_stamp.reset();
+        }
+        else if (auto it = cache.find(key); it != cache.end())
+            return it->second;
+    }
+
     auto settings_file = persistent_settings(filename);
-    return checked_get(*settings_file, key, setting_spec, mutex);
+    auto ret = checked_get(*settings_file, key, setting_spec, mutex);
+
+    if (!current_stamp.exists ||
+        current_stamp.mtime + racy_window < fs::file_time_type::clock::now())
+    {
+        std::lock_guard<std::mutex> lock{cache_mutex};
+        if (cache_stamp != current_stamp)
+        {
+            cache.clear();
+            cache_stamp = current_stamp;
+        }
+
+        cache[key] = ret;
+    }
+
+    return ret;
+}
+
+auto mp::PersistentSettingsHandler::stamp() const -> FileStamp
+{
+    const fs::path path{filename.toStdU16String()};
+
+    std::error_code err;
+    const auto mtime = MP_FILEOPS.last_write_time(path, err);
+    if (err)
+        return {}; // missing, or failing in a way that reading the file will report
+
+    const auto size = MP_FILEOPS.file_size(path, err);
+    return {true, mtime, err ? 0 : size};
 }
 
 auto mp::PersistentSettingsHandler::get_setting(const QString& key) const -> const SettingSpec&
@@ -136,6 +186,10 @@ void mp::PersistentSettingsHandler::set(const QString& key, const QString& val)
 
     auto settings_file = persistent_settings(filename);
     checked_set(*settings_file, key, interpreted, mutex);
+
+    std::lock_guard<std::mutex> lock{cache_mutex};
+    cache.clear();
+    cache_stamp.reset();
 }
 
 std::set<QString> mp::PersistentSettingsHandler::keys() const
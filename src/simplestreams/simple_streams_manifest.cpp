@@ -17,6 +17,7 @@
 
 #include <multipass/simple_streams_manifest.h>
 
+#include <QDataStream>
 #include <QFileInfo>
 #include <QHash>
 #include <QJsonDocument>
@@ -28,10 +29,15 @@
 #include <multipass/settings/settings.h>
 #include <multipass/utils.h>
 
+#include <algorithm>
+
 namespace mp = multipass;
 
 namespace
 {
+constexpr quint32 binary_magic = 0x4d50534d; // "MPSM"
+constexpr quint32 binary_format_version = 1;
+
 const QHash<QString, QString> arch_to_manifest{{"x86_64", "amd64"},
                                                {"arm", "armhf"},
                                                {"arm64", "arm64"},
@@ -82,13 +88,54 @@ std::unordered_map<QString, const mp::VMImageInfo*> map_aliases_to_vm_info_for(
     return map;
 }
 
+std::multimap<QString, const mp::VMImageInfo*> map_ids_to_vm_info_for(
+    const std::vector<mp::VMImageInfo>& images)
+{
+    std::multimap<QString, const mp::VMImageInfo*> map;
+
+    for (const auto& image : images)
+        map.emplace(image.id.toLower(), &image);
+
+    return map;
+}
+
+std::vector<const mp::VMImageInfo*> aliased_vm_info_in(const std::vector<mp::VMImageInfo>& images)
+{
+    std::vector<const mp::VMImageInfo*> aliased;
+
+    for (const auto& image : images)
+    {
+        if (!image.aliases.empty())
+            aliased.push_back(&image);
+    }
+
+    return aliased;
+}
+
+void write_image_info(QDataStream& stream, const mp::VMImageInfo& info)
+{
+    stream << info.aliases << info.os << info.release << info.release_title << info.release_codename
+           << info.supported << info.image_location << info.id << info.stream_location
+           << info.version << qint64{info.size} << info.verify;
+}
+
+void read_image_info(QDataStream& stream, mp::VMImageInfo& info)
+{
+    qint64 size;
+    stream >> info.aliases >> info.os >> info.release >> info.release_title >>
+        info.release_codename >> info.supported >> info.image_location >> info.id >>
+        info.stream_location >> info.version >> size >> info.verify;
+    info.size = size;
+}
 } // namespace
 
 mp::SimpleStreamsManifest::SimpleStreamsManifest(const QString& updated_at,
                                                  std::vector<VMImageInfo>&& images)
     : updated_at{updated_at},
       products{std::move(images)},
-      image_records{map_aliases_to_vm_info_for(products)}
+      image_records{map_aliases_to_vm_info_for(products)},
+      products_by_id{map_ids_to_vm_info_for(products)},
+      aliased_products{aliased_vm_info_in(products)}
 {
 }
 
@@ -212,3 +259,48 @@ std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromJson(
 
     return std::make_unique<SimpleStreamsManifest>(updated, std::move(products));
 }
+
+std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromBinary(
+    const QByteArray& data)
+{
+    QDataStream stream{data};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != binary_magic ||
+        version != binary_format_version)
+        throw mp::GenericManifestException("invalid binary manifest");
+
+    QString updated;
+    quint32 count;
+    stream >> updated >> count;
+
+    std::vector<VMImageInfo> products;
+    // Don't trust the count for the reservation, it only bounds the loop
+    products.reserve(std::min<quint32>(count, 4096));
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+        read_image_info(stream, products.emplace_back());
+
+    if (stream.status() != QDataStream::Ok || !stream.atEnd())
+        throw mp::GenericManifestException("truncated binary manifest");
+
+    if (products.empty())
+        throw mp::EmptyManifestException("No supported products found.");
+
+    return std::make_unique<SimpleStreamsManifest>(updated, std::move(products));
+}
+
+QByteArray mp::SimpleStreamsManifest::toBinary() const
+{
+    QByteArray data;
+    QDataStream stream{&data, QIODevice::WriteOnly};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << binary_magic << binary_format_version << updated_at
+           << static_cast<quint32>(products.size());
+    for (const auto& product : products)
+        write_image_info(stream, product);
+
+    return data;
+}
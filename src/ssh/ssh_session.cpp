@@ -18,6 +18,7 @@
 #include <multipass/exceptions/ssh_exception.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/ssh/ssh_key_provider.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/ssh/throw_on_error.h>
@@ -106,6 +107,7 @@ mp::SSHProcess mp::SSHSession::exec(const std::string& cmd, bool whisper)
 {
     auto lvl = whisper ? mpl::Level::trace : mpl::Level::debug;
     mpl::log(lvl, "ssh session", "Executing '{}'", cmd);
+    MP_METRICS.ssh_execs.add();
 
     return {session.get(), cmd, std::unique_lock{mut}};
 }
@@ -31,6 +31,11 @@
 
 #include <QDir>
 #include <QFile>
+#include <QtEndian>
+
+#include <array>
+#include <cstring>
+#include <ctime>
 
 #include <fcntl.h>
 
@@ -56,6 +61,153 @@ enum Permissions
     exec_other = 01
 };
 
+// The extensions handle_extended understands, with their versions, as advertised to clients
+constexpr std::array<std::pair<const char*, const char*>, 7> extensions{{
+    {"posix-rename@openssh.com", "1"},
+    {"hardlink@openssh.com", "1"},
+    {"statvfs@openssh.com", "2"},
+    {"fstatvfs@openssh.com", "2"},
+    {"fsync@openssh.com", "1"},
+    {"copy-data", "1"},
+    {"copy-file", "1"},
+}};
+
+void put_u32(std::string& out, uint32_t value)
+{
+    value = qToBigEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_u64(std::string& out, uint64_t value)
+{
+    value = qToBigEndian(value);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& value)
+{
+    put_u32(out, value.size());
+    out.append(value);
+}
+
+// For the packets libssh has no reply function for
+int send_packet(sftp_session sftp, uint8_t type, const std::string& payload)
+{
+    std::string packet;
+    put_u32(packet, payload.size() + 1);
+    packet.push_back(static_cast<char>(type));
+    packet.append(payload);
+
+    return ssh_channel_write(sftp->channel, packet.data(), packet.size()) == SSH_ERROR ? SSH_ERROR
+                                                                                        : SSH_OK;
+}
+
+int reply_version(sftp_session sftp)
+{
+    std::string payload;
+    put_u32(payload, LIBSFTP_VERSION);
+    for (const auto& [name, version] : extensions)
+    {
+        put_string(payload, name);
+        put_string(payload, version);
+    }
+
+    return send_packet(sftp, SSH_FXP_VERSION, payload);
+}
+
+int reply_statvfs(sftp_session sftp, sftp_client_message msg, const sftp_statvfs_struct& st)
+{
+    std::string payload;
+    put_u32(payload, msg->id);
+    for (const auto value : {st.f_bsize,
+                             st.f_frsize,
+                             st.f_blocks,
+                             st.f_bfree,
+                             st.f_bavail,
+                             st.f_files,
+                             st.f_ffree,
+                             st.f_favail,
+                             st.f_fsid,
+                             st.f_flag,
+                             st.f_namemax})
+        put_u64(payload, value);
+
+    return send_packet(sftp, SSH_FXP_EXTENDED_REPLY, payload);
+}
+
+// The fields after the name of an extended request, which libssh leaves to us
+class ExtendedRequest
+{
+public:
+    explicit ExtendedRequest(sftp_client_message msg)
+    {
+        if (msg->complete_message)
+        {
+            data = static_cast<const char*>(ssh_buffer_get(msg->complete_message));
+            size = ssh_buffer_get_len(msg->complete_message);
+        }
+
+        u32();    // request id
+        string(); // extension name
+    }
+
+    uint32_t u32()
+    {
+        return read<uint32_t>();
+    }
+
+    uint64_t u64()
+    {
+        return read<uint64_t>();
+    }
+
+    bool boolean()
+    {
+        return read<uint8_t>() != 0;
+    }
+
+    std::string string()
+    {
+        const auto length = u32();
+        if (size - pos < length)
+        {
+            valid = false;
+            return {};
+        }
+
+        std::string value(data + pos, length);
+        pos += length;
+        return value;
+    }
+
+    // Whether every field read so far was there
+    bool ok() const
+    {
+        return valid;
+    }
+
+private:
+    template <typename T>
+    T read()
+    {
+        T value{};
+        if (size - pos < sizeof(value))
+        {
+            valid = false;
+            return value;
+        }
+
+        std::memcpy(&value, data + pos, sizeof(value));
+        pos += sizeof(value);
+        return qFromBigEndian(value);
+    }
+
+    const char* data{nullptr};
+    std::size_t size{0};
+    std::size_t pos{0};
+    bool valid{true};
+};
+
 auto make_sftp_session(ssh_session session, ssh_channel channel)
 {
     mp::SftpServer::SftpSessionUptr sftp_server_session{sftp_server_new(session, channel),
@@ -80,7 +232,7 @@ auto make_sftp_session(ssh_session session, ssh_channel channel)
 
     // Optional: Log the SSH_FXP_INIT reception like libssh does with SSH_LOG but with mp::log
 
-    if (sftp_reply_version(msg) != SSH_OK)
+    if (reply_version(sftp_server_session.get()) != SSH_OK)
     {
         throw mp::SSHException(
             "[sftp] server init failed: 'FATAL: Failed to process the SSH_FXP_INIT message'");
@@ -116,80 +268,38 @@ int reply_unsupported(sftp_client_message msg)
     return sftp_reply_status(msg, SSH_FX_OP_UNSUPPORTED, "Unsupported message");
 }
 
-fmt::memory_buffer& operator<<(fmt::memory_buffer& buf, const char* v)
+// An `ls -l` style line, which clients only show to users; formatted straight from the attributes
+auto longname_from(const sftp_attributes_struct& attr, const std::string& filename)
 {
-    fmt::format_to(std::back_inserter(buf), "{}", v);
-    return buf;
-}
+    static constexpr std::array<const char*, 12> months{
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
-auto longname_from(const QFileInfo& file_info, const std::string& filename)
-{
     fmt::memory_buffer out;
-    auto mode = file_info.permissions();
+    const auto type = attr.permissions & SSH_S_IFMT;
+    out.push_back(type == SSH_S_IFLNK ? 'l' : type == SSH_S_IFDIR ? 'd' : '-');
 
-    if (file_info.isSymLink())
-        out << "l";
-    else if (file_info.isDir())
-        out << "d";
-    else
-        out << "-";
-
-    /* user */
-    if (mode & QFileDevice::ReadOwner)
-        out << "r";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::WriteOwner)
-        out << "w";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::ExeOwner)
-        out << "x";
-    else
-        out << "-";
-
-    /*group*/
-    if (mode & QFileDevice::ReadGroup)
-        out << "r";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::WriteGroup)
-        out << "w";
-    else
-        out << "-";
-
-    if (mode & QFileDevice::ExeGroup)
-        out << "x";
-    else
-        out << "-";
-
-    /* other */
-    if (mode & QFileDevice::ReadOther)
-        out << "r";
-    else
-        out << "-";
+    for (const auto shift : {6, 3, 0}) // user, group, other
+    {
+        out.push_back(attr.permissions & (Permissions::read_other << shift) ? 'r' : '-');
+        out.push_back(attr.permissions & (Permissions::write_other << shift) ? 'w' : '-');
+        out.push_back(attr.permissions & (Permissions::exec_other << shift) ? 'x' : '-');
+    }
 
-    if (mode & QFileDevice::WriteOther)
-        out << "w";
-    else
-        out << "-";
+    fmt::format_to(std::back_inserter(out), " 1 {} {} {}", attr.uid, attr.gid, attr.size);
 
-    if (mode & QFileDevice::ExeOther)
-        out << "x";
-    else
-        out << "-";
+    const std::time_t mtime = attr.mtime;
+    if (const auto* time = std::localtime(&mtime))
+        fmt::format_to(std::back_inserter(out),
+                       " {} {} {:02}:{:02}:{:02} {}",
+                       months[time->tm_mon],
+                       time->tm_mday,
+                       time->tm_hour,
+                       time->tm_min,
+                       time->tm_sec,
+                       time->tm_year + 1900);
 
-    fmt::format_to(std::back_inserter(out),
-                   " 1 {} {} {}",
-                   file_info.ownerId(),
-                   file_info.groupId(),
-                   file_info.size());
-
-    const auto timestamp = file_info.lastModified().toString("MMM d hh:mm:ss yyyy").toStdString();
-    fmt::format_to(std::back_inserter(out), " {} {}", timestamp, filename);
+    fmt::format_to(std::back_inserter(out), " {}", filename);
+    out.push_back('\0');
 
     return out;
 }
@@ -252,32 +362,20 @@ auto create_sshfs_process(mp::SSHSession& session,
     return std::make_unique<mp::SSHProcess>(std::move(sshfs_process));
 }
 
-int mapped_id_for(const mp::id_mappings& id_maps, const int id, const int default_id)
+int mapped_id_for(const mp::IdMap& id_map, const int id, const int default_id)
 {
     if (id == mp::no_id_info_available)
         return default_id;
 
-    auto found = std::find_if(id_maps.cbegin(), id_maps.cend(), [id](std::pair<int, int> p) {
-        return id == p.first;
-    });
-
-    return found == id_maps.cend() ? -1
-                                   : (found->second == mp::default_id ? default_id : found->second);
+    return id_map.instance_id_for(id).value_or(-1);
 }
 
-int reverse_id_for(const mp::id_mappings& id_maps, const int id, const int default_id)
+int reverse_id_for(const mp::IdMap& id_map, const int id, const int default_id)
 {
-    auto found = std::find_if(id_maps.cbegin(), id_maps.cend(), [id](std::pair<int, int> p) {
-        return id == p.second;
-    });
-    auto default_found =
-        std::find_if(id_maps.cbegin(), id_maps.cend(), [default_id](std::pair<int, int> p) {
-            return default_id == p.second;
-        });
+    if (const auto host_id = id_map.host_id_for(id))
+        return *host_id;
 
-    return found == id_maps.cend()
-               ? (default_found == id_maps.cend() ? default_id : default_found->first)
-               : found->first;
+    return id_map.host_id_for(default_id).value_or(default_id);
 }
 } // namespace
 
@@ -289,13 +387,32 @@ mp::SftpServer::SftpServer(SSHSession&& session,
                            int default_uid,
                            int default_gid,
                            const std::string& sshfs_exec_line)
+    : SftpServer{std::make_shared<SSHSession>(std::move(session)),
+                 source,
+                 target,
+                 gid_mappings,
+                 uid_mappings,
+                 default_uid,
+                 default_gid,
+                 sshfs_exec_line}
+{
+}
+
+mp::SftpServer::SftpServer(std::shared_ptr<SSHSession> session,
+                           const std::string& source,
+                           const std::string& target,
+                           const id_mappings& gid_mappings,
+                           const id_mappings& uid_mappings,
+                           int default_uid,
+                           int default_gid,
+                           const std::string& sshfs_exec_line)
     : ssh_session{std::move(session)},
-      sshfs_process{create_sshfs_process(ssh_session, sshfs_exec_line, source, target)},
-      sftp_server_session{make_sftp_session(ssh_session, sshfs_process->release_channel())},
+      sshfs_process{create_sshfs_process(*ssh_session, sshfs_exec_line, source, target)},
+      sftp_server_session{make_sftp_session(*ssh_session, sshfs_process->release_channel())},
       source_path{source},
       target_path{target},
-      gid_mappings{gid_mappings},
-      uid_mappings{uid_mappings},
+      gid_map{gid_mappings, default_gid},
+      uid_map{uid_mappings, default_uid},
       default_uid{default_uid},
       default_gid{default_gid},
       sshfs_exec_line{sshfs_exec_line}
@@ -334,50 +451,42 @@ sftp_attributes_struct mp::SftpServer::attr_from(const QFileInfo& file_info)
 
 inline int mp::SftpServer::mapped_uid_for(const int uid)
 {
-    return mapped_id_for(uid_mappings, uid, default_uid);
+    return mapped_id_for(uid_map, uid, default_uid);
 }
 
 inline int mp::SftpServer::mapped_gid_for(const int gid)
 {
-    return mapped_id_for(gid_mappings, gid, default_gid);
+    return mapped_id_for(gid_map, gid, default_gid);
 }
 
 inline int mp::SftpServer::reverse_uid_for(const int uid, const int default_id)
 {
-    return reverse_id_for(uid_mappings, uid, default_id);
+    return reverse_id_for(uid_map, uid, default_id);
 }
 
 inline int mp::SftpServer::reverse_gid_for(const int gid, const int default_id)
 {
-    return reverse_id_for(gid_mappings, gid, default_id);
+    return reverse_id_for(gid_map, gid, default_id);
 }
 
 inline bool mp::SftpServer::has_uid_mapping_for(const int uid)
 {
-    return std::any_of(uid_mappings.begin(), uid_mappings.end(), [uid](std::pair<int, int> p) {
-        return uid == p.first;
-    });
+    return uid_map.instance_id_for(uid).has_value();
 }
 
 inline bool mp::SftpServer::has_gid_mapping_for(const int gid)
 {
-    return std::any_of(gid_mappings.begin(), gid_mappings.end(), [gid](std::pair<int, int> p) {
-        return gid == p.first;
-    });
+    return gid_map.instance_id_for(gid).has_value();
 }
 
 inline bool mp::SftpServer::has_reverse_uid_mapping_for(const int uid)
 {
-    return std::any_of(uid_mappings.cbegin(), uid_mappings.cend(), [uid](std::pair<int, int> p) {
-        return uid == p.second;
-    });
+    return uid_map.host_id_for(uid).has_value();
 }
 
 inline bool mp::SftpServer::has_reverse_gid_mapping_for(const int gid)
 {
-    return std::any_of(gid_mappings.cbegin(), gid_mappings.cend(), [gid](std::pair<int, int> p) {
-        return gid == p.second;
-    });
+    return gid_map.host_id_for(gid).has_value();
 }
 
 bool mp::SftpServer::has_id_mappings_for(const QFileInfo& file_info)
@@ -454,69 +563,73 @@ void mp::SftpServer::process_message(sftp_client_message msg)
 }
 
 void mp::SftpServer::run()
+{
+    while (serve_one())
+        ;
+}
+
+bool mp::SftpServer::serve_one()
 {
     using MsgUPtr =
         std::unique_ptr<sftp_client_message_struct, decltype(sftp_client_message_free)*>;
 
-    while (true)
+    MsgUPtr client_msg{sftp_get_client_message(sftp_server_session.get()),
+                       sftp_client_message_free};
+    auto msg = client_msg.get();
+    if (msg == nullptr)
     {
-        MsgUPtr client_msg{sftp_get_client_message(sftp_server_session.get()),
-                           sftp_client_message_free};
-        auto msg = client_msg.get();
-        if (msg == nullptr)
+        if (stop_invoked)
+            return false;
+
+        int status{0};
+        try
+        {
+            status = sshfs_process->exit_code(250ms);
+        }
+        catch (const mp::ExitlessSSHProcessException&) // should we limit this to
+                                                       // SSHProcessExitError?
+        {
+            status = 1;
+        }
+
+        if (status == 0)
+            return false;
+
+        mpl::error(category,
+                   "sshfs in the instance appears to have exited unexpectedly.  Trying to "
+                   "recover.");
+
+        std::string mount_path = [this] {
+            auto proc =
+                ssh_session->exec(fmt::format("findmnt --source :{}  -o TARGET -n", source_path));
+            return proc.read_std_output();
+        }();
+
+        if (!mount_path.empty())
         {
-            if (stop_invoked)
-                break;
-
-            int status{0};
-            try
-            {
-                status = sshfs_process->exit_code(250ms);
-            }
-            catch (const mp::ExitlessSSHProcessException&) // should we limit this to
-                                                           // SSHProcessExitError?
-            {
-                status = 1;
-            }
-
-            if (status != 0)
-            {
-                mpl::error(category,
-                           "sshfs in the instance appears to have exited unexpectedly.  Trying to "
-                           "recover.");
-
-                std::string mount_path = [this] {
-                    auto proc = ssh_session.exec(
-                        fmt::format("findmnt --source :{}  -o TARGET -n", source_path));
-                    return proc.read_std_output();
-                }();
-
-                if (!mount_path.empty())
-                {
-                    ssh_session.exec(fmt::format("sudo umount {}", mount_path));
-                }
-
-                sshfs_process =
-                    create_sshfs_process(ssh_session, sshfs_exec_line, source_path, target_path);
-                sftp_server_session =
-                    make_sftp_session(ssh_session, sshfs_process->release_channel());
-
-                continue;
-            }
-            else
-            {
-                break;
-            }
+            ssh_session->exec(fmt::format("sudo umount {}", mount_path));
         }
 
-        process_message(msg);
+        sshfs_process =
+            create_sshfs_process(*ssh_session, sshfs_exec_line, source_path, target_path);
+        sftp_server_session = make_sftp_session(*ssh_session, sshfs_process->release_channel());
+
+        return true;
     }
+
+    process_message(msg);
+    return true;
+}
+
+ssh_channel mp::SftpServer::channel() const
+{
+    return sftp_server_session->channel;
 }
 
 void mp::SftpServer::stop()
 {
     stop_invoked = true;
-    ssh_session.force_shutdown();
+    ssh_session->force_shutdown();
 }
 
 int mp::SftpServer::handle_close(sftp_client_message msg)
@@ -850,13 +963,23 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
     if (!dir_iterator.hasNext())
         return sftp_reply_status(msg, SSH_FX_EOF, nullptr);
 
-    const auto max_num_entries_per_packet = 50ll;
-    for (int i = 0; i < max_num_entries_per_packet && dir_iterator.hasNext(); i++)
+    // sshfs refuses replies over 128KiB; fill what a read reply would carry
+    constexpr auto max_names_bytes = 65536u;
+    constexpr auto attr_bytes = 32u; // flags, size, uid, gid, permissions, atime and mtime
+
+    std::size_t names_bytes = 0;
+    while (names_bytes < max_names_bytes && dir_iterator.hasNext())
     {
         const auto& entry = dir_iterator.next();
-        QFileInfo file_info{entry.path().string().c_str()};
+        const auto path = entry.path().string();
+
         sftp_attributes_struct attr{};
-        if (entry.is_symlink())
+        if (mp::platform::entry_attr_from(path.c_str(), &attr) == 0)
+        {
+            attr.uid = mapped_uid_for(attr.uid);
+            attr.gid = mapped_gid_for(attr.gid);
+        }
+        else if (const QFileInfo file_info{path.c_str()}; entry.is_symlink())
         {
             mp::platform::symlink_attr_from(file_info.absoluteFilePath().toStdString().c_str(),
                                             &attr);
@@ -867,8 +990,12 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
         {
             attr = attr_from(file_info);
         }
-        const auto longname = longname_from(file_info, entry.path().string());
-        sftp_reply_names_add(msg, entry.path().filename().string().c_str(), longname.data(), &attr);
+
+        const auto filename = entry.path().filename().string();
+        const auto longname = longname_from(attr, filename);
+        sftp_reply_names_add(msg, filename.c_str(), longname.data(), &attr);
+
+        names_bytes += 8 + filename.size() + longname.size() + attr_bytes;
     }
 
     return sftp_reply_names(msg);
@@ -1323,6 +1450,26 @@ int mp::SftpServer::handle_extended(sftp_client_message msg)
     {
         return handle_rename(msg);
     }
+    else if (method == "statvfs@openssh.com")
+    {
+        return handle_statvfs(msg);
+    }
+    else if (method == "fstatvfs@openssh.com")
+    {
+        return handle_fstatvfs(msg);
+    }
+    else if (method == "fsync@openssh.com")
+    {
+        return handle_fsync(msg);
+    }
+    else if (method == "copy-data")
+    {
+        return handle_copy_data(msg);
+    }
+    else if (method == "copy-file")
+    {
+        return handle_copy_file(msg);
+    }
     else
     {
         mpl::trace(category, "Unhandled extended method requested: {}", method);
@@ -1332,8 +1479,228 @@ int mp::SftpServer::handle_extended(sftp_client_message msg)
     return reply_ok(msg);
 }
 
+int mp::SftpServer::handle_statvfs(sftp_client_message msg)
+{
+    ExtendedRequest request{msg};
+    const auto path = request.string();
+    if (!request.ok())
+        return sftp_reply_status(msg, SSH_FX_BAD_MESSAGE, "malformed statvfs request");
+
+    if (!validate_path(source_path, path))
+    {
+        mpl::trace(category,
+                   "{}: cannot validate path '{}' against source '{}'",
+                   __FUNCTION__,
+                   path,
+                   source_path);
+        return reply_perm_denied(msg);
+    }
+
+    sftp_statvfs_struct st{};
+    if (mp::platform::statvfs_from(path.c_str(), &st) < 0)
+    {
+        mpl::trace(category,
+                   "{}: cannot stat file system of '{}': {}",
+                   __FUNCTION__,
+                   path,
+                   std::strerror(errno));
+        return reply_failure(msg);
+    }
+
+    return reply_statvfs(sftp_server_session.get(), msg, st);
+}
+
+int mp::SftpServer::handle_fstatvfs(sftp_client_message msg)
+{
+    ExtendedRequest request{msg};
+    const auto handle = get_handle<NamedFd>(msg, request.string());
+    if (!request.ok() || handle == nullptr)
+    {
+        mpl::trace(category, "{}: bad handle requested", __FUNCTION__);
+        return reply_bad_handle(msg, "fstatvfs");
+    }
+
+    sftp_statvfs_struct st{};
+    if (mp::platform::fstatvfs_from(handle->fd, &st) < 0)
+    {
+        mpl::trace(category,
+                   "{}: cannot stat file system of '{}': {}",
+                   __FUNCTION__,
+                   handle->path.string(),
+                   std::strerror(errno));
+        return reply_failure(msg);
+    }
+
+    return reply_statvfs(sftp_server_session.get(), msg, st);
+}
+
+int mp::SftpServer::handle_fsync(sftp_client_message msg)
+{
+    ExtendedRequest request{msg};
+    const auto handle = get_handle<NamedFd>(msg, request.string());
+    if (!request.ok() || handle == nullptr)
+    {
+        mpl::trace(category, "{}: bad handle requested", __FUNCTION__);
+        return reply_bad_handle(msg, "fsync");
+    }
+
+    if (mp::platform::sync_file(handle->fd) < 0)
+    {
+        mpl::trace(category,
+                   "{}: cannot sync '{}': {}",
+                   __FUNCTION__,
+                   handle->path.string(),
+                   std::strerror(errno));
+        return reply_failure(msg);
+    }
+
+    return reply_ok(msg);
+}
+
+int mp::SftpServer::handle_copy_data(sftp_client_message msg)
+{
+    ExtendedRequest request{msg};
+    const auto read_handle = get_handle<NamedFd>(msg, request.string());
+    const auto read_offset = request.u64();
+    const auto read_length = request.u64();
+    const auto write_handle = get_handle<NamedFd>(msg, request.string());
+    const auto write_offset = request.u64();
+
+    if (!request.ok() || read_handle == nullptr || write_handle == nullptr)
+    {
+        mpl::trace(category, "{}: bad handle requested", __FUNCTION__);
+        return reply_bad_handle(msg, "copy-data");
+    }
+
+    // Copying a range onto an overlapping range of the same file is not allowed, whichever handles
+    // it is open through; a zero length means "up to the end of the file", which always overlaps
+    const auto overlaps = read_length == 0 || (write_offset < read_offset + read_length &&
+                                               read_offset < write_offset + read_length);
+    if (overlaps && (read_handle == write_handle ||
+                     mp::platform::same_file(read_handle->fd, write_handle->fd)))
+    {
+        mpl::trace(category,
+                   "{}: overlapping ranges in '{}'",
+                   __FUNCTION__,
+                   read_handle->path.string());
+        return reply_failure(msg);
+    }
+
+    // The data stays on the host, instead of making a round trip through the instance
+    if (mp::platform::copy_file_data(read_handle->fd,
+                                     read_offset,
+                                     write_handle->fd,
+                                     write_offset,
+                                     read_length) < 0)
+    {
+        mpl::trace(category,
+                   "{}: cannot copy from '{}' to '{}': {}",
+                   __FUNCTION__,
+                   read_handle->path.string(),
+                   write_handle->path.string(),
+                   std::strerror(errno));
+        return reply_failure(msg);
+    }
+
+    return reply_ok(msg);
+}
+
+int mp::SftpServer::handle_copy_file(sftp_client_message msg)
+{
+    ExtendedRequest request{msg};
+    const auto source = request.string();
+    const auto destination = request.string();
+    const auto overwrite = request.boolean();
+    if (!request.ok())
+        return sftp_reply_status(msg, SSH_FX_BAD_MESSAGE, "malformed copy-file request");
+
+    for (const auto& path : {source, destination})
+    {
+        if (!validate_path(source_path, path))
+        {
+            mpl::trace(category,
+                       "{}: cannot validate path '{}' against source '{}'",
+                       __FUNCTION__,
+                       path,
+                       source_path);
+            return reply_perm_denied(msg);
+        }
+    }
+
+    const QFileInfo source_info{QString::fromStdString(source)};
+    if (!has_id_mappings_for(source_info))
+    {
+        mpl::trace(category,
+                   "{}: cannot access path '{}' without id mapping: permission denied",
+                   __FUNCTION__,
+                   source);
+        return reply_perm_denied(msg);
+    }
+
+    const QFileInfo destination_info{QString::fromStdString(destination)};
+    const auto exists = MP_FILEOPS.exists(destination_info);
+    if (exists && !overwrite)
+        return sftp_reply_status(msg, SSH_FX_FILE_ALREADY_EXISTS, "file already exists");
+
+    const QFileInfo destination_dir{destination_info.absolutePath()};
+    if ((exists && !has_id_mappings_for(destination_info)) ||
+        (!exists && !has_id_mappings_for(destination_dir)))
+    {
+        mpl::trace(category,
+                   "{}: cannot access path '{}' without id mapping: permission denied",
+                   __FUNCTION__,
+                   destination);
+        return reply_perm_denied(msg);
+    }
+
+    try
+    {
+        MP_FILEOPS.copy(source,
+                        destination,
+                        overwrite ? fs::copy_options::overwrite_existing : fs::copy_options::none);
+    }
+    catch (const fs::filesystem_error& e)
+    {
+        mpl::trace(category,
+                   "{}: cannot copy '{}' to '{}': {}",
+                   __FUNCTION__,
+                   source,
+                   destination,
+                   e.what());
+        return reply_failure(msg);
+    }
+
+    if (!exists)
+    {
+        const auto new_uid = reverse_uid_for(destination_dir.ownerId(), destination_dir.ownerId());
+        const auto new_gid = reverse_gid_for(destination_dir.groupId(), destination_dir.groupId());
+
+        if (MP_PLATFORM.chown(destination.c_str(), new_uid, new_gid) < 0)
+        {
+            mpl::trace(category,
+                       "failed to chown '{}' to owner:{} and group:{}",
+                       destination,
+                       new_uid,
+                       new_gid);
+            return reply_failure(msg);
+        }
+    }
+
+    return reply_ok(msg);
+}
+
 template <typename T>
 T* multipass::SftpServer::get_handle(sftp_client_message msg)
 {
     return static_cast<T*>(sftp_handle(msg->sftp, msg->handle));
 }
+
+template <typename T>
+T* multipass::SftpServer::get_handle(sftp_client_message msg, const std::string& handle)
+{
+    SftpHandleUPtr handle_string{ssh_string_new(handle.size()), ssh_string_free};
+    if (!handle_string || ssh_string_fill(handle_string.get(), handle.data(), handle.size()) < 0)
+        return nullptr;
+
+    return static_cast<T*>(sftp_handle(msg->sftp, handle_string.get()));
+}
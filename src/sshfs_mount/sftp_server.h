@@ -46,12 +46,28 @@ public:
                int default_uid,
                int default_gid,
                const std::string& sshfs_exec_line);
+    // For servers taking turns on a session, each through its own channel
+    SftpServer(std::shared_ptr<SSHSession> ssh_session,
+               const std::string& source,
+               const std::string& target,
+               const id_mappings& gid_mappings,
+               const id_mappings& uid_mappings,
+               int default_uid,
+               int default_gid,
+               const std::string& sshfs_exec_line);
     SftpServer(SftpServer&& other);
     ~SftpServer();
 
     void run();
     void stop();
 
+    // Serves the next message from sshfs, waiting for it if need be. Returns false once there will
+    // be no more, because sshfs is gone for good or the server was stopped.
+    bool serve_one();
+
+    // What sshfs sends its messages through, to wait on along with other servers' channels
+    ssh_channel channel() const;
+
     using SSHSessionUptr = std::unique_ptr<ssh_session_struct, decltype(ssh_free)*>;
     using SftpSessionUptr = std::unique_ptr<sftp_session_struct, decltype(sftp_server_free)*>;
     using SSHFSProcUptr = std::unique_ptr<SSHProcess>;
@@ -86,19 +102,26 @@ private:
     int handle_symlink(sftp_client_message msg);
     int handle_write(sftp_client_message msg);
     int handle_extended(sftp_client_message msg);
+    int handle_statvfs(sftp_client_message msg);
+    int handle_fstatvfs(sftp_client_message msg);
+    int handle_fsync(sftp_client_message msg);
+    int handle_copy_data(sftp_client_message msg);
+    int handle_copy_file(sftp_client_message msg);
 
     template <typename T>
     T* get_handle(sftp_client_message msg);
+    template <typename T>
+    T* get_handle(sftp_client_message msg, const std::string& handle);
 
-    SSHSession ssh_session;
+    std::shared_ptr<SSHSession> ssh_session;
     SSHFSProcUptr sshfs_process;
     SftpSessionUptr sftp_server_session;
     const std::string source_path;
     const std::string target_path;
     std::unordered_map<void*, std::unique_ptr<NamedFd>> open_file_handles;
     std::unordered_map<void*, std::unique_ptr<DirIterator>> open_dir_handles;
-    const id_mappings gid_mappings;
-    const id_mappings uid_mappings;
+    const IdMap gid_map;
+    const IdMap uid_map;
     const int default_uid;
     const int default_gid;
     const std::string sshfs_exec_line;
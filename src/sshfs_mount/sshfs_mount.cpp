@@ -30,7 +30,10 @@
 
 #include <QDir>
 #include <QString>
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <string_view>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -43,7 +46,13 @@ const std::string fuse_version_string{"FUSE library version"};
 const std::string ld_library_path_key{"LD_LIBRARY_PATH="};
 const std::string snap_path_key{"SNAP="};
 
-auto get_sshfs_exec_and_options(mp::SSHSession& session)
+// How long sshfs may answer from its own attribute and directory caches, in seconds, when mounts
+// are allowed to cache. sshfs cannot be told about changes on the host, so this is also how late
+// guests may see them. Without caching, a stat storm or tree walk costs one SFTP round trip per
+// entry; with it, one per entry per second at most.
+constexpr auto cache_timeout = 1;
+
+auto get_sshfs_exec_and_options(mp::SSHSession& session, bool cache)
 {
     std::string sshfs_exec;
 
@@ -103,7 +112,13 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
         // The option was made the default in libfuse 3.0
         else if (multipass::opaque_semver{fuse_version_str} < "3.0.0"_semver)
         {
-            sshfs_exec += " -o nonempty -o cache=no";
+            sshfs_exec += " -o nonempty";
+            sshfs_exec += cache ? fmt::format(" -o cache=yes -o cache_timeout={}", cache_timeout)
+                                : " -o cache=no";
+        }
+        else if (cache)
+        {
+            sshfs_exec += fmt::format(" -o dir_cache=yes -o dcache_timeout={}", cache_timeout);
         }
         else
         {
@@ -118,11 +133,28 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
     return sshfs_exec;
 }
 
-auto make_sftp_server(mp::SSHSession&& session,
+int instance_id(mp::SSHSession& session, const std::string& id_command)
+{
+    auto output = MP_UTILS.run_in_ssh_session(session, id_command);
+    mpl::debug(category,
+               "{}:{} {}(): `{}` = {}",
+               __FILE__,
+               __LINE__,
+               __FUNCTION__,
+               id_command,
+               output);
+
+    return std::stoi(output);
+}
+
+// Fills guest_info in when it has to find it out, so that it need not be found out again
+auto make_sftp_server(const std::shared_ptr<mp::SSHSession>& session,
                       const std::string& source,
                       const std::string& target,
                       const mp::id_mappings& gid_mappings,
-                      const mp::id_mappings& uid_mappings)
+                      const mp::id_mappings& uid_mappings,
+                      bool cache,
+                      std::optional<mp::SshfsGuestInfo>& guest_info)
 {
     mpl::debug(category,
                "{}:{} {}(source = {}, target = {}, …): ",
@@ -132,28 +164,25 @@ auto make_sftp_server(mp::SSHSession&& session,
                source,
                target);
 
-    auto sshfs_exec_line = get_sshfs_exec_and_options(session);
+    auto sshfs_exec_line =
+        guest_info ? guest_info->sshfs_exec_line : get_sshfs_exec_and_options(*session, cache);
 
     // Split the path in existing and missing parts.
-    const auto& [leading, missing] = mpu::get_path_split(session, target);
+    const auto& [leading, missing] = mpu::get_path_split(*session, target);
 
-    auto output = MP_UTILS.run_in_ssh_session(session, "id -u");
-    mpl::debug(category, "{}:{} {}(): `id -u` = {}", __FILE__, __LINE__, __FUNCTION__, output);
-    auto default_uid = std::stoi(output);
-
-    output = MP_UTILS.run_in_ssh_session(session, "id -g");
-    mpl::debug(category, "{}:{} {}(): `id -g` = {}", __FILE__, __LINE__, __FUNCTION__, output);
-    auto default_gid = std::stoi(output);
+    auto default_uid = guest_info ? guest_info->default_uid : instance_id(*session, "id -u");
+    auto default_gid = guest_info ? guest_info->default_gid : instance_id(*session, "id -g");
+    guest_info = mp::SshfsGuestInfo{sshfs_exec_line, default_uid, default_gid};
 
     // We need to create the part of the path which does not still exist,
     // and set then the correct ownership.
     if (missing != ".")
     {
-        mpu::make_target_dir(session, leading, missing);
-        mpu::set_owner_for(session, leading, missing, default_uid, default_gid);
+        mpu::make_target_dir(*session, leading, missing);
+        mpu::set_owner_for(*session, leading, missing, default_uid, default_gid);
     }
 
-    return std::make_unique<mp::SftpServer>(std::move(session),
+    return std::make_unique<mp::SftpServer>(session,
                                             source,
                                             leading + missing,
                                             gid_mappings,
@@ -163,26 +192,65 @@ auto make_sftp_server(mp::SSHSession&& session,
                                             sshfs_exec_line);
 }
 
+// Whether sshfs sent anything through channel, or left it. What sshfs writes to stderr is logged
+// and taken out of the way, lest the channel keep waking up the server with nothing to serve.
+bool has_news(ssh_channel channel)
+{
+    std::array<char, 256> buffer;
+    while (ssh_channel_poll(channel, /*is_stderr=*/1) > 0)
+    {
+        const auto read =
+            ssh_channel_read_nonblocking(channel, buffer.data(), buffer.size(), /*is_stderr=*/1);
+        if (read <= 0)
+            break;
+
+        mpl::debug(category, "sshfs: {}", std::string_view{buffer.data(), std::size_t(read)});
+    }
+
+    return ssh_channel_poll(channel, /*is_stderr=*/0) != 0;
+}
+
 } // namespace
 
+mp::SshfsGuestInfo mp::discover_sshfs_guest_info(SSHSession& session, bool cache)
+{
+    auto sshfs_exec_line = get_sshfs_exec_and_options(session, cache);
+    return {sshfs_exec_line, instance_id(session, "id -u"), instance_id(session, "id -g")};
+}
+
 mp::SshfsMount::SshfsMount(SSHSession&& session,
                            const std::string& source,
                            const std::string& target,
                            const mp::id_mappings& gid_mappings,
-                           const mp::id_mappings& uid_mappings)
-    : sftp_server{make_sftp_server(std::move(session), source, target, gid_mappings, uid_mappings)},
-      sftp_thread{[this] {
-          state.store(State::Running, std::memory_order_release);
-
-          mp::top_catch_all(category, [this] {
-              std::cout << "Connected" << std::endl;
-              sftp_server->run();
-              std::cout << "Stopped" << std::endl;
-          });
-
-          state.store(State::Stopped, std::memory_order_release);
-      }}
+                           const mp::id_mappings& uid_mappings,
+                           bool cache,
+                           const std::optional<SshfsGuestInfo>& guest_info)
+    : session{std::make_shared<SSHSession>(std::move(session))},
+      cache{cache},
+      guest_info{guest_info}
 {
+    sftp_servers.emplace(target,
+                         make_sftp_server(this->session,
+                                          source,
+                                          target,
+                                          gid_mappings,
+                                          uid_mappings,
+                                          cache,
+                                          this->guest_info));
+
+    sftp_thread = std::thread{[this] {
+        state.store(State::Running, std::memory_order_release);
+
+        mp::top_catch_all(category, [this] {
+            std::cout << "Connected" << std::endl;
+            serve();
+            std::cout << "Stopped" << std::endl;
+        });
+
+        std::lock_guard lock{mutex};
+        state.store(State::Stopped, std::memory_order_release);
+        requests.clear(); // fails whatever was still waiting to be served
+    }};
 }
 
 mp::SshfsMount::~SshfsMount()
@@ -191,9 +259,56 @@ mp::SshfsMount::~SshfsMount()
     stop();
 }
 
+void mp::SshfsMount::attach(const std::string& source,
+                            const std::string& target,
+                            const mp::id_mappings& gid_mappings,
+                            const mp::id_mappings& uid_mappings)
+{
+    run_on_sftp_thread([&] {
+        if (sftp_servers.count(target))
+            throw std::runtime_error(fmt::format("\"{}\" is already mounted", target));
+
+        auto sftp_server = make_sftp_server(session,
+                                            source,
+                                            target,
+                                            gid_mappings,
+                                            uid_mappings,
+                                            cache,
+                                            guest_info);
+
+        std::lock_guard lock{mutex};
+        sftp_servers.emplace(target, std::move(sftp_server));
+    });
+}
+
+void mp::SshfsMount::detach(const std::string& target)
+{
+    run_on_sftp_thread([this, &target] {
+        auto it = sftp_servers.find(target);
+        if (it == sftp_servers.end())
+            throw std::runtime_error(fmt::format("\"{}\" is not mounted", target));
+
+        // The server leaves the channel alone. Closing it has sshfs quit and unmount.
+        const auto channel = it->second->channel();
+        {
+            std::lock_guard lock{mutex};
+            sftp_servers.erase(it);
+        }
+
+        ssh_channel_close(channel);
+        ssh_channel_free(channel);
+    });
+}
+
 void mp::SshfsMount::stop()
 {
-    sftp_server->stop();
+    stopping = true;
+    {
+        std::lock_guard lock{mutex};
+        for (auto& [target, sftp_server] : sftp_servers)
+            sftp_server->stop();
+    }
+
     if (sftp_thread.joinable())
         sftp_thread.join();
 }
@@ -202,3 +317,73 @@ bool mp::SshfsMount::alive() const
 {
     return state.load(std::memory_order_acquire) != State::Stopped;
 }
+
+void mp::SshfsMount::serve()
+{
+    // Wakes up now and then to take requests, when sshfs has nothing to say
+    constexpr auto request_latency = std::chrono::microseconds{100'000};
+
+    while (true)
+    {
+        std::vector<std::packaged_task<void()>> pending;
+        {
+            std::lock_guard lock{mutex};
+            pending.swap(requests);
+        }
+
+        for (auto& request : pending)
+            request(); // what it throws goes to whoever is waiting on it
+
+        if (stopping || sftp_servers.empty())
+            return;
+
+        std::vector<ssh_channel> channels;
+        for (const auto& [target, sftp_server] : sftp_servers)
+            channels.push_back(sftp_server->channel());
+        channels.push_back(nullptr);
+
+        timeval timeout{0, request_latency.count()};
+        if (ssh_channel_select(channels.data(), nullptr, nullptr, &timeout) == SSH_ERROR)
+            return; // the session is gone, and every mount with it
+
+        // Left with the channels that have something to read, up to the first null
+        const auto ready_end = std::find(channels.begin(), channels.end(), nullptr);
+        for (auto it = sftp_servers.begin(); it != sftp_servers.end();)
+        {
+            const auto& [target, sftp_server] = *it;
+            const auto channel = sftp_server->channel();
+            if (std::find(channels.begin(), ready_end, channel) == ready_end ||
+                !has_news(channel) || sftp_server->serve_one())
+            {
+                ++it;
+                continue;
+            }
+
+            mpl::info(category, "Stopped serving \"{}\"", target);
+            std::lock_guard lock{mutex};
+            it = sftp_servers.erase(it);
+        }
+    }
+}
+
+void mp::SshfsMount::run_on_sftp_thread(std::function<void()> request)
+{
+    std::packaged_task<void()> task{std::move(request)};
+    auto done = task.get_future();
+    {
+        std::lock_guard lock{mutex};
+        if (!alive())
+            throw std::runtime_error("Mounts are not being served anymore");
+
+        requests.push_back(std::move(task));
+    }
+
+    try
+    {
+        done.get();
+    }
+    catch (const std::future_error&) // dropped when the thread stopped
+    {
+        throw std::runtime_error("Mounts stopped being served");
+    }
+}
@@ -18,30 +18,61 @@
 #pragma once
 
 #include <multipass/id_mappings.h>
+#include <multipass/sshfs_server_config.h>
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace multipass
 {
 class SSHSession;
 class SftpServer;
+
+// With cache, the sshfs command line lets sshfs answer from its caches for up to a second
+SshfsGuestInfo discover_sshfs_guest_info(SSHSession& session, bool cache);
+
+// Serves the mounts of an instance over a single SSH session, each through a channel of its own,
+// from a thread of its own. Mounts can be attached and detached while the others are being served.
 class SshfsMount
 {
 public:
+    // Mounts source at target. Without guest_info, it is discovered through the session
     SshfsMount(SSHSession&& session,
                const std::string& source,
                const std::string& target,
                const id_mappings& gid_mappings,
-               const id_mappings& uid_mappings);
+               const id_mappings& uid_mappings,
+               bool cache = false,
+               const std::optional<SshfsGuestInfo>& guest_info = std::nullopt);
     SshfsMount(SshfsMount&& other);
     ~SshfsMount();
 
+    // Mounts another source, blocking until it is being served. Throws if it cannot be.
+    void attach(const std::string& source,
+                const std::string& target,
+                const id_mappings& gid_mappings,
+                const id_mappings& uid_mappings);
+
+    // Stops serving the mount at target, which sshfs then leaves. Throws if there is none.
+    void detach(const std::string& target);
+
     void stop();
 
     [[nodiscard]] bool alive() const;
 
 private:
+    void serve();
+    // libssh is not thread safe, so everything touching the session happens on sftp_thread
+    void run_on_sftp_thread(std::function<void()> request);
+
     enum class State
     {
         Unstarted,
@@ -50,9 +81,15 @@ private:
     };
 
     std::atomic<State> state{State::Unstarted};
-    // sftp_server Doesn't need to be a pointer, but done for now to avoid bringing sftp.h
-    // which has an error with -pedantic.
-    std::unique_ptr<SftpServer> sftp_server;
+    std::atomic_bool stopping{false};
+    std::shared_ptr<SSHSession> session;
+    bool cache;
+    std::optional<SshfsGuestInfo> guest_info; // found out by the first mount, for the others
+    // By target. SftpServer doesn't need to be a pointer, but done for now to avoid bringing sftp.h
+    // which has an error with -pedantic. Only changed on sftp_thread, under mutex for stop().
+    std::map<std::string, std::unique_ptr<SftpServer>> sftp_servers;
+    std::vector<std::packaged_task<void()>> requests;
+    std::mutex mutex; // guards requests, and changes to sftp_servers
     std::thread sftp_thread;
 };
 } // namespace multipass
@@ -15,15 +15,25 @@
  *
  */
 
+#include "sshfs_mount.h"
+
+#include <multipass/constants.h>
 #include <multipass/exceptions/exitless_sshprocess_exceptions.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
+#include <multipass/id_mappings.h>
 #include <multipass/platform.h>
+#include <multipass/process/process.h>
+#include <multipass/settings/settings.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/utils.h>
 
-#include <QCoreApplication>
 #include <QEventLoop>
 #include <QThread>
+#include <QTimer>
+
+#include <exception>
+#include <map>
+#include <vector>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -32,6 +42,7 @@ namespace mpu = multipass::utils;
 namespace
 {
 constexpr auto category = "sshfs-mount-handler";
+constexpr auto process_wait_timeout = std::chrono::milliseconds{5000};
 
 void start_and_block_until_connected(mp::Process* process)
 {
@@ -56,6 +67,53 @@ void start_and_block_until_connected(mp::Process* process)
     QObject::disconnect(running_conn);
 }
 
+QByteArray encode(const std::string& field)
+{
+    return QByteArray::fromStdString(field).toPercentEncoding();
+}
+
+// Sends sshfs_server a request line and waits for its reply, skipping anything else it prints.
+// See sshfs_server.cpp for the requests and replies.
+void request(mp::Process& process,
+             const QByteArray& line,
+             const QByteArray& expected_reply,
+             std::chrono::milliseconds timeout)
+{
+    QByteArray output, reply;
+    QEventLoop event_loop;
+    auto stop_conn =
+        QObject::connect(&process, &mp::Process::finished, &event_loop, &QEventLoop::quit);
+    auto reply_conn =
+        QObject::connect(&process, &mp::Process::ready_read_standard_output, [&] {
+            output += process.read_all_standard_output();
+            for (auto end = output.indexOf('\n'); reply.isEmpty() && end >= 0;
+                 end = output.indexOf('\n'))
+            {
+                const auto printed = output.left(end).trimmed();
+                output.remove(0, end + 1);
+                if (printed == "Connected" || printed == "Detached" || printed.startsWith("Failed"))
+                    reply = printed;
+                else if (!printed.isEmpty())
+                    mpl::debug(category, "sshfs_server: {}", printed);
+            }
+
+            if (!reply.isEmpty())
+                event_loop.quit();
+        });
+    QTimer::singleShot(timeout, &event_loop, &QEventLoop::quit);
+
+    process.write(line + '\n');
+    event_loop.exec();
+
+    QObject::disconnect(stop_conn);
+    QObject::disconnect(reply_conn);
+
+    if (reply.isEmpty())
+        throw std::runtime_error(fmt::format("sshfs_server did not answer \"{}\"", line));
+    if (reply != expected_reply)
+        throw std::runtime_error(reply.toStdString());
+}
+
 bool has_sshfs(const std::string& name, mp::SSHSession& session)
 {
     // Check if snap support is installed in the instance
@@ -112,16 +170,358 @@ catch (const mp::ExitlessSSHProcessException& e)
     mpl::error(category, "Could not install 'multipass-sshfs' in '{}': {}", name, e.what());
     throw mp::SSHFSMissingError();
 }
+
+// Best effort: sshfs_server finds out by itself otherwise
+std::optional<mp::SshfsGuestInfo> discover_guest_info(const std::string& name,
+                                                      mp::SSHSession& session,
+                                                      bool cache)
+try
+{
+    return mp::discover_sshfs_guest_info(session, cache);
+}
+catch (const std::exception& e)
+{
+    mpl::debug(category, "Could not find out how to run sshfs in '{}': {}", name, e.what());
+    return std::nullopt;
+}
 } // namespace
 
 namespace multipass
 {
+std::pair<SSHFSChecks::Result, SSHFSChecks::Check>
+SSHFSChecks::run_once(const std::string& name, const std::function<Result()>& check)
+{
+    std::promise<Result> promise;
+    Check used;
+    bool pending = false;
+    {
+        std::lock_guard lock{mutex};
+        auto [it, inserted] = checks.try_emplace(name);
+        if (inserted)
+            it->second = std::make_shared<const std::shared_future<Result>>(promise.get_future());
+
+        used = it->second;
+        pending = !inserted;
+    }
+
+    if (pending)
+        return {used->get(), used}; // rethrows what the check threw, if anything
+
+    try
+    {
+        auto result = check();
+        promise.set_value(result);
+        return {result, used};
+    }
+    catch (...)
+    {
+        forget(name, used); // so that it is checked again, e.g. after a manual install
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+void SSHFSChecks::forget(const std::string& name, const Check& used)
+{
+    std::lock_guard lock{mutex};
+    if (auto it = checks.find(name); it != checks.end() && it->second == used)
+        checks.erase(it);
+}
+
+// An instance's sshfs_server, on a thread of its own. The process lives there, so that its signals
+// are handled there, whichever thread its mounts come and go from.
+class SSHFSServers::Server
+{
+public:
+    Server()
+    {
+        context.moveToThread(&thread);
+        thread.start();
+    }
+
+    ~Server()
+    {
+        run([this] { process.reset(); });
+        thread.quit();
+        thread.wait();
+    }
+
+    // Runs f on the thread, waiting for it and rethrowing what it throws
+    void run(const std::function<void()>& f)
+    {
+        std::exception_ptr error;
+        QMetaObject::invokeMethod(
+            &context,
+            [&f, &error] {
+                try
+                {
+                    f();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            },
+            Qt::BlockingQueuedConnection);
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void attach(const SSHFSServerConfig& config, std::chrono::milliseconds timeout)
+    {
+        if (!process || !process->running())
+        {
+            start(config);
+            return;
+        }
+
+        if (!sources.try_emplace(config.target_path, config.source_path).second)
+            throw std::runtime_error(fmt::format("\"{}\" is already mounted in '{}'",
+                                                 config.target_path,
+                                                 config.instance));
+
+        try
+        {
+            confine(); // lets sshfs_server into the new source first
+            request(*process,
+                    "attach " + encode(config.source_path) + ' ' + encode(config.target_path) +
+                        ' ' + encode(serialise_id_mappings(config.uid_mappings)) + ' ' +
+                        encode(serialise_id_mappings(config.gid_mappings)),
+                    "Connected",
+                    timeout);
+        }
+        catch (...)
+        {
+            sources.erase(config.target_path);
+            confine();
+            throw;
+        }
+    }
+
+    void detach(const std::string& instance, const std::string& target, bool force)
+    {
+        if (!sources.count(target))
+            return;
+
+        if (sources.size() == 1)
+        {
+            stop(instance, force);
+            sources.clear();
+            return;
+        }
+
+        try
+        {
+            if (process->running())
+                request(*process, "detach " + encode(target), "Detached", process_wait_timeout);
+        }
+        catch (const std::exception& e)
+        {
+            if (!force)
+                throw;
+
+            // Once out of the profile, sshfs_server cannot serve it anyway
+            mpl::warn(category,
+                      "Failed to stop mount \"{}\" in instance '{}' gracefully: {}",
+                      target,
+                      instance,
+                      e.what());
+        }
+
+        sources.erase(target);
+        confine();
+    }
+
+    std::mutex mutex;    // for one mount to come or go at a time
+    bool retired{false}; // no longer among the servers, since its last mount went
+
+    // Only touched on the thread
+    std::unique_ptr<Process> process;
+    std::map<std::string, std::string> sources; // by target
+
+private:
+    void start(const SSHFSServerConfig& config)
+    {
+        sources = {{config.target_path, config.source_path}};
+        *source_paths = {config.source_path};
+
+        auto server_config = config;
+        server_config.source_paths = source_paths;
+        process = platform::make_sshfs_server_process(server_config);
+
+        auto log_finished = [instance = config.instance](const ProcessState& exit_state) {
+            if (exit_state.completed_successfully())
+            {
+                mpl::info(category, "Mounts in instance '{}' have stopped", instance);
+            }
+            else
+            {
+                // not error as it failing can indicate we need to install sshfs in the VM
+                mpl::warn(category,
+                          "Mounts in instance '{}' have stopped unsuccessfully: {}",
+                          instance,
+                          exit_state.failure_message());
+            }
+        };
+        auto log_error = [instance = config.instance](auto error, auto error_string) {
+            mpl::error(category,
+                       "There was an error with sshfs_server for instance '{}': {} - {}",
+                       instance,
+                       mpu::qenum_to_string(error),
+                       error_string);
+        };
+        QObject::connect(process.get(), &Process::finished, log_finished);
+        QObject::connect(process.get(), &Process::error_occurred, log_error);
+
+        mpl::info(category, "process program '{}'", process->program());
+        mpl::info(category, "process arguments '{}'", process->arguments().join(", "));
+
+        start_and_block_until_connected(process.get());
+
+        // Check in case sshfs_server stopped, usually due to an error
+        const auto process_state = process->process_state();
+        if (process_state.exit_code == 9) // Magic number returned by sshfs_server
+        {
+            process.reset();
+            sources.clear();
+            throw SSHFSMissingError();
+        }
+        else if (process_state.exit_code || process_state.error)
+        {
+            const auto error = fmt::format("{}: {}",
+                                           process_state.failure_message(),
+                                           process->read_all_standard_error());
+            process.reset();
+            sources.clear();
+            throw std::runtime_error(error);
+        }
+    }
+
+    void stop(const std::string& instance, bool force)
+    {
+        QObject::disconnect(process.get(), &Process::error_occurred, nullptr, nullptr);
+
+        if (process->terminate(); !process->wait_for_finished(process_wait_timeout.count()))
+        {
+            auto fetch_stderr = [](Process& process) {
+                return fmt::format("Failed to terminate SSHFS mount process gracefully: {}",
+                                   process.read_all_standard_error());
+            };
+
+            const auto err = fetch_stderr(*process);
+
+            if (force)
+            {
+                mpl::warn(category,
+                          "Failed to gracefully stop mounts in instance '{}': {}, trying to stop "
+                          "them forcefully.",
+                          instance,
+                          err);
+                /**
+                 * Let's try brute force this time.
+                 */
+                process->kill();
+                const auto result = process->wait_for_finished(process_wait_timeout.count());
+
+                mpl::warn(category,
+                          "{} to forcefully stop mounts in instance '{}': {}",
+                          result ? "Succeeded" : "Failed",
+                          instance,
+                          result ? "" : fetch_stderr(*process));
+            }
+            else
+                throw std::runtime_error{err};
+        }
+
+        process.reset();
+    }
+
+    // Narrows or widens the AppArmor profile of sshfs_server to the sources it serves
+    void confine()
+    {
+        source_paths->clear();
+        for (const auto& [target, source] : sources)
+            source_paths->push_back(source);
+
+        process->reload_apparmor_profile();
+    }
+
+    const std::shared_ptr<std::vector<std::string>> source_paths =
+        std::make_shared<std::vector<std::string>>(); // seen by the process spec
+
+    QThread thread;
+    QObject context; // for running things on the thread
+};
+
+void SSHFSServers::attach(const SSHFSServerConfig& config, std::chrono::milliseconds timeout)
+{
+    while (true)
+    {
+        const auto server = server_for(config.instance);
+        std::lock_guard lock{server->mutex};
+        if (server->retired)
+            continue; // lost the race against its last mount going, so get a new one
+
+        try
+        {
+            server->run([&server, &config, timeout] { server->attach(config, timeout); });
+        }
+        catch (...)
+        {
+            if (server->sources.empty())
+                retire(config.instance, server);
+            throw;
+        }
+
+        return;
+    }
+}
+
+void SSHFSServers::detach(const std::string& instance, const std::string& target, bool force)
+{
+    std::shared_ptr<Server> server;
+    {
+        std::lock_guard lock{mutex};
+        if (auto it = servers.find(instance); it != servers.end())
+            server = it->second;
+    }
+
+    if (!server)
+        return;
+
+    std::lock_guard lock{server->mutex};
+    server->run([&server, &instance, &target, force] { server->detach(instance, target, force); });
+    if (server->sources.empty())
+        retire(instance, server);
+}
+
+std::shared_ptr<SSHFSServers::Server> SSHFSServers::server_for(const std::string& instance)
+{
+    std::lock_guard lock{mutex};
+    auto& server = servers[instance];
+    if (!server)
+        server = std::make_shared<Server>();
+
+    return server;
+}
+
+void SSHFSServers::retire(const std::string& instance, const std::shared_ptr<Server>& server)
+{
+    server->retired = true;
+
+    std::lock_guard lock{mutex};
+    if (auto it = servers.find(instance); it != servers.end() && it->second == server)
+        servers.erase(it);
+}
+
 SSHFSMountHandler::SSHFSMountHandler(VirtualMachine* vm,
                                      const SSHKeyProvider* ssh_key_provider,
                                      const std::string& target,
-                                     VMMount mount_spec)
+                                     VMMount mount_spec,
+                                     SSHFSChecks& sshfs_checks,
+                                     SSHFSServers& sshfs_servers)
     : MountHandler{vm, ssh_key_provider, std::move(mount_spec), target},
-      process{nullptr},
       config{"",
              0,
              vm->ssh_username(),
@@ -130,7 +530,9 @@ SSHFSMountHandler::SSHFSMountHandler(VirtualMachine* vm,
              source,
              target,
              this->mount_spec.get_gid_mappings(),
-             this->mount_spec.get_uid_mappings()}
+             this->mount_spec.get_uid_mappings()},
+      sshfs_checks{sshfs_checks},
+      sshfs_servers{sshfs_servers}
 {
     mpl::info(category,
               "initializing mount {} => {} in '{}'",
@@ -140,126 +542,60 @@ SSHFSMountHandler::SSHFSMountHandler(VirtualMachine* vm,
 }
 
 void SSHFSMountHandler::activate_impl(ServerVariant server, std::chrono::milliseconds timeout)
+try
 {
-    SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm->ssh_username(), *ssh_key_provider};
-    if (!has_sshfs(vm->get_name(), session))
+    // Changing settings restarts the daemon, so all the mounts sharing a check agree on this
+    config.cache = MP_SETTINGS.get_as<bool>(mount_caching_key);
+
+    const auto [guest_info, check] = sshfs_checks.run_once(vm->get_name(), [this, server, timeout] {
+        SSHSession session{vm->ssh_hostname(),
+                           vm->ssh_port(),
+                           vm->ssh_username(),
+                           *ssh_key_provider};
+        if (!has_sshfs(vm->get_name(), session))
+        {
+            auto visitor = [](auto server) {
+                if (server)
+                {
+                    auto reply = make_reply_from_server(server);
+                    reply.set_reply_message("Enabling support for mounting");
+                    server->Write(reply);
+                }
+            };
+            std::visit(visitor, server);
+            install_sshfs_for(vm->get_name(), session, timeout);
+        }
+
+        return discover_guest_info(vm->get_name(), session, config.cache);
+    });
+    sshfs_check = check;
+
+    if (guest_info)
     {
-        auto visitor = [](auto server) {
-            if (server)
-            {
-                auto reply = make_reply_from_server(server);
-                reply.set_reply_message("Enabling support for mounting");
-                server->Write(reply);
-            }
-        };
-        std::visit(visitor, server);
-        install_sshfs_for(vm->get_name(), session, timeout);
+        config.sshfs_exec_line = guest_info->sshfs_exec_line;
+        config.instance_uid = guest_info->default_uid;
+        config.instance_gid = guest_info->default_gid;
     }
 
     // Can't obtain hostname/IP address until instance is running
     config.host = vm->ssh_hostname();
     config.port = vm->ssh_port();
 
-    process.reset(platform::make_sshfs_server_process(config).release());
-
-    QObject::connect(process.get(), &Process::finished, [this](const ProcessState& exit_state) {
-        if (exit_state.completed_successfully())
-        {
-            mpl::info(category,
-                      "Mount \"{}\" in instance '{}' has stopped",
-                      target,
-                      vm->get_name());
-        }
-        else
-        {
-            // not error as it failing can indicate we need to install sshfs in the VM
-            mpl::warn(category,
-                      "Mount \"{}\" in instance '{}' has stopped unsuccessfully: {}",
-                      target,
-                      vm->get_name(),
-                      exit_state.failure_message());
-        }
-    });
-    QObject::connect(
-        process.get(),
-        &Process::error_occurred,
-        [this](auto error, auto error_string) {
-            mpl::error(
-                category,
-                "There was an error with sshfs_server for instance '{}' with path \"{}\": {} - {}",
-                vm->get_name(),
-                target,
-                mpu::qenum_to_string(error),
-                error_string);
-        });
-
-    mpl::info(category, "process program '{}'", process->program());
-    mpl::info(category, "process arguments '{}'", process->arguments().join(", "));
-
-    start_and_block_until_connected(process.get());
-    // after the process is started, it must be moved to the main thread
-    // when starting an instance that already has mounts defined, it is started in a thread from the
-    // global thread pool this makes the sshfs_server process to be owned by that thread when
-    // stopping the mount from the main thread again, qt will try to send an event from the main
-    // thread to the one in which the process lives this will result in an error since qt can't send
-    // events from one thread to another
-    process->moveToThread(QCoreApplication::instance()->thread());
-    // So, for any future travelers, this^ is the main reason why we use qt_delete_later_unique_ptr
-    // thingy.
-
-    // Check in case sshfs_server stopped, usually due to an error
-    const auto process_state = process->process_state();
-    if (process_state.exit_code == 9) // Magic number returned by sshfs_server
-        throw SSHFSMissingError();
-    else if (process_state.exit_code || process_state.error)
-        throw std::runtime_error(fmt::format("{}: {}",
-                                             process_state.failure_message(),
-                                             process->read_all_standard_error()));
+    sshfs_servers.attach(config, timeout);
+}
+catch (...)
+{
+    // sshfs_server may have found sshfs missing after all, or the instance may be going away
+    sshfs_checks.forget(vm->get_name(), sshfs_check);
+    throw;
 }
 
 void SSHFSMountHandler::deactivate_impl(bool force)
 {
     mpl::info(category, "Stopping mount \"{}\" in instance '{}'", target, vm->get_name());
-    QObject::disconnect(process.get(), &Process::error_occurred, nullptr, nullptr);
-
-    constexpr auto process_wait_timeout = std::chrono::milliseconds{5000};
-    if (process->terminate(); !process->wait_for_finished(process_wait_timeout.count()))
-    {
-        auto fetch_stderr = [](Process& process) {
-            return fmt::format("Failed to terminate SSHFS mount process gracefully: {}",
-                               process.read_all_standard_error());
-        };
-
-        const auto err = fetch_stderr(*process.get());
-
-        if (force)
-        {
-            mpl::warn(category,
-                      "Failed to gracefully stop mount \"{}\" in instance '{}': {}, trying to stop "
-                      "it forcefully.",
-                      target,
-                      vm->get_name(),
-                      err);
-            /**
-             * Let's try brute force this time.
-             */
-            process->kill();
-            const auto result = process->wait_for_finished(process_wait_timeout.count());
-
-            mpl::warn(category,
-                      "{} to forcefully stop mount \"{}\" in instance '{}': {}",
-                      result ? "Succeeded" : "Failed",
-                      target,
-                      vm->get_name(),
-                      result ? "" : fetch_stderr(*process.get()));
-        }
-        else
-            throw std::runtime_error{err};
-    }
-
-    // Finally, call reset() to disconnect all the signals and defer the deletion
-    // to the owning thread, in this case it's the QT main.
-    process.reset();
+    // mounts are stopped whenever the instance stops
+    sshfs_checks.forget(vm->get_name(), sshfs_check);
+    sshfs_servers.detach(vm->get_name(), target, force);
 }
 
 SSHFSMountHandler::~SSHFSMountHandler()
@@ -15,15 +15,21 @@
  *
  */
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include <QByteArray>
 #include <QStringList>
 
 #include "sshfs_mount.h"
 
 #include <multipass/exceptions/sshfs_missing_error.h>
+#include <multipass/format.h>
 #include <multipass/id_mappings.h>
 #include <multipass/logging/log.h>
 #include <multipass/logging/multiplexing_logger.h>
@@ -69,6 +75,50 @@ mp::id_mappings convert_id_mappings(const char* in)
 
     return ret_map;
 }
+
+void reply(const std::string& line)
+{
+    cout << line + '\n' << flush; // in one go, so that it does not mingle with other output
+}
+
+// Mounts other than the first are attached and detached through stdin, a request per line, its
+// fields percent-encoded: "attach <source> <target> <uid mappings> <gid mappings>" or
+// "detach <target>". Each gets a line in reply: "Connected", "Detached" or "Failed: <reason>".
+void serve_requests(mp::SshfsMount& sshfs_mount)
+{
+    string line;
+    while (getline(cin, line))
+    {
+        vector<string> fields;
+        for (const auto& field : QByteArray::fromStdString(line).split(' '))
+            fields.push_back(QByteArray::fromPercentEncoding(field).toStdString());
+
+        try
+        {
+            if (fields.size() == 5 && fields[0] == "attach")
+            {
+                sshfs_mount.attach(fields[1],
+                                   fields[2],
+                                   convert_id_mappings(fields[4].c_str()),
+                                   convert_id_mappings(fields[3].c_str()));
+                reply("Connected");
+            }
+            else if (fields.size() == 2 && fields[0] == "detach")
+            {
+                sshfs_mount.detach(fields[1]);
+                reply("Detached");
+            }
+            else
+                throw runtime_error(fmt::format("Unknown request: {}", line));
+        }
+        catch (const exception& e)
+        {
+            auto reason = string{e.what()};
+            replace(reason.begin(), reason.end(), '\n', ' ');
+            reply(fmt::format("Failed: {}", reason));
+        }
+    }
+}
 } // namespace
 
 int main(int argc, char* argv[])
@@ -94,6 +144,14 @@ int main(int argc, char* argv[])
     const mp::id_mappings uid_mappings = convert_id_mappings(argv[6]);
     const mp::id_mappings gid_mappings = convert_id_mappings(argv[7]);
     const mpl::Level log_level = static_cast<mpl::Level>(atoi(argv[8]));
+    const bool cache = qEnvironmentVariableIntValue("SSHFS_CACHE") != 0;
+
+    // Provided when the daemon already knows, so that each mount need not find out again
+    std::optional<mp::SshfsGuestInfo> guest_info;
+    if (const auto sshfs_exec_line = qgetenv("SSHFS_EXEC"); !sshfs_exec_line.isEmpty())
+        guest_info = mp::SshfsGuestInfo{sshfs_exec_line.toStdString(),
+                                        qEnvironmentVariableIntValue("INSTANCE_UID"),
+                                        qEnvironmentVariableIntValue("INSTANCE_GID")};
 
     auto logger = mpp::make_logger(log_level);
     if (!logger)
@@ -115,7 +173,12 @@ int main(int argc, char* argv[])
                                    source_path,
                                    target_path,
                                    gid_mappings,
-                                   uid_mappings);
+                                   uid_mappings,
+                                   cache,
+                                   guest_info);
+
+        // Blocks on stdin for good, so it is left behind when the process exits
+        std::thread{[&sshfs_mount] { serve_requests(sshfs_mount); }}.detach();
 
         // ssh lives on its own thread, use this thread to listen for quit signal
         auto sig = watchdog([&sshfs_mount] { return sshfs_mount.alive(); });
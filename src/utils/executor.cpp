@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/executor.h>
+#include <multipass/logging/log.h>
+
+#include <QDeadlineTimer>
+#include <QThread>
+
+#include <algorithm>
+#include <utility>
+
+namespace mp = multipass;
+namespace mpl = mp::logging;
+
+namespace
+{
+constexpr auto category = "executor";
+
+// Blocking tasks mostly sleep (waiting on instances to boot, on processes, on the network), so
+// they get many more threads than there are cores
+constexpr auto min_blocking_threads = 64;
+
+std::size_t index_of(mp::Lane lane)
+{
+    return static_cast<std::size_t>(lane);
+}
+
+const char* name_of(mp::Lane lane)
+{
+    return lane == mp::Lane::cpu ? "cpu" : "blocking";
+}
+
+thread_local std::optional<mp::Lane> running_lane;
+
+void update_max(std::atomic<std::int64_t>& max, std::int64_t value)
+{
+    auto current = max.load(std::memory_order_relaxed);
+    while (current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        ;
+}
+} // namespace
+
+mp::Executor::Executor(const Singleton<Executor>::PrivatePass& pass) : Singleton<Executor>{pass}
+{
+    const auto cores = QThread::idealThreadCount();
+    for (auto lane : {Lane::cpu, Lane::blocking})
+    {
+        auto& pool = state_of(lane).pool;
+        pool.setMaxThreadCount(lane == Lane::cpu ? cores : std::max(min_blocking_threads, cores));
+        pool.setObjectName(QString{"%1 executor lane"}.arg(name_of(lane)));
+    }
+}
+
+std::optional<mp::Lane> mp::Executor::current_lane()
+{
+    return running_lane;
+}
+
+auto mp::Executor::stats(Lane lane) const -> LaneStats
+{
+    const auto& state = lanes[index_of(lane)];
+    return {state.pool.maxThreadCount(),
+            state.queued.load(std::memory_order_relaxed),
+            state.running.load(std::memory_order_relaxed),
+            state.completed.load(std::memory_order_relaxed),
+            std::chrono::microseconds{state.total_queue_wait_us.load(std::memory_order_relaxed)},
+            std::chrono::microseconds{state.max_queue_wait_us.load(std::memory_order_relaxed)}};
+}
+
+bool mp::Executor::wait_for_done(std::chrono::milliseconds timeout)
+{
+    QDeadlineTimer deadline{timeout};
+    for (auto& state : lanes)
+        if (!state.pool.waitForDone(static_cast<int>(deadline.remainingTime())))
+            return false;
+
+    return true;
+}
+
+auto mp::Executor::state_of(Lane lane) -> LaneState&
+{
+    return lanes[index_of(lane)];
+}
+
+// Queueing is expected now and then, but worth knowing about when things are slow
+void mp::Executor::warn_if_saturated(Lane lane)
+{
+    const auto& pool = state_of(lane).pool;
+    if (const auto active = pool.activeThreadCount(); active >= pool.maxThreadCount())
+        mpl::warn(category,
+                  "All {} threads of the {} lane are busy, further tasks will be queued",
+                  active,
+                  name_of(lane));
+}
+
+mp::Executor::Pending::Pending(LaneState& state, Lane lane)
+    : state{state}, lane{lane}, submitted{std::chrono::steady_clock::now()}
+{
+    state.queued.fetch_add(1, std::memory_order_relaxed);
+}
+
+mp::Executor::Pending::~Pending()
+{
+    if (!started) // dropped while queued
+        state.queued.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto mp::Executor::Pending::start() -> Running
+{
+    using namespace std::chrono;
+    const auto waited = duration_cast<microseconds>(steady_clock::now() - submitted).count();
+
+    started = true;
+    state.queued.fetch_sub(1, std::memory_order_relaxed);
+    state.running.fetch_add(1, std::memory_order_relaxed);
+    state.total_queue_wait_us.fetch_add(waited, std::memory_order_relaxed);
+    update_max(state.max_queue_wait_us, waited);
+
+    // Waiting on a task that is still queued can run it right in the waiting thread
+    return Running{state, std::exchange(running_lane, lane)};
+}
+
+mp::Executor::Pending::Running::~Running()
+{
+    running_lane = outer_lane;
+    state.running.fetch_sub(1, std::memory_order_relaxed);
+    state.completed.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/format.h>
+#include <multipass/metrics.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace mp = multipass;
+
+namespace
+{
+std::string escape(std::string_view label_value)
+{
+    std::string escaped;
+    for (auto c : label_value)
+    {
+        if (c == '\\' || c == '"')
+            escaped += '\\';
+        escaped += c == '\n' ? std::string{"\\n"} : std::string{c};
+    }
+
+    return escaped;
+}
+
+void append_header(std::string& out,
+                   std::string_view name,
+                   std::string_view type,
+                   std::string_view help)
+{
+    fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+}
+
+void append_counter(std::string& out,
+                    std::string_view name,
+                    std::string_view help,
+                    const mp::Counter& counter)
+{
+    append_header(out, name, "counter", help);
+    fmt::format_to(std::back_inserter(out), "{} {}\n", name, counter.value());
+}
+
+void append_counters(std::string& out,
+                     std::string_view name,
+                     std::string_view help,
+                     std::string_view label,
+                     const mp::Labelled<mp::Counter>& counters)
+{
+    append_header(out, name, "counter", help);
+    counters.for_each([&](const std::string& label_value, const mp::Counter& counter) {
+        fmt::format_to(std::back_inserter(out),
+                       "{}{{{}=\"{}\"}} {}\n",
+                       name,
+                       label,
+                       escape(label_value),
+                       counter.value());
+    });
+}
+
+void append_histograms(std::string& out,
+                       std::string_view name,
+                       std::string_view help,
+                       std::string_view label,
+                       const mp::Labelled<mp::Histogram>& histograms)
+{
+    append_header(out, name, "histogram", help);
+    histograms.for_each([&](const std::string& label_value, const mp::Histogram& histogram) {
+        const auto labels = fmt::format("{}=\"{}\"", label, escape(label_value));
+        const auto counts = histogram.bucket_counts();
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i)
+        {
+            cumulative += counts[i];
+            const auto le = i < mp::Histogram::bounds.size()
+                                ? fmt::format("{}", mp::Histogram::bounds[i])
+                                : std::string{"+Inf"};
+            fmt::format_to(std::back_inserter(out),
+                           "{}_bucket{{{},le=\"{}\"}} {}\n",
+                           name,
+                           labels,
+                           le,
+                           cumulative);
+        }
+
+        fmt::format_to(std::back_inserter(out), "{}_sum{{{}}} {}\n", name, labels, histogram.sum());
+        fmt::format_to(std::back_inserter(out), "{}_count{{{}}} {}\n", name, labels, cumulative);
+    });
+}
+
+void append_samples(std::string& out,
+                    std::string_view name,
+                    std::string_view type,
+                    std::string_view help,
+                    const std::vector<std::pair<std::string, double>>& samples)
+{
+    append_header(out, name, type, help);
+    for (const auto& [labels, value] : samples)
+    {
+        if (labels.empty())
+            fmt::format_to(std::back_inserter(out), "{} {}\n", name, value);
+        else
+            fmt::format_to(std::back_inserter(out), "{}{{{}}} {}\n", name, labels, value);
+    }
+}
+} // namespace
+
+void mp::Histogram::observe(std::chrono::steady_clock::duration duration) noexcept
+{
+    const auto seconds = std::chrono::duration<double>{duration}.count();
+    const auto bucket = std::lower_bound(bounds.begin(), bounds.end(), seconds) - bounds.begin();
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(),
+                     std::memory_order_relaxed);
+}
+
+auto mp::Histogram::bucket_counts() const noexcept -> std::array<std::uint64_t, bounds.size() + 1>
+{
+    std::array<std::uint64_t, bounds.size() + 1> counts{};
+    for (std::size_t i = 0; i < counts.size(); ++i)
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+
+    return counts;
+}
+
+std::uint64_t mp::Histogram::count() const noexcept
+{
+    const auto counts = bucket_counts();
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+}
+
+double mp::Histogram::sum() const noexcept
+{
+    return static_cast<double>(sum_us.load(std::memory_order_relaxed)) / 1e6;
+}
+
+mp::Metrics::Metrics(const Singleton<Metrics>::PrivatePass& pass) noexcept
+    : Singleton<Metrics>::Singleton{pass}
+{
+}
+
+std::string mp::Metrics::to_prometheus() const
+{
+    std::string out;
+
+    append_histograms(out,
+                      "multipass_rpc_duration_seconds",
+                      "Time taken to serve gRPC requests, by RPC.",
+                      "rpc",
+                      rpc_durations);
+    append_counters(out,
+                    "multipass_instance_operations_total",
+                    "Instances launched, started and stopped.",
+                    "operation",
+                    instance_operations);
+    append_histograms(out,
+                      "multipass_instance_operation_duration_seconds",
+                      "Time taken to launch, start and stop instances, by operation.",
+                      "operation",
+                      instance_operation_durations);
+    append_counter(out,
+                   "multipass_downloaded_bytes_total",
+                   "Bytes downloaded, for images and their metadata.",
+                   downloaded_bytes);
+    append_counter(out,
+                   "multipass_image_vault_hits_total",
+                   "Image fetches served from the vault.",
+                   image_vault_hits);
+    append_counter(out,
+                   "multipass_image_vault_misses_total",
+                   "Image fetches that needed a download.",
+                   image_vault_misses);
+    append_counter(out,
+                   "multipass_ssh_execs_total",
+                   "Commands run in instances over SSH.",
+                   ssh_execs);
+
+    return out;
+}
+
+void mp::append_prometheus_gauge(std::string& out,
+                                 std::string_view name,
+                                 std::string_view help,
+                                 const std::vector<std::pair<std::string, double>>& samples)
+{
+    append_samples(out, name, "gauge", help, samples);
+}
+
+void mp::append_prometheus_counter(std::string& out,
+                                   std::string_view name,
+                                   std::string_view help,
+                                   const std::vector<std::pair<std::string, double>>& samples)
+{
+    append_samples(out, name, "counter", help, samples);
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/format.h>
+#include <multipass/tracing.h>
+#include <multipass/utils.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+
+namespace mp = multipass;
+
+namespace
+{
+using namespace std::chrono;
+
+constexpr auto max_kept_traces = 50;
+
+thread_local std::string scope_instance;
+
+qint64 in_micros(steady_clock::duration elapsed)
+{
+    return duration_cast<microseconds>(elapsed).count();
+}
+
+double in_seconds(steady_clock::duration elapsed)
+{
+    return duration_cast<duration<double>>(elapsed).count();
+}
+
+QDateTime date_time_of(system_clock::time_point time)
+{
+    return QDateTime::fromMSecsSinceEpoch(
+        duration_cast<milliseconds>(time.time_since_epoch()).count());
+}
+
+// Spans that start together are ordered outermost first
+std::vector<mp::Trace::Span> by_start(std::vector<mp::Trace::Span> spans)
+{
+    std::sort(spans.begin(), spans.end(), [](const auto& a, const auto& b) {
+        return a.start < b.start || (a.start == b.start && a.duration > b.duration);
+    });
+    return spans;
+}
+} // namespace
+
+mp::Tracer::Tracer(const Singleton<Tracer>::PrivatePass& pass) noexcept
+    : Singleton<Tracer>::Singleton{pass}
+{
+}
+
+void mp::Tracer::begin(const std::string& instance, const std::string& operation)
+{
+    std::lock_guard lock{mutex};
+    traces[instance] = Trace{instance, operation, system_clock::now(), steady_clock::now()};
+}
+
+std::optional<mp::Trace> mp::Tracer::end(const std::string& instance)
+{
+    std::lock_guard lock{mutex};
+
+    auto node = traces.extract(instance);
+    if (node.empty())
+        return std::nullopt;
+
+    auto& trace = node.mapped();
+    trace.duration = steady_clock::now() - trace.start;
+    return std::move(trace);
+}
+
+void mp::Tracer::record(const std::string& instance,
+                        const std::string& stage,
+                        steady_clock::time_point start,
+                        steady_clock::time_point finish)
+{
+    std::lock_guard lock{mutex};
+    if (auto it = traces.find(instance); it != traces.end())
+        it->second.spans.push_back({stage, start, finish - start, std::this_thread::get_id()});
+}
+
+mp::TraceScope::TraceScope(std::string instance)
+    : previous{std::exchange(scope_instance, std::move(instance))}
+{
+}
+
+mp::TraceScope::~TraceScope()
+{
+    scope_instance = std::move(previous);
+}
+
+const std::string& mp::TraceScope::current()
+{
+    return scope_instance;
+}
+
+mp::TraceSpan::TraceSpan(std::string stage) : TraceSpan{TraceScope::current(), std::move(stage)}
+{
+}
+
+mp::TraceSpan::TraceSpan(std::string instance, std::string stage)
+    : instance{std::move(instance)}, stage{std::move(stage)}, start{steady_clock::now()}
+{
+}
+
+mp::TraceSpan::~TraceSpan()
+{
+    if (instance.empty())
+        return;
+
+    try
+    {
+        MP_TRACER.record(instance, stage, start, steady_clock::now());
+    }
+    catch (...)
+    {
+        // losing a span is no reason to bring the daemon down
+    }
+}
+
+std::string mp::to_chrome_trace(const Trace& trace)
+{
+    const auto instance = QString::fromStdString(trace.instance);
+    const auto operation = QString::fromStdString(trace.operation);
+
+    auto event = [&](const std::string& name, qint64 ts, qint64 dur, int tid) {
+        return QJsonObject{{"name", QString::fromStdString(name)},
+                           {"cat", operation},
+                           {"ph", "X"},
+                           {"ts", ts},
+                           {"dur", dur},
+                           {"pid", 1},
+                           {"tid", tid},
+                           {"args", QJsonObject{{"instance", instance}}}};
+    };
+
+    // Threads get small ids, in the order they show up
+    std::map<std::thread::id, int> tids;
+    QJsonArray events{event(trace.operation, 0, in_micros(trace.duration), 0)};
+    for (const auto& span : by_start(trace.spans))
+    {
+        const auto tid = tids.try_emplace(span.thread, static_cast<int>(tids.size()) + 1).first;
+        events.append(event(span.stage,
+                            in_micros(span.start - trace.start),
+                            in_micros(span.duration),
+                            tid->second));
+    }
+
+    const auto started_at = date_time_of(trace.started_at);
+
+    return QJsonDocument{
+        QJsonObject{{"traceEvents", events},
+                    {"displayTimeUnit", "ms"},
+                    {"otherData",
+                     QJsonObject{{"instance", instance},
+                                 {"operation", operation},
+                                 {"started_at", started_at.toString(Qt::ISODateWithMs)}}}}}
+        .toJson(QJsonDocument::Compact)
+        .toStdString();
+}
+
+QString mp::write_chrome_trace(const Trace& trace, const QString& dir)
+{
+    const auto started_at = date_time_of(trace.started_at);
+    const auto path = QDir{dir}.filePath(QString{"%1-%2-%3.json"}.arg(
+        QString::fromStdString(trace.instance),
+        QString::fromStdString(trace.operation),
+        started_at.toString("yyyyMMdd-hhmmsszzz")));
+
+    MP_UTILS.make_file_with_content(path.toStdString(), to_chrome_trace(trace), true);
+
+    const auto kept = QDir{dir}.entryInfoList({"*.json"}, QDir::Files, QDir::Time);
+    for (auto i = max_kept_traces; i < kept.size(); ++i)
+        QFile::remove(kept[i].filePath());
+
+    return path;
+}
+
+std::string mp::summary_of(const Trace& trace)
+{
+    const auto spans = by_start(trace.spans);
+
+    auto summary = fmt::memory_buffer{};
+    fmt::format_to(std::back_inserter(summary),
+                   "Time spent in the {} of {}:\n",
+                   trace.operation,
+                   trace.instance);
+
+    for (auto it = spans.begin(); it != spans.end(); ++it)
+    {
+        // Stages that others were in the middle of are indented under them
+        const auto depth = std::count_if(spans.begin(), it, [&it](const auto& outer) {
+            return outer.start + outer.duration >= it->start + it->duration;
+        });
+        const auto label = std::string(2 * (depth + 1), ' ') + it->stage;
+        fmt::format_to(std::back_inserter(summary),
+                       "{:<32}{:>9.3f}s\n",
+                       label,
+                       in_seconds(it->duration));
+    }
+
+    fmt::format_to(std::back_inserter(summary),
+                   "{:<32}{:>9.3f}s\n",
+                   "  total",
+                   in_seconds(trace.duration));
+
+    return fmt::to_string(summary);
+}
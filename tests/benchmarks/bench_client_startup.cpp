@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "mock_cert_provider.h"
+#include "mock_utils.h"
+#include "stub_terminal.h"
+
+#include <src/client/cli/client.h>
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+namespace
+{
+constexpr auto server_address = "unix:/tmp/multipass_benchmark_socket";
+
+// Measures the fixed cost every short-lived `multipass` invocation pays before (and regardless of)
+// talking to the daemon.
+struct ClientStartup
+{
+    ClientStartup()
+    {
+        ON_CALL(*mock_utils, contents_of).WillByDefault(testing::Return(mpt::root_cert));
+    }
+
+    mp::ClientConfig make_config()
+    {
+        return mp::ClientConfig{server_address,
+                                std::make_unique<testing::NiceMock<mpt::MockCertProvider>>(),
+                                &term};
+    }
+
+    std::stringstream out, err;
+    std::istringstream in;
+    mpt::StubTerminal term{out, err, in};
+    mpt::MockUtils::GuardedMock attr{mpt::MockUtils::inject<testing::NiceMock>()};
+    mpt::MockUtils* mock_utils = attr.first;
+};
+
+void BM_ClientConstruction(benchmark::State& state)
+{
+    ClientStartup startup;
+
+    for (auto _ : state)
+    {
+        auto config = startup.make_config();
+        mp::Client client{config};
+        benchmark::DoNotOptimize(client);
+    }
+}
+BENCHMARK(BM_ClientConstruction);
+
+void BM_ClientRunLocalCommand(benchmark::State& state)
+{
+    ClientStartup startup;
+    const auto args = QStringList{"multipass", "help", "launch"};
+
+    for (auto _ : state)
+    {
+        auto config = startup.make_config();
+        mp::Client client{config};
+        benchmark::DoNotOptimize(client.run(args));
+
+        startup.out.str({});
+    }
+}
+BENCHMARK(BM_ClientRunLocalCommand);
+} // namespace
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <multipass/cloud_init_iso.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QTemporaryDir>
+
+#include <filesystem>
+#include <string>
+
+namespace mp = multipass;
+
+namespace
+{
+// The seed ISO every launch writes and every clone, network change and rename rewrites. User data
+// is usually the bulk of it, so that is what the argument scales.
+mp::CloudInitIso make_iso(std::size_t user_data_size)
+{
+    std::string user_data{"#cloud-config\n"};
+    while (user_data.size() < user_data_size)
+        user_data += "runcmd:\n"
+                     "  - [ sh, -c, 'echo provisioning step >> /var/log/provision.log' ]\n";
+
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "#cloud-config\ninstance-id: instance-0001\nlocal-hostname: host\n");
+    iso.add_file("vendor-data", "#cloud-config\ngrowpart: {mode: auto, devices: [/]}\n");
+    iso.add_file("user-data", user_data);
+    iso.add_file("network-config",
+                 "#cloud-config\nversion: 2\nethernets:\n  default:\n    dhcp4: true\n");
+
+    return iso;
+}
+
+void BM_CloudInitIsoWrite(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const std::filesystem::path path = dir.filePath("cloud-init-config.iso").toStdString();
+    auto iso = make_iso(state.range(0));
+
+    for (auto _ : state)
+        iso.write_to(path);
+}
+BENCHMARK(BM_CloudInitIsoWrite)->Arg(1024)->Arg(1024 * 1024);
+
+void BM_CloudInitIsoRead(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const std::filesystem::path path = dir.filePath("cloud-init-config.iso").toStdString();
+    make_iso(state.range(0)).write_to(path);
+
+    for (auto _ : state)
+    {
+        mp::CloudInitIso iso;
+        iso.read_from(path);
+        benchmark::DoNotOptimize(iso);
+    }
+}
+BENCHMARK(BM_CloudInitIsoRead)->Arg(1024)->Arg(1024 * 1024);
+} // namespace
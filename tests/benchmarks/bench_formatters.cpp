@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <multipass/cli/csv_formatter.h>
+#include <multipass/cli/json_formatter.h>
+#include <multipass/cli/table_formatter.h>
+#include <multipass/cli/yaml_formatter.h>
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+
+namespace mp = multipass;
+
+namespace
+{
+std::string instance_name(int i)
+{
+    return QString{"instance-%1"}.arg(i, 4, 10, QChar{'0'}).toStdString();
+}
+
+std::string ipv4(int i, int offset)
+{
+    return QString{"10.%1.%2.%3"}.arg(offset).arg(i / 250).arg(i % 250 + 2).toStdString();
+}
+
+mp::ListReply make_list_reply(int num_instances)
+{
+    mp::ListReply reply;
+    auto instances = reply.mutable_instance_list();
+    for (int i = 0; i < num_instances; ++i)
+    {
+        auto entry = instances->add_instances();
+        entry->set_name(instance_name(i));
+        entry->mutable_instance_status()->set_status(i % 3 ? mp::InstanceStatus::RUNNING
+                                                           : mp::InstanceStatus::STOPPED);
+        entry->set_current_release("24.04 LTS");
+        entry->set_os("Ubuntu");
+        entry->add_ipv4(ipv4(i, 21));
+        entry->add_ipv4(ipv4(i, 168));
+    }
+
+    return reply;
+}
+
+mp::InfoReply make_info_reply(int num_instances)
+{
+    mp::InfoReply reply;
+    for (int i = 0; i < num_instances; ++i)
+    {
+        auto entry = reply.add_details();
+        entry->set_name(instance_name(i));
+        entry->mutable_instance_status()->set_status(mp::InstanceStatus::RUNNING);
+        entry->set_cpu_count("4");
+        entry->set_memory_total("4294967296");
+        entry->set_disk_total("21474836480");
+
+        auto info = entry->mutable_instance_info();
+        info->set_image_release("24.04 LTS");
+        info->set_os("Ubuntu");
+        info->set_id("1797c5c82016c1e65f4008fcf89deae3a044ef76087a9ec5b907c6d64a3609ac");
+        info->set_load("0.03 0.10 0.15");
+        info->set_memory_usage("38797312");
+        info->set_disk_usage("1932735284");
+        info->set_current_release("Ubuntu 24.04.1 LTS");
+        info->add_ipv4(ipv4(i, 21));
+        info->set_num_snapshots(i % 4);
+
+        auto mount_info = entry->mutable_mount_info();
+        mount_info->set_longest_path_len(17);
+        auto mount = mount_info->add_mount_paths();
+        mount->set_source_path("/home/user/source");
+        mount->set_target_path("source");
+    }
+
+    return reply;
+}
+
+// The formatting side of `multipass list` and `multipass info` on a busy host
+template <typename FormatterT>
+void BM_FormatList(benchmark::State& state)
+{
+    const FormatterT formatter{};
+    const auto reply = make_list_reply(state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(formatter.format(reply));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FormatList, mp::TableFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::JsonFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::CSVFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::YamlFormatter)->Arg(10)->Arg(500);
+
+template <typename FormatterT>
+void BM_FormatInfo(benchmark::State& state)
+{
+    const FormatterT formatter{};
+    const auto reply = make_info_reply(state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(formatter.format(reply));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::TableFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::JsonFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::CSVFormatter)->Arg(10)->Arg(500);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::YamlFormatter)->Arg(10)->Arg(500);
+} // namespace
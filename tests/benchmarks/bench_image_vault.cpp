@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <multipass/vm_image_vault_utils.h>
+#include <multipass/xz_image_decoder.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto mebibyte = 1024 * 1024;
+
+QByteArray random_bytes(qsizetype size)
+{
+    std::mt19937 gen{42};
+    QByteArray bytes(size, Qt::Uninitialized);
+    std::generate(bytes.begin(), bytes.end(), [&gen] { return static_cast<char>(gen()); });
+    return bytes;
+}
+
+QByteArray le32(std::uint32_t value)
+{
+    QByteArray bytes;
+    for (int i = 0; i < 4; ++i)
+        bytes.append(static_cast<char>(value >> 8 * i & 0xff));
+    return bytes;
+}
+
+QByteArray varint(std::uint64_t value)
+{
+    QByteArray bytes;
+    for (; value >= 0x80; value >>= 7)
+        bytes.append(static_cast<char>(value & 0x7f | 0x80));
+    bytes.append(static_cast<char>(value));
+    return bytes;
+}
+
+std::uint32_t crc32(const QByteArray& bytes)
+{
+    return xz_crc32(reinterpret_cast<const std::uint8_t*>(bytes.constData()), bytes.size(), 0);
+}
+
+void pad_to_4(QByteArray& bytes)
+{
+    while (bytes.size() % 4)
+        bytes.append('\0');
+}
+
+// We only have a decoder at hand, so this wraps the data in uncompressed LZMA2 chunks. Random
+// contents would barely compress anyway, and the decoder still goes through its whole loop:
+// reading, checking, writing and reporting progress.
+QByteArray make_xz(const QByteArray& data)
+{
+    const QByteArray stream_flags{"\x00\x01", 2}; // CRC32 checks
+    QByteArray xz{"\xfd" "7zXZ\x00", 6};
+    xz += stream_flags + le32(crc32(stream_flags));
+
+    QByteArray block_header{"\x02\x00\x21\x01\x16", 5}; // 12 bytes, a single LZMA2 filter
+    pad_to_4(block_header);
+    block_header += le32(crc32(block_header));
+
+    constexpr qsizetype chunk_size = 65536;
+    QByteArray chunks;
+    for (qsizetype pos = 0; pos < data.size(); pos += chunk_size)
+    {
+        const auto size = std::min(chunk_size, data.size() - pos);
+        chunks.append(pos ? '\x02' : '\x01'); // uncompressed, resetting the dictionary first
+        chunks.append(static_cast<char>((size - 1) >> 8));
+        chunks.append(static_cast<char>((size - 1) & 0xff));
+        chunks.append(data.constData() + pos, size);
+    }
+    chunks.append('\0');
+
+    const auto unpadded_size = block_header.size() + chunks.size() + 4;
+    xz += block_header + chunks;
+    pad_to_4(xz);
+    xz += le32(crc32(data));
+
+    QByteArray index{"\x00", 1};
+    index += varint(1) + varint(unpadded_size) + varint(data.size());
+    pad_to_4(index);
+    index += le32(crc32(index));
+    xz += index;
+
+    const auto backward = le32(index.size() / 4 - 1) + stream_flags;
+    xz += le32(crc32(backward)) + backward + "YZ";
+
+    return xz;
+}
+
+void write_file(const QString& path, const QByteArray& contents)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size())
+        throw std::runtime_error{"failed to write " + path.toStdString()};
+}
+
+// What verifying every downloaded or imported image costs
+void BM_ComputeFileHash(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const auto path = dir.filePath("image.img");
+    const auto size = state.range(0) * mebibyte;
+    write_file(path, random_bytes(size));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(MP_IMAGE_VAULT_UTILS.compute_file_hash(path));
+
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ComputeFileHash)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+
+void BM_XzImageDecode(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const auto xz_path = dir.filePath("image.img.xz");
+    const auto decoded_path = dir.filePath("image.img");
+    const auto size = state.range(0) * mebibyte;
+    write_file(xz_path, make_xz(random_bytes(size)));
+
+    const mp::XzImageDecoder decoder;
+    for (auto _ : state)
+        decoder.decode_to(xz_path, decoded_path, [](int, int) { return true; });
+
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_XzImageDecode)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/settings/basic_setting_spec.h>
+#include <multipass/settings/persistent_settings_handler.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include <filesystem>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto key = "local.driver";
+
+// Reads a key from a real settings file, as every `multipass get` and most daemon requests do
+struct SettingsFile
+{
+    SettingsFile()
+    {
+        QSettings settings{filename, QSettings::IniFormat};
+        for (int i = 0; i < 50; ++i)
+            settings.setValue(QString{"local.instance%1.cpus"}.arg(i), i % 8 + 1);
+        settings.setValue(key, "qemu");
+    }
+
+    mp::PersistentSettingsHandler make_handler() const
+    {
+        mp::SettingSpec::Set specs;
+        specs.insert(std::make_unique<mp::BasicSettingSpec>(key, "qemu"));
+        return mp::PersistentSettingsHandler{filename, std::move(specs)};
+    }
+
+    QTemporaryDir dir;
+    QString filename = dir.filePath("multipassd.conf");
+};
+
+void BM_PersistentSettingsGet(benchmark::State& state)
+{
+    SettingsFile file;
+    const auto handler = file.make_handler();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(handler.get(key));
+}
+BENCHMARK(BM_PersistentSettingsGet);
+
+// The same reads, against a file that has just been written and so cannot be cached yet
+void BM_PersistentSettingsGetRecentlyModified(benchmark::State& state)
+{
+    SettingsFile file;
+    const auto handler = file.make_handler();
+    const std::filesystem::path path{file.filename.toStdString()};
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now());
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(handler.get(key));
+    }
+}
+BENCHMARK(BM_PersistentSettingsGetRecentlyModified);
+} // namespace
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/platform.h>
+
+#include <libssh/sftp.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <filesystem>
+#include <vector>
+
+namespace mp = multipass;
+namespace fs = std::filesystem;
+
+namespace
+{
+// The per-entry work of an SFTP READDIR over a directory with many files, as sshfs sends for
+// every `ls` or tree walk in the guest
+struct LargeDirectory
+{
+    static constexpr int num_files = 20000;
+
+    LargeDirectory()
+    {
+        for (int i = 0; i < num_files; ++i)
+        {
+            QFile file{dir.filePath(QString{"file%1.c"}.arg(i))};
+            file.open(QIODevice::WriteOnly);
+            file.write("int main() {}\n");
+        }
+
+        for (const auto& entry : fs::directory_iterator{dir.path().toStdString()})
+            paths.push_back(entry.path().string());
+    }
+
+    QTemporaryDir dir;
+    std::vector<std::string> paths;
+};
+
+const LargeDirectory& large_directory()
+{
+    static const LargeDirectory directory;
+    return directory;
+}
+
+// What READDIR used to do for each entry: a QFileInfo queried field by field, plus a localized
+// timestamp for the long name
+void BM_ReaddirEntriesThroughQFileInfo(benchmark::State& state)
+{
+    const auto& directory = large_directory();
+
+    for (auto _ : state)
+    {
+        for (const auto& path : directory.paths)
+        {
+            const QFileInfo file_info{path.c_str()};
+            sftp_attributes_struct attr{};
+            attr.size = file_info.size();
+            attr.uid = file_info.ownerId();
+            attr.gid = file_info.groupId();
+            attr.permissions = file_info.permissions().toInt();
+            attr.atime = file_info.lastRead().toUTC().toMSecsSinceEpoch() / 1000;
+            attr.mtime = file_info.lastModified().toUTC().toMSecsSinceEpoch() / 1000;
+            if (file_info.isSymLink())
+                attr.permissions |= SSH_S_IFLNK | 0777;
+            else if (file_info.isDir())
+                attr.permissions |= SSH_S_IFDIR;
+            else if (file_info.isFile())
+                attr.permissions |= SSH_S_IFREG;
+
+            benchmark::DoNotOptimize(attr);
+            benchmark::DoNotOptimize(
+                file_info.lastModified().toString("MMM d hh:mm:ss yyyy").toStdString());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * directory.paths.size());
+}
+BENCHMARK(BM_ReaddirEntriesThroughQFileInfo)->Unit(benchmark::kMillisecond);
+
+void BM_ReaddirEntriesThroughStat(benchmark::State& state)
+{
+    const auto& directory = large_directory();
+
+    for (auto _ : state)
+    {
+        for (const auto& path : directory.paths)
+        {
+            sftp_attributes_struct attr{};
+            benchmark::DoNotOptimize(mp::platform::entry_attr_from(path.c_str(), &attr));
+            benchmark::DoNotOptimize(attr);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * directory.paths.size());
+}
+BENCHMARK(BM_ReaddirEntriesThroughStat)->Unit(benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "mock_settings.h"
+
+#include <multipass/image_host/ubuntu_image_host.h>
+#include <multipass/query.h>
+#include <multipass/simple_streams_manifest.h>
+#include <multipass/url_downloader.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QUrl>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+namespace
+{
+constexpr auto host = "https://cloud-images.example/";
+constexpr auto manifest_path = "streams/v1/com.ubuntu.cloud:released:download.json";
+
+QString manifest_arch()
+{
+    const auto arch = QSysInfo::currentCpuArchitecture();
+    return arch == "arm64" ? "arm64" : arch == "s390x" ? "s390x" : "amd64";
+}
+
+QString image_id(int product, int version)
+{
+    return QString{"%1%2"}.arg(product, 32, 16, QChar{'0'}).arg(version, 32, 16, QChar{'0'});
+}
+
+// A manifest about the size of the real releases stream: many products, each with a few versions
+QByteArray make_manifest(int num_products, int num_versions)
+{
+    QJsonObject products;
+    for (int p = 0; p < num_products; ++p)
+    {
+        QJsonObject versions;
+        for (int v = 0; v < num_versions; ++v)
+        {
+            const auto sha256 = image_id(p, v);
+            QJsonObject image{{"ftype", "disk1.img"},
+                              {"path", QString{"server/releases/%1/disk1.img"}.arg(sha256)},
+                              {"sha256", sha256},
+                              {"size", 600000000}};
+            versions[QString{"2024%1"}.arg(v, 4, 10, QChar{'0'})] =
+                QJsonObject{{"items", QJsonObject{{"disk1.img", image}}}};
+        }
+
+        products[QString{"com.ubuntu.cloud:server:%1:%2"}.arg(p).arg(manifest_arch())] =
+            QJsonObject{{"aliases", QString{"%1.04,release%1"}.arg(p)},
+                        {"arch", manifest_arch()},
+                        {"os", "ubuntu"},
+                        {"release", QString{"release%1"}.arg(p)},
+                        {"release_codename", QString{"Codename %1"}.arg(p)},
+                        {"release_title", QString{"%1.04"}.arg(p)},
+                        {"supported", true},
+                        {"versions", versions}};
+    }
+
+    return QJsonDocument{QJsonObject{{"updated", "Thu, 18 May 2024 12:08:59 +0000"},
+                                     {"products", products}}}
+        .toJson(QJsonDocument::Compact);
+}
+
+QByteArray make_index()
+{
+    const QJsonObject entry{{"datatype", "image-downloads"},
+                            {"path", manifest_path},
+                            {"updated", "Thu, 18 May 2024 12:08:59 +0000"}};
+    return QJsonDocument{QJsonObject{{"index", QJsonObject{{"download", entry}}}}}.toJson();
+}
+
+// Answers every request from memory, which is what a revalidation that gets a 304 amounts to
+struct NotModifiedURLDownloader : public mp::URLDownloader
+{
+    NotModifiedURLDownloader(QByteArray manifest)
+        : mp::URLDownloader{std::chrono::seconds{10}}, manifest{std::move(manifest)}
+    {
+    }
+
+    QByteArray download(const QUrl& url, const bool) override
+    {
+        return url.path().endsWith("index.json") ? index : manifest;
+    }
+
+    const QByteArray index = make_index();
+    const QByteArray manifest;
+};
+
+struct Manifests
+{
+    Manifests()
+    {
+        ON_CALL(*mock_settings, get).WillByDefault(testing::Return(QString{}));
+    }
+
+    mpt::MockSettings::GuardedMock attr{mpt::MockSettings::inject<testing::NiceMock>()};
+    mpt::MockSettings* mock_settings = attr.first;
+    const QByteArray json = make_manifest(200, 10);
+};
+
+// Lookups against a host holding a synthetic manifest with many thousands of products
+struct LargeImageHost : public Manifests
+{
+    static constexpr int num_products = 5000;
+    static constexpr int num_versions = 3;
+
+    LargeImageHost()
+    {
+        image_host.update_manifests(false);
+    }
+
+    static mp::Query query(const QString& release)
+    {
+        return {"", release.toStdString(), false, "release", mp::Query::Type::Alias};
+    }
+
+    NotModifiedURLDownloader downloader{make_manifest(num_products, num_versions)};
+    mp::UbuntuVMImageHost image_host{{{"release", mp::UbuntuVMImageRemote{host, "releases/"}}},
+                                     &downloader};
+};
+
+void BM_ManifestColdParse(benchmark::State& state)
+{
+    Manifests manifests;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+            mp::SimpleStreamsManifest::fromJson(manifests.json, std::nullopt, host));
+
+    state.SetBytesProcessed(state.iterations() * manifests.json.size());
+}
+BENCHMARK(BM_ManifestColdParse)->Unit(benchmark::kMillisecond);
+
+void BM_ManifestWarmLoad(benchmark::State& state)
+{
+    Manifests manifests;
+    const auto binary =
+        mp::SimpleStreamsManifest::fromJson(manifests.json, std::nullopt, host)->toBinary();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(mp::SimpleStreamsManifest::fromBinary(binary));
+
+    state.counters["binary_bytes"] = binary.size();
+}
+BENCHMARK(BM_ManifestWarmLoad)->Unit(benchmark::kMillisecond);
+
+void BM_ManifestNotModifiedRefresh(benchmark::State& state)
+{
+    Manifests manifests;
+    QTemporaryDir cache_dir;
+    NotModifiedURLDownloader downloader{manifests.json};
+    mp::UbuntuVMImageHost image_host{{{"release", mp::UbuntuVMImageRemote{host, "releases/"}}},
+                                     &downloader,
+                                     cache_dir.path()};
+
+    image_host.update_manifests(true); // populate the cache
+
+    for (auto _ : state)
+        image_host.update_manifests(true);
+}
+BENCHMARK(BM_ManifestNotModifiedRefresh)->Unit(benchmark::kMillisecond);
+
+void BM_ImageHostInfoForAlias(benchmark::State& state)
+{
+    LargeImageHost large;
+    const auto query = LargeImageHost::query(QString{"release%1"}.arg(large.num_products / 2));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(large.image_host.info_for(query));
+}
+BENCHMARK(BM_ImageHostInfoForAlias);
+
+void BM_ImageHostAllInfoForHashPrefix(benchmark::State& state)
+{
+    LargeImageHost large;
+    const auto query = LargeImageHost::query(image_id(large.num_products / 2, 0).left(32));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(large.image_host.all_info_for(query));
+}
+BENCHMARK(BM_ImageHostAllInfoForHashPrefix);
+
+void BM_ImageHostInfoForFullHash(benchmark::State& state)
+{
+    LargeImageHost large;
+    const auto hash = image_id(large.num_products - 1, large.num_versions - 1).toStdString();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(large.image_host.info_for_full_hash(hash));
+}
+BENCHMARK(BM_ImageHostInfoForFullHash);
+
+// What `multipass find` without arguments goes through
+void BM_ImageHostListReleases(benchmark::State& state)
+{
+    LargeImageHost large;
+
+    for (auto _ : state)
+    {
+        std::size_t count = 0;
+        large.image_host.for_each_aliased_entry_do(
+            [&count](const std::string&, const mp::VMImageInfo&) { ++count; });
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(BM_ImageHostListReleases);
+} // namespace
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Drives a running daemon through the lifecycle of many instances at once, over the same gRPC API
+// the client uses, and prints how long each call took as JSON percentiles. Meant to run against a
+// daemon on the null backend (driver "null"), where instances cost next to nothing.
+
+#include <multipass/cli/client_common.h>
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mp = multipass;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+class Latencies
+{
+public:
+    void record(const std::string& operation, Clock::duration duration, bool ok)
+    {
+        std::lock_guard lock{mutex};
+        auto& samples = operations[operation];
+        samples.durations.push_back(duration);
+        samples.failures += !ok;
+    }
+
+    QJsonObject to_json()
+    {
+        std::lock_guard lock{mutex};
+
+        QJsonObject ret;
+        for (auto& [operation, samples] : operations)
+        {
+            auto& durations = samples.durations;
+            std::sort(durations.begin(), durations.end());
+
+            auto percentile_ms = [&durations](double p) {
+                const auto index = static_cast<std::size_t>(p * (durations.size() - 1));
+                return std::chrono::duration<double, std::milli>{durations[index]}.count();
+            };
+
+            ret[QString::fromStdString(operation)] =
+                QJsonObject{{"count", static_cast<qint64>(durations.size())},
+                            {"failures", samples.failures},
+                            {"p50_ms", percentile_ms(0.5)},
+                            {"p90_ms", percentile_ms(0.9)},
+                            {"p99_ms", percentile_ms(0.99)},
+                            {"max_ms", percentile_ms(1.0)}};
+        }
+
+        return ret;
+    }
+
+private:
+    struct Samples
+    {
+        std::vector<Clock::duration> durations;
+        int failures = 0;
+    };
+
+    std::mutex mutex;
+    std::map<std::string, Samples> operations;
+};
+
+class LoadGenerator
+{
+public:
+    LoadGenerator(std::shared_ptr<grpc::Channel> channel, int num_instances, QString prefix)
+        : stub{mp::Rpc::NewStub(std::move(channel))},
+          num_instances{num_instances},
+          prefix{std::move(prefix)}
+    {
+    }
+
+    // Each worker takes the next instance through its whole lifecycle, with a list in between, as
+    // the GUI and scripts poll it
+    void run_worker()
+    {
+        for (int i = next++; i < num_instances; i = next++)
+        {
+            const auto name = QString{"%1-%2"}.arg(prefix).arg(i).toStdString();
+
+            mp::LaunchRequest launch;
+            launch.set_instance_name(name);
+            if (!timed("launch", &mp::Rpc::Stub::launch, launch))
+                continue;
+
+            mp::ListRequest list;
+            timed("list", &mp::Rpc::Stub::list, list);
+
+            mp::StopRequest stop;
+            stop.mutable_instance_names()->add_instance_name(name);
+            timed("stop", &mp::Rpc::Stub::stop, stop);
+
+            mp::SnapshotRequest snapshot;
+            snapshot.set_instance(name);
+            timed("snapshot", &mp::Rpc::Stub::snapshot, snapshot);
+
+            mp::StartRequest start;
+            start.mutable_instance_names()->add_instance_name(name);
+            timed("start", &mp::Rpc::Stub::start, start);
+
+            mp::InfoRequest info;
+            info.add_instance_snapshot_pairs()->set_instance_name(name);
+            info.set_no_runtime_information(true);
+            timed("info", &mp::Rpc::Stub::info, info);
+
+            mp::DeleteRequest del;
+            del.add_instance_snapshot_pairs()->set_instance_name(name);
+            del.set_purge(true);
+            timed("delete", &mp::Rpc::Stub::delet, del);
+        }
+    }
+
+    Latencies latencies;
+
+private:
+    template <typename Request, typename Reply>
+    using Method = std::unique_ptr<grpc::ClientReaderWriterInterface<Request, Reply>> (
+        mp::Rpc::Stub::*)(grpc::ClientContext*);
+
+    template <typename Request, typename Reply>
+    bool timed(const std::string& operation, Method<Request, Reply> method, const Request& request)
+    {
+        const auto start = Clock::now();
+
+        grpc::ClientContext context;
+        auto stream = ((*stub).*method)(&context);
+        stream->Write(request);
+        stream->WritesDone();
+
+        Reply reply;
+        while (stream->Read(&reply))
+            ;
+        const auto status = stream->Finish();
+
+        latencies.record(operation, Clock::now() - start, status.ok());
+        if (!status.ok())
+            std::cerr << operation << " failed: " << status.error_message() << '\n';
+
+        return status.ok();
+    }
+
+    std::unique_ptr<mp::Rpc::Stub> stub;
+    const int num_instances;
+    const QString prefix;
+    std::atomic_int next{0};
+};
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("multipass_load_generator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Drives many instances through a running multipass daemon");
+    parser.addHelpOption();
+    QCommandLineOption instances_option{"instances", "Instances to go through", "n", "100"};
+    QCommandLineOption concurrency_option{"concurrency", "Instances at a time", "n", "10"};
+    QCommandLineOption prefix_option{"prefix", "Prefix of the instance names", "name", "load"};
+    parser.addOptions({instances_option, concurrency_option, prefix_option});
+    parser.process(app);
+
+    const auto num_instances = parser.value(instances_option).toInt();
+    const auto concurrency = std::max(1, parser.value(concurrency_option).toInt());
+
+    auto cert_provider = mp::client::get_cert_provider();
+    LoadGenerator generator{
+        mp::client::make_channel(mp::client::get_server_address(), *cert_provider),
+        num_instances,
+        parser.value(prefix_option)};
+
+    const auto start = Clock::now();
+    {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < concurrency; ++i)
+            workers.emplace_back([&generator] { generator.run_worker(); });
+        for (auto& worker : workers)
+            worker.join();
+    }
+    const auto elapsed = std::chrono::duration<double>{Clock::now() - start}.count();
+
+    QJsonObject results{{"instances", num_instances},
+                        {"concurrency", concurrency},
+                        {"seconds", elapsed},
+                        {"operations", generator.latencies.to_json()}};
+    std::cout << QJsonDocument{results}.toJson().toStdString();
+
+    return 0;
+}
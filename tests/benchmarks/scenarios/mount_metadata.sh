@@ -0,0 +1,47 @@
+#!/bin/sh
+# Measures metadata-heavy workloads over an sshfs mount: a tree walk, a stat storm over every file
+# and a repeated `git status`, which is what builds and editors mostly do on mounted sources.
+#
+# Creates a synthetic source tree on the host and mounts it into an instance of the running
+# daemon, so run it on the host under test, e.g. before and after a change to the mount path.
+# Prints the results as JSON, in seconds.
+#
+# Usage: mount_metadata.sh [directories] [files-per-directory]
+set -eu
+
+DIRS=${1:-200}
+FILES=${2:-50}
+INSTANCE=mountbench
+TARGET=/home/ubuntu/tree
+SOURCE=$(mktemp -d)
+
+cleanup() {
+    multipass delete --purge "$INSTANCE" >/dev/null 2>&1 || true
+    rm -rf "$SOURCE"
+}
+trap cleanup EXIT
+
+for d in $(seq "$DIRS"); do
+    mkdir -p "$SOURCE/dir$d/sub"
+    for f in $(seq "$FILES"); do
+        echo "$d $f" >"$SOURCE/dir$d/sub/file$f.c"
+    done
+done
+git -C "$SOURCE" init -q && git -C "$SOURCE" add -A &&
+    git -C "$SOURCE" -c user.name=bench -c user.email=bench@localhost commit -qm tree
+
+multipass launch --name "$INSTANCE"
+multipass exec "$INSTANCE" -- sudo DEBIAN_FRONTEND=noninteractive apt-get -qq install -y git
+multipass mount "$SOURCE" "$INSTANCE:$TARGET"
+
+timed() {
+    multipass exec "$INSTANCE" -- bash -c "cd $TARGET && TIMEFORMAT=%R && { time $1 >/dev/null 2>&1; } 2>&1"
+}
+
+WALK=$(timed "find . -type f")
+STAT=$(timed "find . -type f -print0 | xargs -0 stat")
+GIT_COLD=$(timed "git -c safe.directory='*' status --porcelain")
+GIT_WARM=$(timed "git -c safe.directory='*' status --porcelain")
+
+printf '{"files": %s, "tree_walk": %s, "stat_storm": %s, "git_status_cold": %s, "git_status_warm": %s}\n' \
+    "$((DIRS * FILES))" "$WALK" "$STAT" "$GIT_COLD" "$GIT_WARM"
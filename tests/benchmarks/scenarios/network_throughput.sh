@@ -0,0 +1,38 @@
+#!/bin/sh
+# Measures instance-to-instance TCP throughput over the default network with iperf3.
+#
+# Launches two instances against the running daemon, so run it on the host under test, e.g. once
+# with /dev/vhost-net available and once without. Prints the results as JSON.
+#
+# Usage: network_throughput.sh [cpus] [parallel-streams] [seconds]
+set -eu
+
+CPUS=${1:-4}
+STREAMS=${2:-$CPUS}
+SECONDS_TO_RUN=${3:-30}
+SERVER=netbench-server
+CLIENT=netbench-client
+
+cleanup() {
+    multipass delete --purge "$SERVER" "$CLIENT" >/dev/null 2>&1 || true
+}
+trap cleanup EXIT
+
+for instance in "$SERVER" "$CLIENT"; do
+    multipass launch --name "$instance" --cpus "$CPUS" --memory 2G
+    multipass exec "$instance" -- sudo apt-get -qq update
+    multipass exec "$instance" -- sudo DEBIAN_FRONTEND=noninteractive apt-get -qq install -y iperf3
+done
+
+SERVER_IP=$(multipass info "$SERVER" --format csv | tail -n 1 | cut -d, -f3)
+QUEUES=$(multipass exec "$CLIENT" -- sh -c 'ls -d /sys/class/net/ens*/queues/rx-* | wc -l')
+
+multipass exec "$SERVER" -- iperf3 --server --daemon --one-off
+sleep 1
+
+BITS_PER_SECOND=$(multipass exec "$CLIENT" -- \
+    iperf3 --client "$SERVER_IP" --parallel "$STREAMS" --time "$SECONDS_TO_RUN" --json |
+    python3 -c 'import json, sys; print(json.load(sys.stdin)["end"]["sum_received"]["bits_per_second"])')
+
+printf '{"cpus": %s, "streams": %s, "guest_rx_queues": %s, "bits_per_second": %s}\n' \
+    "$CPUS" "$STREAMS" "$QUEUES" "$BITS_PER_SECOND"
@@ -43,7 +43,12 @@ add_c_mocks(
   ssh_channel_request_pty
   ssh_channel_change_pty_size
   ssh_channel_read_timeout
+  ssh_channel_write
   ssh_channel_get_exit_state
+  ssh_channel_select
+  ssh_channel_poll
+  ssh_channel_read_nonblocking
+  ssh_channel_close
   ssh_event_dopoll
   ssh_add_channel_callbacks
   sftp_server_new
@@ -55,7 +60,6 @@ add_c_mocks(
   sftp_reply_names
   sftp_reply_names_add
   sftp_reply_handle
-  sftp_reply_version
   sftp_get_client_message
   sftp_client_message_free
   sftp_client_message_get_data
@@ -453,5 +453,35 @@ public:
                 PrepareAsyncwait_readyRaw,
                 (grpc::ClientContext * context, grpc::CompletionQueue* cq),
                 (override));
+    MOCK_METHOD((grpc::ClientReaderWriterInterface<multipass::MetricsRequest,
+                                                   multipass::MetricsReply>*),
+                metricsRaw,
+                (grpc::ClientContext * context),
+                (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::MetricsRequest,
+                                                        multipass::MetricsReply>*),
+                AsyncmetricsRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq, void* tag),
+                (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::MetricsRequest,
+                                                        multipass::MetricsReply>*),
+                PrepareAsyncmetricsRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq),
+                (override));
+    MOCK_METHOD((grpc::ClientReaderWriterInterface<multipass::WatchRequest,
+                                                   multipass::WatchReply>*),
+                watchRaw,
+                (grpc::ClientContext * context),
+                (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::WatchRequest,
+                                                        multipass::WatchReply>*),
+                AsyncwatchRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq, void* tag),
+                (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::WatchRequest,
+                                                        multipass::WatchReply>*),
+                PrepareAsyncwatchRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq),
+                (override));
 };
 } // namespace multipass::test
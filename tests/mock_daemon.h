@@ -190,6 +190,20 @@ struct MockDaemon : public Daemon
                  std::promise<grpc::Status>*),
                 (override));
 
+    MOCK_METHOD(void,
+                metrics,
+                (const MetricsRequest*,
+                 (grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>*),
+                 std::promise<grpc::Status>*),
+                (override));
+
+    MOCK_METHOD(void,
+                watch,
+                (const WatchRequest*,
+                 (grpc::ServerReaderWriterInterface<WatchReply, WatchRequest>*),
+                 std::promise<grpc::Status>*),
+                (override));
+
     template <typename Request, typename Reply>
     void set_promise_value(const Request*,
                            grpc::ServerReaderWriterInterface<Reply, Request>*,
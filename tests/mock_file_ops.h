@@ -132,6 +132,14 @@ public:
                 symlink_status,
                 (const fs::path& path, std::error_code& err),
                 (override, const));
+    MOCK_METHOD(fs::file_time_type,
+                last_write_time,
+                (const fs::path& path, std::error_code& err),
+                (override, const));
+    MOCK_METHOD(std::uintmax_t,
+                file_size,
+                (const fs::path& path, std::error_code& err),
+                (override, const));
     MOCK_METHOD(std::unique_ptr<multipass::RecursiveDirIterator>,
                 recursive_dir_iterator,
                 (const fs::path& path, std::error_code& err),
@@ -84,6 +84,7 @@ public:
     MOCK_METHOD(qint64, write, (const QByteArray&), (override));
     MOCK_METHOD(bool, wait_for_started, (int msecs), (override));
     MOCK_METHOD(bool, wait_for_finished, (int msecs), (override));
+    MOCK_METHOD(void, reload_apparmor_profile, (), (override));
 
     MockProcess(std::unique_ptr<ProcessSpec>&& spec,
                 std::vector<MockProcessFactory::ProcessInfo>& process_list);
@@ -35,7 +35,6 @@ DECL_MOCK(sftp_get_client_message);
 DECL_MOCK(sftp_client_message_free);
 DECL_MOCK(sftp_client_message_get_data);
 DECL_MOCK(sftp_client_message_get_filename);
-DECL_MOCK(sftp_reply_version);
 DECL_MOCK(sftp_handle);
 DECL_MOCK(sftp_handle_alloc);
 DECL_MOCK(sftp_handle_remove);
@@ -40,6 +40,11 @@ struct MockSSHTestFixture
         channel_is_open.returnValue(true);
         channel_is_closed.returnValue(0);
         options_set.returnValue(SSH_OK);
+        // every channel waited on has something to read, and nothing on stderr
+        channel_select.returnValue(SSH_OK);
+        channel_poll.returnValue(1);
+        channel_read_nonblocking.returnValue(0);
+        channel_close.returnValue(SSH_OK);
     }
 
     decltype(MOCK(ssh_connect)) connect{MOCK(ssh_connect)};
@@ -53,6 +58,11 @@ struct MockSSHTestFixture
     decltype(MOCK(ssh_channel_is_open)) channel_is_open{MOCK(ssh_channel_is_open)};
     decltype(MOCK(ssh_channel_is_closed)) channel_is_closed{MOCK(ssh_channel_is_closed)};
     decltype(MOCK(ssh_options_set)) options_set{MOCK(ssh_options_set)};
+    decltype(MOCK(ssh_channel_select)) channel_select{MOCK(ssh_channel_select)};
+    decltype(MOCK(ssh_channel_poll)) channel_poll{MOCK(ssh_channel_poll)};
+    decltype(MOCK(ssh_channel_read_nonblocking)) channel_read_nonblocking{
+        MOCK(ssh_channel_read_nonblocking)};
+    decltype(MOCK(ssh_channel_close)) channel_close{MOCK(ssh_channel_close)};
 };
 } // namespace test
 } // namespace multipass
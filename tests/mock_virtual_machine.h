@@ -93,6 +93,11 @@ struct MockVirtualMachineT : public T
     MOCK_METHOD(void, update_cpus, (int), (override));
     MOCK_METHOD(void, resize_memory, (const MemorySize&), (override));
     MOCK_METHOD(void, resize_disk, (const MemorySize&), (override));
+    MOCK_METHOD(std::optional<LiveResizeLimits>, live_resize_limits, (), (const, override));
+    MOCK_METHOD(void, set_disk_profile, (DiskProfile), (override));
+    MOCK_METHOD(void, set_memory_density, (bool), (override));
+    MOCK_METHOD(void, set_balloon_target, (const MemorySize&), (override));
+    MOCK_METHOD(std::optional<MemorySize>, host_memory_usage, (), (const, override));
     MOCK_METHOD(void,
                 add_network_interface,
                 (int, const std::string&, const NetworkInterface&),
@@ -119,6 +124,7 @@ struct MockVirtualMachineT : public T
                 (const std::string& old_name, const std::string& new_name),
                 (override));
     MOCK_METHOD(void, delete_snapshot, (const std::string& name), (override));
+    MOCK_METHOD(void, delete_snapshots, (const std::vector<std::string>& names), (override));
     MOCK_METHOD(void, restore_snapshot, (const std::string&, VMSpecs&), (override));
     MOCK_METHOD(void, load_snapshots, (), (override));
     MOCK_METHOD(std::vector<std::string>,
@@ -34,6 +34,10 @@ struct MockVirtualMachineFactory : public VirtualMachineFactory
                 create_virtual_machine,
                 (const VirtualMachineDescription&, const SSHKeyProvider&, VMStatusMonitor&),
                 (override));
+    MOCK_METHOD(void,
+                clone_instance_files,
+                (const std::string&, const std::string&, const ProgressMonitor&),
+                (override));
     MOCK_METHOD(VirtualMachine::UPtr,
                 clone_bare_vm,
                 (const VMSpecs&,
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tests/common.h"
+#include "tests/mock_environment_helpers.h"
+#include "tests/mock_status_monitor.h"
+#include "tests/mock_utils.h"
+#include "tests/stub_ssh_key_provider.h"
+#include "tests/temp_dir.h"
+
+#include <src/platform/backends/null/null_virtual_machine_factory.h>
+
+#include <multipass/query.h>
+#include <multipass/virtual_machine_description.h>
+#include <multipass/vm_image.h>
+
+#include <QFile>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct NullBackend : public Test
+{
+    mp::VirtualMachine::UPtr make_vm()
+    {
+        return factory.create_virtual_machine(desc, key_provider, monitor);
+    }
+
+    mpt::TempDir data_dir;
+    mpt::MockUtils::GuardedMock attr{mpt::MockUtils::inject<NiceMock>()};
+    mpt::MockUtils* mock_utils = attr.first;
+    mpt::SetEnvScope start_latency{"MULTIPASS_NULL_START_MS", "1500"};
+    mpt::SetEnvScope ssh_latency{"MULTIPASS_NULL_SSH_MS", "20"};
+    mp::NullVirtualMachineFactory factory{data_dir.path()};
+    mp::VirtualMachineDescription desc = [] {
+        mp::VirtualMachineDescription ret{};
+        ret.vm_name = "phantom";
+        ret.ssh_username = "ubuntu";
+        return ret;
+    }();
+    mpt::StubSSHKeyProvider key_provider;
+    NiceMock<mpt::MockVMStatusMonitor> monitor;
+};
+
+TEST_F(NullBackend, goesThroughStartStates)
+{
+    auto vm = make_vm();
+    ASSERT_EQ(vm->current_state(), mp::VirtualMachine::State::off);
+
+    EXPECT_CALL(*mock_utils, sleep_for(std::chrono::milliseconds{1500}));
+    vm->start();
+    EXPECT_EQ(vm->current_state(), mp::VirtualMachine::State::starting);
+
+    EXPECT_CALL(*mock_utils, sleep_for(std::chrono::milliseconds{20}));
+    EXPECT_CALL(monitor, persist_state_for(desc.vm_name, mp::VirtualMachine::State::running));
+    vm->wait_until_ssh_up(1s);
+    EXPECT_EQ(vm->current_state(), mp::VirtualMachine::State::running);
+}
+
+TEST_F(NullBackend, stopsAndSuspends)
+{
+    auto vm = make_vm();
+    vm->start();
+    vm->wait_until_ssh_up(1s);
+
+    vm->suspend();
+    EXPECT_EQ(vm->current_state(), mp::VirtualMachine::State::suspended);
+
+    vm->shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff);
+    EXPECT_EQ(vm->current_state(), mp::VirtualMachine::State::stopped);
+}
+
+TEST_F(NullBackend, commandsSucceedWithoutOutput)
+{
+    auto vm = make_vm();
+
+    EXPECT_CALL(*mock_utils, sleep_for(std::chrono::milliseconds{20}));
+    EXPECT_EQ(vm->ssh_exec("uname -a"), "");
+    EXPECT_EQ(vm->management_ipv4(), vm->management_ipv4());
+    EXPECT_TRUE(vm->management_ipv4().has_value());
+}
+
+TEST_F(NullBackend, vaultHandsOutImagesInstantly)
+{
+    auto vault = factory.create_image_vault({}, nullptr, data_dir.path(), data_dir.path(), {});
+    const auto instance_dir = factory.get_instance_directory(desc.vm_name);
+    ASSERT_FALSE(vault->has_record_for(desc.vm_name));
+
+    const mp::Query query{desc.vm_name, "noble", false, "", mp::Query::Type::Alias};
+    const auto image = vault->fetch_image(
+        factory.fetch_type(),
+        query,
+        [](const mp::VMImage& image) { return image; },
+        [](int, int) { return true; },
+        std::nullopt,
+        instance_dir);
+
+    EXPECT_TRUE(QFile::exists(image.image_path));
+    EXPECT_TRUE(vault->has_record_for(desc.vm_name));
+    EXPECT_THAT(vault->all_info_for(query), SizeIs(1));
+}
+} // namespace
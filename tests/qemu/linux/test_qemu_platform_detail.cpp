@@ -153,6 +153,7 @@ TEST_F(QemuPlatformDetail, platformArgsGenerateNetResourcesRemovesWorksAsExpecte
     mp::VirtualMachineDescription vm_desc;
     mp::NetworkInterface extra_interface{"br-en0", "52:54:00:98:76:54", true};
     vm_desc.vm_name = "foo";
+    vm_desc.num_cores = 1;
     vm_desc.default_mac_address = hw_addr;
     vm_desc.extra_interfaces = {extra_interface};
 
@@ -212,6 +213,78 @@ TEST_F(QemuPlatformDetail, platformArgsGenerateNetResourcesRemovesWorksAsExpecte
     qemu_platform_detail.remove_resources_for(name);
 }
 
+TEST_F(QemuPlatformDetail, platformArgsUseMultiQueueVhostNetWhenAvailable)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.vm_name = "foo";
+    vm_desc.num_cores = 4;
+    vm_desc.default_mac_address = hw_addr;
+
+    EXPECT_CALL(*mock_file_ops, exists(A<const QFileInfo&>())).WillRepeatedly([](const auto& info) {
+        return info.filePath() == "/dev/vhost-net";
+    });
+    EXPECT_CALL(
+        *mock_utils,
+        run_cmd_for_status(
+            QString("ip"),
+            ElementsAre(QString("addr"), QString("show"), mpt::match_qstring(StartsWith("tap-"))),
+            _))
+        .WillOnce(Return(false))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_utils,
+                run_cmd_for_status(QString("ip"),
+                                   ElementsAre(QString("tuntap"),
+                                               QString("add"),
+                                               mpt::match_qstring(StartsWith("tap-")),
+                                               QString("mode"),
+                                               QString("tap"),
+                                               QString("multi_queue")),
+                                   _))
+        .WillOnce(Return(true))
+        .RetiresOnSaturation();
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    const auto platform_args = qemu_platform_detail.vm_platform_args(vm_desc);
+
+    EXPECT_THAT(platform_args, Contains(mpt::match_qstring(AllOf(StartsWith("tap,id=net0,"),
+                                                                 EndsWith(",vhost=on,queues=4")))));
+    EXPECT_THAT(platform_args,
+                Contains(mpt::match_qstring(AllOf(StartsWith("virtio-net-pci,"),
+                                                  HasSubstr(",netdev=net0,"),
+                                                  EndsWith(",mq=on,vectors=10")))));
+}
+
+TEST_F(QemuPlatformDetail, platformArgsRecreateSingleQueueTapForMultiQueue)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.vm_name = "foo";
+    vm_desc.num_cores = 2;
+    vm_desc.default_mac_address = hw_addr;
+
+    EXPECT_CALL(*mock_file_ops, exists(A<const QFileInfo&>())).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_utils, run_cmd_for_output(QString("ip"), QStringList{"tuntap", "show"}, _))
+        .WillOnce(Return(std::string{})); // the existing tap is not listed as multi-queue
+
+    InSequence seq;
+    EXPECT_CALL(*mock_utils,
+                run_cmd_for_status(QString("ip"),
+                                   ElementsAre(QString("link"),
+                                               QString("delete"),
+                                               mpt::match_qstring(StartsWith("tap-"))),
+                                   _))
+        .WillOnce(Return(true))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_utils,
+                run_cmd_for_status(QString("ip"), Contains(QString("multi_queue")), _))
+        .WillOnce(Return(true))
+        .RetiresOnSaturation();
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    qemu_platform_detail.vm_platform_args(vm_desc);
+}
+
 TEST_F(QemuPlatformDetail, platformHealthCheckCallsExpectedMethods)
 {
     EXPECT_CALL(*mock_backend, check_for_kvm_support()).WillOnce(Return());
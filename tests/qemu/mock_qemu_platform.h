@@ -33,6 +33,12 @@ struct MockQemuPlatform : public QemuPlatform
         EXPECT_CALL(*this, vmstate_platform_args())
             .Times(testing::AnyNumber())
             .WillRepeatedly(testing::Return(QStringList()));
+        EXPECT_CALL(*this, vcpu_hotplug_driver())
+            .Times(testing::AnyNumber())
+            .WillRepeatedly(testing::Return(QString()));
+        EXPECT_CALL(*this, virtiofsd_path())
+            .Times(testing::AnyNumber())
+            .WillRepeatedly(testing::Return(QString()));
     }
 
     MOCK_METHOD(std::optional<IPAddress>, get_ip_for, (const std::string&), (override));
@@ -41,6 +47,8 @@ struct MockQemuPlatform : public QemuPlatform
     MOCK_METHOD(QStringList, vmstate_platform_args, (), (override));
     MOCK_METHOD(QStringList, vm_platform_args, (const VirtualMachineDescription&), (override));
     MOCK_METHOD(QString, get_directory_name, (), (const, override));
+    MOCK_METHOD(QString, vcpu_hotplug_driver, (), (const, override));
+    MOCK_METHOD(QString, virtiofsd_path, (), (const, override));
     MOCK_METHOD(bool, is_network_supported, (const std::string&), (const, override));
     MOCK_METHOD(bool, needs_network_prep, (), (const override));
     MOCK_METHOD(std::string, create_bridge_with, (const NetworkInterfaceInfo&), (const, override));
@@ -153,7 +153,7 @@ struct QemuBackend : public mpt::TestWithMockedBinPath
                             EXPECT_CALL(*process, read_all_standard_output())
                                 .WillRepeatedly(Return("{\"timestamp\": {\"seconds\": 1541188919, "
                                                        "\"microseconds\": 838498}, \"event\": "
-                                                       "\"RESUME\"}"));
+                                                       "\"RESUME\"}\r\n"));
 
                             EXPECT_CALL(*process, kill()).WillOnce([process] {
                                 mp::ProcessState exit_state{
@@ -293,7 +293,7 @@ TEST_F(QemuBackend, QMPErrorGetsLogged)
                                                        // cause an error
                     {
                         EXPECT_CALL(*process, read_all_standard_output())
-                            .WillRepeatedly(Return("{\"error\": {\"desc\": \"some error\"}} "));
+                            .WillRepeatedly(Return("{\"error\": {\"desc\": \"some error\"}}\r\n"));
                         emit process->ready_read_standard_output();
                     }
                 }
@@ -313,6 +313,43 @@ TEST_F(QemuBackend, QMPErrorGetsLogged)
     machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
 }
 
+TEST_F(QemuBackend, QMPMessagesSplitAcrossReadsAreHandled)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_)).WillOnce([this](auto...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path()};
+
+    process_factory->register_callback([](mpt::MockProcess* process) {
+        if (process->program().startsWith("qemu-system-"))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([process](const QByteArray& data) {
+                if (QJsonDocument::fromJson(data).object()["execute"] == "qmp_capabilities")
+                {
+                    EXPECT_CALL(*process, read_all_standard_output())
+                        .WillOnce(Return("{\"event\": \"POW"))
+                        .WillOnce(Return("ERDOWN\"}\r\n{\"error\": {\"desc\": \"some"))
+                        .WillOnce(Return(" error\"}}\r\n"));
+                    for (auto i = 0; i < 3; ++i)
+                        emit process->ready_read_standard_output();
+                }
+
+                return data.size();
+            });
+        }
+    });
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, mock_monitor);
+
+    logger_scope.mock_logger->screen_logs(mpl::Level::error);
+    logger_scope.mock_logger->expect_log(mpl::Level::info, "VM powering down");
+    logger_scope.mock_logger->expect_log(mpl::Level::error, "QMP error: some error");
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
+}
+
 TEST_F(QemuBackend, throwsWhenShutdownWhileStarting)
 {
     mpt::MockProcess* vmproc = nullptr;
@@ -1324,6 +1361,7 @@ TEST_F(QemuBackend, cloneCopiesRelevantFiles)
         std::ofstream(src_vm_dir / file);
     }
 
+    backend.clone_instance_files(src_vm_name, dest_vm_name, [](int, int) { return true; });
     EXPECT_TRUE(
         backend.clone_bare_vm({}, {}, src_vm_name, dest_vm_name, {}, key_provider, stub_monitor));
 
@@ -1339,6 +1377,34 @@ TEST_F(QemuBackend, cloneCopiesRelevantFiles)
     EXPECT_EQ(actual_files, expected_files);
 }
 
+TEST_F(QemuBackend, cloneInstanceFilesReportsProgressAndStopsWhenCancelled)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_)).WillOnce([this](auto...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path()};
+
+    namespace fs = std::filesystem;
+    const fs::path src_vm_dir{data_dir.filePath("vault/instances/dummy_src_name").toStdString()};
+    fs::create_directories(src_vm_dir);
+    std::ofstream(src_vm_dir / "dummy.img") << std::string(1 << 20, 'x');
+
+    std::vector<int> progress;
+    const auto record_progress = [&progress](int, int percent) {
+        progress.push_back(percent);
+        return true;
+    };
+
+    backend.clone_instance_files("dummy_src_name", "dummy_dest_name", record_progress);
+    EXPECT_EQ(progress, std::vector<int>{100});
+
+    EXPECT_THROW(backend.clone_instance_files("dummy_src_name",
+                                              "other_dest_name",
+                                              [](int, int) { return false; }),
+                 std::runtime_error);
+}
+
 TEST(QemuPlatform, baseQemuPlatformReturnsExpectedValues)
 {
     mpt::MockQemuPlatform qemu_platform;
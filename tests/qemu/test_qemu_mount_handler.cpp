@@ -41,9 +41,17 @@ struct MockQemuVirtualMachine : mpt::MockVirtualMachineT<mp::QemuVirtualMachine>
     explicit MockQemuVirtualMachine(const std::string& name)
         : mpt::MockVirtualMachineT<mp::QemuVirtualMachine>{name, mpt::StubSSHKeyProvider{}}
     {
+        ON_CALL(*this, modifiable_virtiofsd_args).WillByDefault(ReturnRef(virtiofsd_args));
     }
 
     MOCK_METHOD(mp::QemuVirtualMachine::MountArgs&, modifiable_mount_args, (), (override));
+    MOCK_METHOD(mp::QemuVirtualMachine::VirtiofsdArgs&,
+                modifiable_virtiofsd_args,
+                (),
+                (override));
+    MOCK_METHOD(bool, supports_virtiofs, (), (const, override));
+
+    mp::QemuVirtualMachine::VirtiofsdArgs virtiofsd_args;
 };
 
 struct CommandOutput
@@ -78,6 +86,11 @@ std::string command_mount(const std::string& target)
                        target);
 }
 
+std::string command_mount_virtiofs(const std::string& target)
+{
+    return fmt::format("sudo mount -t virtiofs {} {}", tag_from_target(target), target);
+}
+
 std::string command_umount(const std::string& target)
 {
     return fmt::format("if mountpoint -q {0}; then sudo umount {0}; else true; fi", target);
@@ -97,9 +110,9 @@ std::string command_chown(const std::string& parent, const std::string& missing,
                        missing.substr(0, missing.find_first_of('/')));
 }
 
-std::string command_findmnt(const std::string& target)
+std::string command_findmnt(const std::string& target, const std::string& type = "9p")
 {
-    return fmt::format("findmnt --type 9p | grep '{} {}'", target, tag_from_target(target));
+    return fmt::format("findmnt --type {} | grep '{} {}'", type, target, tag_from_target(target));
 }
 
 struct QemuMountHandlerTest : public ::Test
@@ -332,3 +345,62 @@ TEST_P(QemuMountHandlerFailCommand, throwOnFail)
                          std::runtime_error,
                          mpt::match_what(StrEq(error)));
 }
+
+TEST_F(QemuMountHandlerTest, mountUsesVirtiofsWhenSupported)
+{
+    EXPECT_CALL(vm, supports_virtiofs).WillOnce(Return(true));
+    const auto tag = tag_from_target(default_target);
+
+    {
+        mp::QemuMountHandler handler{&vm, &key_provider, default_target, mount};
+
+        ASSERT_EQ(mount_args.size(), 1);
+        const auto socket_path =
+            vm.instance_directory().filePath(QString::fromStdString(tag.substr(0, 9)) + ".sock");
+        EXPECT_EQ(mount_args.begin()->second.second,
+                  QStringList({"-chardev",
+                               QString("socket,id=%1,path=%2")
+                                   .arg(QString::fromStdString(tag), socket_path),
+                               "-device",
+                               QString("vhost-user-fs-pci,chardev=%1,tag=%1")
+                                   .arg(QString::fromStdString(tag))}));
+        EXPECT_EQ(vm.virtiofsd_args.at(tag),
+                  QStringList({"--translate-uid=map:6:5:1", "--translate-gid=map:2:1:1"}));
+    }
+
+    EXPECT_TRUE(mount_args.empty());
+    EXPECT_TRUE(vm.virtiofsd_args.empty());
+}
+
+TEST_F(QemuMountHandlerTest, virtiofsMountStartsAndStops)
+{
+    EXPECT_CALL(vm, supports_virtiofs).WillOnce(Return(true));
+    command_outputs.insert({command_mount_virtiofs(default_target), {""}});
+    command_outputs.insert({command_findmnt(default_target, "virtiofs"), {""}});
+
+    std::string ssh_command_output;
+    REPLACE(ssh_channel_request_exec, mocked_ssh_channel_request_exec(ssh_command_output));
+    REPLACE(ssh_channel_read_timeout, mocked_ssh_channel_read_timeout(ssh_command_output));
+
+    mp::QemuMountHandler handler{&vm, &key_provider, default_target, mount};
+    EXPECT_NO_THROW(handler.activate(&server));
+    EXPECT_TRUE(handler.is_active());
+    EXPECT_NO_THROW(handler.deactivate());
+}
+
+TEST_F(QemuMountHandlerTest, recoverVirtiofsMountFromSuspended)
+{
+    const auto tag = tag_from_target(default_target);
+    mount_args[tag] = {};
+    vm.virtiofsd_args[tag] = {};
+    EXPECT_CALL(vm, current_state()).WillOnce(Return(mp::VirtualMachine::State::suspended));
+    EXPECT_CALL(vm, supports_virtiofs).Times(0);
+    command_outputs.insert({command_mount_virtiofs(default_target), {""}});
+
+    std::string ssh_command_output;
+    REPLACE(ssh_channel_request_exec, mocked_ssh_channel_request_exec(ssh_command_output));
+    REPLACE(ssh_channel_read_timeout, mocked_ssh_channel_read_timeout(ssh_command_output));
+
+    mp::QemuMountHandler handler{&vm, &key_provider, default_target, mount};
+    EXPECT_NO_THROW(handler.activate(&server));
+}
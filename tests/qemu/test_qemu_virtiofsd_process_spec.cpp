@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tests/common.h"
+#include "tests/mock_environment_helpers.h"
+
+#include <src/platform/backends/qemu/qemu_virtiofsd_process_spec.h>
+
+#include <QDir>
+#include <QStringList>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+struct TestQemuVirtiofsdProcessSpec : public Test
+{
+    const QString program{"/usr/libexec/virtiofsd"};
+    const std::string shared_dir{"/home/user/project"};
+    const QString socket_path{
+        mp::QemuVirtiofsdProcessSpec::socket_path_for(QDir{"/instances/foo"},
+                                                      "m810e457178f448d9afffc9d950d726")};
+    const QStringList extra_arguments{"--translate-uid=map:1000:1234:1"};
+};
+
+TEST_F(TestQemuVirtiofsdProcessSpec, socketPathIsShortAndInInstanceDirectory)
+{
+    EXPECT_EQ(socket_path, "/instances/foo/m810e4571.sock");
+}
+
+TEST_F(TestQemuVirtiofsdProcessSpec, socketPathThatDoesNotFitThrows)
+{
+    const QDir deep_instance_dir{"/" + QString{"d"}.repeated(100) + "/foo"};
+
+    MP_EXPECT_THROW_THAT(
+        mp::QemuVirtiofsdProcessSpec::socket_path_for(deep_instance_dir,
+                                                      "m810e457178f448d9afffc9d950d726"),
+        std::runtime_error,
+        mpt::match_what(HasSubstr("too long")));
+}
+
+TEST_F(TestQemuVirtiofsdProcessSpec, defaultArgumentsCorrect)
+{
+    mp::QemuVirtiofsdProcessSpec spec{program, shared_dir, socket_path, extra_arguments};
+
+    EXPECT_EQ(spec.program(), program);
+    EXPECT_EQ(spec.arguments(),
+              QStringList({"--socket-path=/instances/foo/m810e4571.sock",
+                           "--shared-dir=/home/user/project",
+                           "--sandbox=none",
+                           "--cache=auto",
+                           "--announce-submounts",
+                           "--translate-uid=map:1000:1234:1"}));
+}
+
+TEST_F(TestQemuVirtiofsdProcessSpec, apparmorProfileIsPerInstanceMount)
+{
+    mp::QemuVirtiofsdProcessSpec spec{program, shared_dir, socket_path, extra_arguments};
+
+    EXPECT_EQ(spec.apparmor_profile_name(), "multipass.foo.m810e4571.virtiofsd");
+}
+
+TEST_F(TestQemuVirtiofsdProcessSpec, apparmorProfilePermitsSocketAndSharedDir)
+{
+    mpt::UnsetEnvScope e("SNAP");
+    mp::QemuVirtiofsdProcessSpec spec{program, shared_dir, socket_path, extra_arguments};
+
+    const auto profile = spec.apparmor_profile();
+    EXPECT_TRUE(profile.contains("/instances/foo/m810e4571.sock rw,"));
+    EXPECT_TRUE(profile.contains("/home/user/project/** rwlk,"));
+    EXPECT_TRUE(profile.contains("/usr/libexec/virtiofsd ixr,"));
+}
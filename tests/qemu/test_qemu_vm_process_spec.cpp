@@ -17,14 +17,19 @@
 
 #include "tests/common.h"
 #include "tests/mock_environment_helpers.h"
+#include "tests/mock_file_ops.h"
 
 #include <multipass/snap_utils.h>
 #include <src/platform/backends/qemu/qemu_vm_process_spec.h>
 
 #include <QDir>
+#include <QFile>
 #include <QString>
 #include <QStringList>
 #include <QTemporaryDir>
+#include <QtEndian>
+
+#include <fcntl.h>
 
 namespace mp = multipass;
 namespace mpt = multipass::test;
@@ -88,6 +93,148 @@ TEST_F(TestQemuVMProcessSpec, defaultArgumentsCorrect)
                            "path=path/to/target,mount_tag=m810e457178f448d9afffc9d950d726"}));
 }
 
+TEST_F(TestQemuVMProcessSpec, hotplugHeadroomExtendsCpuAndMemoryArguments)
+{
+    const mp::VirtualMachine::LiveResizeLimits headroom{2,
+                                                        8,
+                                                        mp::MemorySize{"3G"},
+                                                        mp::MemorySize{"16G"}};
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt, headroom);
+
+    const auto args = spec.arguments();
+    const auto smp = args.indexOf("-smp");
+    const auto mem = args.indexOf("-m");
+
+    ASSERT_NE(smp, -1);
+    ASSERT_NE(mem, -1);
+    EXPECT_EQ(args[smp + 1], "2,sockets=1,cores=8,threads=1,maxcpus=8");
+    EXPECT_EQ(args[mem + 1], "3072M,slots=16,maxmem=16384M");
+}
+
+TEST_F(TestQemuVMProcessSpec, throughputDiskProfileUsesVirtioBlkWithIothread)
+{
+    auto throughput_desc = desc;
+    throughput_desc.disk_profile = mp::DiskProfile::throughput;
+
+    mp::QemuVMProcessSpec spec(throughput_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains("iothread,id=iothread0"));
+    EXPECT_TRUE(args.contains("virtio-blk-pci,drive=hda,iothread=iothread0,num-queues=2"));
+    EXPECT_FALSE(args.contains("virtio-scsi-pci,id=scsi0"));
+
+    const auto drive = args.filter("file=/path/to/image");
+    ASSERT_EQ(drive.size(), 1);
+    // 65536 clusters of 64KiB, with 8 bytes of L2 table each, fill exactly 8 clusters
+    EXPECT_THAT(drive.first().toStdString(), HasSubstr("l2-cache-size=524288"));
+}
+
+TEST_F(TestQemuVMProcessSpec, throughputDiskProfileSizesL2CacheByImageClusterSize)
+{
+    QTemporaryDir temp_dir;
+    const auto image_path = temp_dir.filePath("image.qcow2");
+
+    QByteArray header(24, '\0');
+    qToBigEndian<quint32>(0x514649fb, header.data()); // "QFI\xfb"
+    qToBigEndian<quint32>(3, header.data() + 4);
+    qToBigEndian<quint32>(21, header.data() + 20); // 2MiB clusters
+
+    QFile image{image_path};
+    ASSERT_TRUE(image.open(QIODevice::WriteOnly));
+    ASSERT_EQ(image.write(header), header.size());
+    image.close();
+
+    auto throughput_desc = desc;
+    throughput_desc.disk_profile = mp::DiskProfile::throughput;
+    throughput_desc.image.image_path = image_path;
+
+    mp::QemuVMProcessSpec spec(throughput_desc, platform_args, mount_args, std::nullopt);
+
+    const auto drive = spec.arguments().filter("file=" + image_path);
+    ASSERT_EQ(drive.size(), 1);
+    // 2048 clusters take 16KiB of L2 table, rounded up to a whole cluster
+    EXPECT_THAT(drive.first().toStdString(), HasSubstr("l2-cache-size=2097152"));
+}
+
+TEST_F(TestQemuVMProcessSpec, throughputDiskProfileUsesNativeAioOnlyWithDirectIo)
+{
+    auto throughput_desc = desc;
+    throughput_desc.disk_profile = mp::DiskProfile::throughput;
+    mp::QemuVMProcessSpec spec(throughput_desc, platform_args, mount_args, std::nullopt);
+
+    const auto [mock_file_ops, guard] = mpt::MockFileOps::inject<NiceMock>();
+    auto direct_io = false;
+    ON_CALL(*mock_file_ops, open_fd).WillByDefault([&direct_io](const auto& path, int flags, int) {
+        const auto can_open = flags == O_RDONLY || direct_io;
+        return std::make_unique<mp::NamedFd>(path, can_open ? ::open("/dev/null", O_RDONLY) : -1);
+    });
+
+#ifdef MULTIPASS_PLATFORM_APPLE
+    EXPECT_THAT(spec.arguments().filter("file=/path/to/image").join("").toStdString(),
+                HasSubstr(",cache=none,aio=threads,"));
+#else
+    EXPECT_THAT(spec.arguments().filter("file=/path/to/image").join("").toStdString(),
+                HasSubstr(",cache=writeback,aio=threads,"));
+
+    direct_io = true;
+    EXPECT_THAT(spec.arguments().filter("file=/path/to/image").join("").toStdString(),
+                HasSubstr(",cache=none,aio=native,"));
+#endif
+}
+
+TEST_F(TestQemuVMProcessSpec, memoryDensityAddsMergeableRamAndBalloon)
+{
+    auto density_desc = desc;
+    density_desc.memory_density = true;
+
+    mp::QemuVMProcessSpec spec(density_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains("memory-backend-ram,id=ram0,size=3072M,merge=on"));
+    EXPECT_TRUE(args.contains("memory-backend=ram0"));
+    EXPECT_TRUE(
+        args.contains("virtio-balloon-pci,id=balloon0,free-page-reporting=on,deflate-on-oom=on"));
+}
+
+TEST_F(TestQemuVMProcessSpec, virtiofsMountsShareGuestMemoryWithTheirHelpers)
+{
+    const mp::QemuVirtualMachine::MountArgs virtiofs_mount_args{
+        {"m810e457178f448d9afffc9d950d726",
+         {"path/to/source",
+          {"-chardev",
+           "socket,id=m810e457178f448d9afffc9d950d726,path=/instance/m810e4571.sock",
+           "-device",
+           "vhost-user-fs-pci,chardev=m810e457178f448d9afffc9d950d726,tag="
+           "m810e457178f448d9afffc9d950d726"}}}};
+
+    mp::QemuVMProcessSpec spec(desc, platform_args, virtiofs_mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains("memory-backend-memfd,id=ram0,size=3072M,share=on"));
+    EXPECT_TRUE(args.contains("memory-backend=ram0"));
+    EXPECT_TRUE(args.endsWith(virtiofs_mount_args.begin()->second.second.last()));
+    EXPECT_THAT(spec.apparmor_profile().toStdString(),
+                HasSubstr("/instance/m810e4571.sock rw,"));
+}
+
+TEST_F(TestQemuVMProcessSpec, memoryDensityLeavesSharedRamUnmerged)
+{
+    const mp::QemuVirtualMachine::MountArgs virtiofs_mount_args{
+        {"m810e457178f448d9afffc9d950d726",
+         {"path/to/source",
+          {"-device",
+           "vhost-user-fs-pci,chardev=m810e457178f448d9afffc9d950d726,tag="
+           "m810e457178f448d9afffc9d950d726"}}}};
+    auto density_desc = desc;
+    density_desc.memory_density = true;
+
+    mp::QemuVMProcessSpec spec(density_desc, platform_args, virtiofs_mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains("memory-backend-memfd,id=ram0,size=3072M,share=on"));
+    EXPECT_TRUE(args.filter("merge=on").isEmpty());
+}
+
 TEST_F(TestQemuVMProcessSpec, resumeArgumentsTakenFromResumedata)
 {
     const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag",
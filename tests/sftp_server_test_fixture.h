@@ -36,14 +36,14 @@ struct SftpServerTest : public testing::Test
         reply_status.returnValue(SSH_OK);
         get_client_msg.returnValue(nullptr);
         handle_sftp.returnValue(nullptr);
-        reply_version.returnValue(SSH_OK);
+        channel_write.returnValue(SSH_OK);
     }
 
     decltype(MOCK(sftp_reply_status)) reply_status{MOCK(sftp_reply_status)};
     decltype(MOCK(sftp_get_client_message)) get_client_msg{MOCK(sftp_get_client_message)};
     decltype(MOCK(sftp_client_message_free)) msg_free{MOCK(sftp_client_message_free)};
     decltype(MOCK(sftp_handle)) handle_sftp{MOCK(sftp_handle)};
-    decltype(MOCK(sftp_reply_version)) reply_version{MOCK(sftp_reply_version)};
+    decltype(MOCK(ssh_channel_write)) channel_write{MOCK(ssh_channel_write)};
     MockScope<decltype(mock_sftp_server_free)> free_server_sftp;
 
     MockSSHTestFixture mock_ssh_test_fixture;
@@ -131,6 +131,10 @@ public:
         return process_state;
     }
 
+    void reload_apparmor_profile() override
+    {
+    }
+
     void setup_child_process() override
     {
     }
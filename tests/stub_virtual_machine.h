@@ -115,6 +115,18 @@ struct StubVirtualMachine final : public multipass::VirtualMachine
     {
     }
 
+    void set_disk_profile(DiskProfile) override
+    {
+    }
+
+    void set_memory_density(bool) override
+    {
+    }
+
+    void set_balloon_target(const MemorySize&) override
+    {
+    }
+
     void add_network_interface(int, const std::string&, const NetworkInterface&) override
     {
     }
@@ -170,6 +182,10 @@ struct StubVirtualMachine final : public multipass::VirtualMachine
     {
     }
 
+    void delete_snapshots(const std::vector<std::string>&) override
+    {
+    }
+
     void restore_snapshot(const std::string& name, VMSpecs& specs) override
     {
     }
@@ -233,8 +233,9 @@ TEST_F(AliasDictionary, mapDirWrongThrows)
 
     mpt::make_file_with_content(QString::fromStdString(db_filename()), file_contents);
 
+    mp::AliasDict dict(&trash_term);
     MP_ASSERT_THROW_THAT(
-        mp::AliasDict dict(&trash_term),
+        dict.size(),
         std::runtime_error,
         mpt::match_what(HasSubstr("invalid working_directory string \"wrong string\"")));
 }
@@ -405,11 +406,22 @@ TEST_F(AliasDictionary, throwsWhenOpenAliasFileFails)
     EXPECT_CALL(*mock_file_ops, exists(A<const QFile&>())).WillOnce(Return(true));
     EXPECT_CALL(*mock_file_ops, open(_, _)).WillOnce(Return(false));
 
-    MP_ASSERT_THROW_THAT(mp::AliasDict dict(&trash_term),
+    mp::AliasDict dict(&trash_term);
+    MP_ASSERT_THROW_THAT(dict.size(),
                          std::runtime_error,
                          mpt::match_what(HasSubstr("Error opening file '")));
 }
 
+TEST_F(AliasDictionary, doesNotReadFileUntilAccessed)
+{
+    auto [mock_file_ops, guard] = mpt::MockFileOps::inject();
+
+    EXPECT_CALL(*mock_file_ops, exists(A<const QFile&>())).Times(0);
+    EXPECT_CALL(*mock_file_ops, open(_, _)).Times(0);
+
+    mp::AliasDict dict(&trash_term);
+}
+
 struct FormatterTestsuite
     : public AliasDictionary,
       public WithParamInterface<
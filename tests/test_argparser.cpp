@@ -82,7 +82,7 @@ TEST_P(TestAliasArguments, testAliasArguments)
 
     mp::AliasDict alias_dict(&term);
     auto parser = mp::ArgParser{pre, cmds, oss, oss};
-    const auto& result = parser.parse(alias_dict);
+    const auto& result = parser.parse(&alias_dict);
 
     ASSERT_EQ(result, mp::ParseCode::Ok) << "Failed to parse given arguments";
 
@@ -63,6 +63,7 @@ struct MockBaseVirtualMachine : public mpt::MockVirtualMachineT<mp::BaseVirtualM
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, take_snapshot, mp::BaseVirtualMachine);
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, rename_snapshot, mp::BaseVirtualMachine);
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, delete_snapshot, mp::BaseVirtualMachine);
+        MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, delete_snapshots, mp::BaseVirtualMachine);
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, restore_snapshot, mp::BaseVirtualMachine);
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, load_snapshots, mp::BaseVirtualMachine);
         MP_DELEGATE_MOCK_CALLS_ON_BASE(*this, get_childrens_names, mp::BaseVirtualMachine);
@@ -649,20 +650,26 @@ TEST_F(BaseVM, providesChildrenNames)
 
     constexpr auto name_template = "s{}";
     const auto num_snapshots = 5;
-    const mp::VMSpecs specs{};
-    for (int i = 0; i < num_snapshots; ++i)
-        vm.take_snapshot(specs, fmt::format(name_template, i), "");
+    mp::VMSpecs specs{};
+    const auto root_name = fmt::format(name_template, 0);
+    vm.take_snapshot(specs, root_name, "");
 
-    ASSERT_EQ(snapshot_album.size(), num_snapshots);
+    std::unordered_map<std::string, mp::VMMount> mounts;
+    EXPECT_CALL(*snapshot_album[0], get_mounts).WillRepeatedly(ReturnRef(mounts));
+
+    QJsonObject metadata{};
+    EXPECT_CALL(*snapshot_album[0], get_metadata).WillRepeatedly(ReturnRef(metadata));
 
     std::vector<std::string> expected_children_names{};
     for (int i = 1; i < num_snapshots; ++i)
     {
-        EXPECT_CALL(Const(*snapshot_album[i]), get_parent())
-            .WillRepeatedly(Return(snapshot_album[0]));
+        vm.restore_snapshot(root_name, specs); // branch off the root every time
+        vm.take_snapshot(specs, fmt::format(name_template, i), "");
         expected_children_names.push_back(fmt::format(name_template, i));
     }
 
+    ASSERT_EQ(snapshot_album.size(), num_snapshots);
+
     EXPECT_THAT(vm.get_childrens_names(snapshot_album[0].get()),
                 UnorderedElementsAreArray(expected_children_names));
 
@@ -672,6 +679,92 @@ TEST_F(BaseVM, providesChildrenNames)
     }
 }
 
+TEST_F(BaseVM, childrenOfDeletedSnapshotAreAdoptedByItsParent)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    for (const auto* name : {"s1", "s2", "s3"})
+        vm.take_snapshot(specs, name, "");
+
+    vm.delete_snapshot("s2");
+
+    EXPECT_THAT(vm.get_childrens_names(snapshot_album[0].get()), ElementsAre("s3"));
+    EXPECT_THAT(vm.get_childrens_names(nullptr), ElementsAre("s1"));
+}
+
+TEST_F(BaseVM, batchDeletionReparentsEachSurvivorOnce)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    for (const auto* name : {"s1", "s2", "s3", "s4"})
+        vm.take_snapshot(specs, name, "");
+
+    ASSERT_EQ(snapshot_album.size(), 4);
+
+    EXPECT_CALL(*snapshot_album[1], erase).Times(1);
+    EXPECT_CALL(*snapshot_album[2], erase).Times(1);
+    EXPECT_CALL(*snapshot_album[3], set_parent(Eq(snapshot_album[0]))).Times(1);
+
+    vm.delete_snapshots({"s2", "s3"});
+
+    EXPECT_EQ(vm.get_num_snapshots(), 2);
+    EXPECT_THAT(vm.get_childrens_names(snapshot_album[0].get()), ElementsAre("s4"));
+}
+
+TEST_F(BaseVM, batchDeletionMovesHeadToClosestSurvivor)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    for (const auto* name : {"s1", "s2", "s3"})
+        vm.take_snapshot(specs, name, "");
+
+    vm.delete_snapshots({"s3", "s2"});
+
+    EXPECT_THAT(mpt::load(head_path).toStdString(), make_index_file_contents_matcher(1));
+    EXPECT_EQ(vm.take_snapshot(specs, "s4", "")->get_parent(), snapshot_album[0]);
+}
+
+TEST_F(BaseVM, batchDeletionThrowsOnMissingSnapshotWithoutDeletingAny)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    vm.take_snapshot(specs, "s1", "");
+
+    EXPECT_CALL(*snapshot_album[0], erase).Times(0);
+    MP_EXPECT_THROW_THAT(vm.delete_snapshots({"s1", "missing"}),
+                         mp::NoSuchSnapshotException,
+                         mpt::match_what(HasSubstr("missing")));
+
+    EXPECT_EQ(vm.get_num_snapshots(), 1);
+}
+
+TEST_F(BaseVM, batchDeletionKeepsSnapshotsThatFailedToErase)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    for (const auto* name : {"s1", "s2", "s3", "s4"})
+        vm.take_snapshot(specs, name, "");
+
+    ASSERT_EQ(snapshot_album.size(), 4);
+
+    // children are erased first, so s3 goes before s2 fails
+    EXPECT_CALL(*snapshot_album[2], erase).Times(1);
+    EXPECT_CALL(*snapshot_album[1], erase).WillOnce(Throw(std::runtime_error{"intentional"}));
+    EXPECT_CALL(*snapshot_album[3], set_parent(Eq(snapshot_album[0]))).Times(1);
+    // back to a survivor
+    EXPECT_CALL(*snapshot_album[3], set_parent(Eq(snapshot_album[1]))).Times(1);
+
+    EXPECT_ANY_THROW(vm.delete_snapshots({"s2", "s3"}));
+
+    EXPECT_EQ(vm.get_num_snapshots(), 3);
+    EXPECT_THAT(vm.get_childrens_names(snapshot_album[1].get()), ElementsAre("s4"));
+}
+
 TEST_F(BaseVM, renamesSnapshot)
 {
     const std::string old_name = "initial";
@@ -186,6 +186,16 @@ struct MockDaemonRpc : public mp::DaemonRpc
                 (grpc::ServerContext * context,
                  (grpc::ServerReaderWriter<mp::WaitReadyReply, mp::WaitReadyRequest> * server)),
                 (override));
+    MOCK_METHOD(grpc::Status,
+                metrics,
+                (grpc::ServerContext * context,
+                 (grpc::ServerReaderWriter<mp::MetricsReply, mp::MetricsRequest> * server)),
+                (override));
+    MOCK_METHOD(grpc::Status,
+                watch,
+                (grpc::ServerContext * context,
+                 (grpc::ServerReaderWriter<mp::WatchReply, mp::WatchRequest> * server)),
+                (override));
 };
 
 struct Client : public Test
@@ -2076,6 +2086,71 @@ TEST_F(Client, listCmdFailsWithIpv4AndSnapshots)
                 Eq(mp::ReturnCode::CommandLineError));
 }
 
+TEST_F(Client, listCmdWatchListsAgainOnChanges)
+{
+    EXPECT_CALL(mock_daemon, watch)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::WatchReply, mp::WatchRequest>* server) {
+            mp::WatchReply snapshot;
+            auto* foo = snapshot.mutable_snapshot()->add_instances();
+            foo->set_name("foo");
+            foo->mutable_instance_status()->set_status(mp::InstanceStatus::RUNNING);
+            server->Write(snapshot);
+
+            mp::WatchReply changes;
+            auto* stopped = changes.add_changes();
+            *stopped->mutable_instance() = *foo;
+            stopped->mutable_instance()->mutable_instance_status()->set_status(
+                mp::InstanceStatus::STOPPED);
+            stopped->set_state_changed(true);
+            auto* added = changes.add_changes();
+            added->mutable_instance()->set_name("bar");
+            added->set_state_changed(true);
+            server->Write(changes);
+
+            server->Write(mp::WatchReply{}); // nothing changed, nothing to list again
+            return grpc::Status{};
+        });
+
+    std::stringstream cout_stream;
+    EXPECT_THAT(send_command({"list", "--watch", "--format", "csv"}, cout_stream),
+                Eq(mp::ReturnCode::Ok));
+    EXPECT_EQ(cout_stream.str(),
+              "Name,State,IPv4,Release,AllIPv4\n"
+              "foo,Running,,Not Available,\"\"\n"
+              "Name,State,IPv4,Release,AllIPv4\n"
+              "bar,Unknown,,Not Available,\"\"\n"
+              "foo,Stopped,,Not Available,\"\"\n");
+}
+
+TEST_F(Client, listCmdWatchDropsRemovedInstances)
+{
+    EXPECT_CALL(mock_daemon, watch)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::WatchReply, mp::WatchRequest>* server) {
+            mp::WatchReply snapshot;
+            snapshot.mutable_snapshot()->add_instances()->set_name("foo");
+            server->Write(snapshot);
+
+            mp::WatchReply changes;
+            auto* removed = changes.add_changes();
+            removed->mutable_instance()->set_name("foo");
+            removed->set_removed(true);
+            server->Write(changes);
+
+            return grpc::Status{};
+        });
+
+    std::stringstream cout_stream;
+    EXPECT_THAT(send_command({"list", "--watch", "--format", "csv"}, cout_stream),
+                Eq(mp::ReturnCode::Ok));
+    EXPECT_THAT(cout_stream.str(), EndsWith("Name,State,IPv4,Release,AllIPv4\n"));
+}
+
+TEST_F(Client, listCmdFailsWithWatchAndSnapshots)
+{
+    EXPECT_THAT(send_command({"list", "--watch", "--snapshots"}),
+                Eq(mp::ReturnCode::CommandLineError));
+}
+
 // mount cli tests
 // Note: mpt::test_data_path() returns an absolute path
 TEST_F(Client, mountCmdGoodAbsoluteSourcePath)
@@ -3348,6 +3423,27 @@ TEST_F(Client, waitReadyCmdWithTimeoutFailsWhenDaemonFails)
     EXPECT_THAT(send_command({"wait-ready", "--timeout", "10"}), Eq(mp::ReturnCode::CommandFail));
 }
 
+// metrics cli tests
+TEST_F(Client, metricsCmdPrintsMetrics)
+{
+    EXPECT_CALL(mock_daemon, metrics)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::MetricsReply, mp::MetricsRequest>* server) {
+            mp::MetricsReply reply;
+            reply.set_metrics("multipass_ssh_execs_total 3\n");
+            server->Write(reply);
+            return grpc::Status{};
+        });
+
+    std::stringstream cout_stream;
+    EXPECT_THAT(send_command({"metrics"}, cout_stream), Eq(mp::ReturnCode::Ok));
+    EXPECT_EQ(cout_stream.str(), "multipass_ssh_execs_total 3\n");
+}
+
+TEST_F(Client, metricsCmdFailsWithArgs)
+{
+    EXPECT_THAT(send_command({"metrics", "foo"}), Eq(mp::ReturnCode::CommandLineError));
+}
+
 // get/set cli tests
 struct TestGetSetHelp : Client, WithParamInterface<std::string>
 {
@@ -256,6 +256,13 @@ TEST_F(Daemon, receivesCommandsAndCallsCorrespondingSlot)
         .WillOnce(
             Invoke(&daemon,
                    &mpt::MockDaemon::set_promise_value<mp::WaitReadyRequest, mp::WaitReadyReply>));
+    EXPECT_CALL(daemon, metrics(_, _, _))
+        .WillOnce(
+            Invoke(&daemon,
+                   &mpt::MockDaemon::set_promise_value<mp::MetricsRequest, mp::MetricsReply>));
+    EXPECT_CALL(daemon, watch(_, _, _))
+        .WillOnce(Invoke(&daemon,
+                         &mpt::MockDaemon::set_promise_value<mp::WatchRequest, mp::WatchReply>));
     EXPECT_CALL(mock_settings, get(Eq("foo"))).WillRepeatedly(Return("bar"));
 
     send_commands({{"test_keys"},
@@ -281,7 +288,9 @@ TEST_F(Daemon, receivesCommandsAndCallsCorrespondingSlot)
                    {"umount", "instance"},
                    {"networks"},
                    {"clone", "foo"},
-                   {"wait-ready"}});
+                   {"wait-ready"},
+                   {"metrics"},
+                   {"list", "--watch"}});
 }
 
 TEST_F(Daemon, providesVersion)
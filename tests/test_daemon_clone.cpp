@@ -195,3 +195,46 @@ TEST_F(TestDaemonClone, successfulCloneGenerateDestNameButThrowLater)
     EXPECT_EQ(status.error_code(), grpc::StatusCode::INTERNAL);
     EXPECT_EQ(status.error_message(), "intentional");
 }
+
+TEST_F(TestDaemonClone, cloneStreamsCopyProgress)
+{
+    const auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state).WillOnce(Return(mp::VirtualMachine::State::stopped));
+    EXPECT_CALL(mock_factory, clone_instance_files)
+        .WillOnce([](const auto&, const auto&, const mp::ProgressMonitor& monitor) {
+            EXPECT_TRUE(monitor(0, 42));
+        });
+
+    NiceMock<mpt::MockServerReaderWriter<mp::CloneReply, mp::CloneRequest>> mock_server;
+    EXPECT_CALL(mock_server, Write(Property(&mp::CloneReply::percent_complete, Eq("42")), _))
+        .WillOnce(Return(true));
+
+    mp::CloneRequest request{};
+    request.set_source_name(mock_src_instance_name);
+
+    const auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, mock_server);
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::OK);
+}
+
+TEST_F(TestDaemonClone, failedCopyDoesNotCreateInstance)
+{
+    const auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state).WillOnce(Return(mp::VirtualMachine::State::stopped));
+    EXPECT_CALL(mock_factory, clone_instance_files)
+        .WillOnce(Throw(std::runtime_error("Clone cancelled")));
+    EXPECT_CALL(mock_factory, clone_bare_vm).Times(0);
+    EXPECT_CALL(mock_factory, remove_resources_for("real-zebraphant-clone1"));
+
+    mp::CloneRequest request{};
+    request.set_source_name(mock_src_instance_name);
+
+    const auto status =
+        call_daemon_slot(*daemon,
+                         &mp::Daemon::clone,
+                         request,
+                         NiceMock<mpt::MockServerReaderWriter<mp::CloneReply, mp::CloneRequest>>{});
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INTERNAL);
+    EXPECT_EQ(status.error_message(), "Clone cancelled");
+}
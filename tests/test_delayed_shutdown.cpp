@@ -22,6 +22,7 @@
 
 #include <multipass/delayed_shutdown_timer.h>
 #include <multipass/exceptions/ssh_exception.h>
+#include <multipass/metrics.h>
 #include <multipass/signal.h>
 
 #include <QEventLoop>
@@ -124,6 +125,17 @@ TEST_F(DelayedShutdown, emitsFinishedWithNoTimer)
     EXPECT_TRUE(finish_invoked);
 }
 
+TEST_F(DelayedShutdown, observesHowLongStoppingTook)
+{
+    auto& durations = MP_METRICS.instance_operation_durations.with("stop");
+    const auto before = durations.count();
+
+    mp::DelayedShutdownTimer delayed_shutdown_timer{vm.get(), [](const std::string&) {}};
+    delayed_shutdown_timer.start(std::chrono::milliseconds::zero());
+
+    EXPECT_EQ(durations.count(), before + 1);
+}
+
 TEST_F(DelayedShutdown, vmStateDelayedShutdownWhenTimerRunning)
 {
     auto add_channel_cbs = [this](ssh_channel, ssh_channel_callbacks cb) {
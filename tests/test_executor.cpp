@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <multipass/executor.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mp = multipass;
+namespace mpt = mp::test;
+
+using namespace testing;
+
+namespace
+{
+TEST(Executor, runReturnsTheResult)
+{
+    auto future = MP_EXECUTOR.run(mp::Lane::blocking, [](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(future.result(), 5);
+}
+
+TEST(Executor, lanesHaveTheirOwnThreads)
+{
+    const auto cpu = MP_EXECUTOR.stats(mp::Lane::cpu);
+    const auto blocking = MP_EXECUTOR.stats(mp::Lane::blocking);
+
+    EXPECT_GT(cpu.max_threads, 0);
+    EXPECT_GE(blocking.max_threads, cpu.max_threads);
+}
+
+TEST(Executor, tasksKnowTheirLane)
+{
+    EXPECT_EQ(mp::Executor::current_lane(), std::nullopt);
+    EXPECT_EQ(MP_EXECUTOR.run(mp::Lane::cpu, &mp::Executor::current_lane).result(),
+              mp::Lane::cpu);
+
+    const auto outer = MP_EXECUTOR.run(mp::Lane::blocking, [] {
+        auto inner = MP_EXECUTOR.run(mp::Lane::cpu, &mp::Executor::current_lane);
+        MP_EXECUTOR.wait_for(mp::Lane::blocking, inner);
+        return std::pair{inner.result(), mp::Executor::current_lane()};
+    });
+    const auto [inner_lane, outer_lane] = outer.result();
+    EXPECT_EQ(inner_lane, mp::Lane::cpu);
+    EXPECT_EQ(outer_lane, mp::Lane::blocking); // even if the inner task ran in the same thread
+}
+
+TEST(Executor, runCountsCompletedTasks)
+{
+    const auto before = MP_EXECUTOR.stats(mp::Lane::blocking).completed;
+
+    QFutureSynchronizer<void> synchronizer;
+    for (int i = 0; i < 3; ++i)
+        synchronizer.addFuture(MP_EXECUTOR.run(mp::Lane::blocking, [] {}));
+    synchronizer.waitForFinished();
+
+    const auto stats = MP_EXECUTOR.stats(mp::Lane::blocking);
+    EXPECT_GE(stats.completed, before + 3);
+    EXPECT_GT(stats.max_threads, 0);
+    EXPECT_GE(stats.max_queue_wait, std::chrono::microseconds::zero());
+}
+
+TEST(Executor, waitForDoneGivesUpAfterTheTimeout)
+{
+    std::atomic_bool release{false};
+    const auto future = MP_EXECUTOR.run(mp::Lane::blocking, [&release] {
+        while (!release)
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    });
+
+    EXPECT_FALSE(MP_EXECUTOR.wait_for_done(std::chrono::milliseconds{10}));
+
+    release = true;
+    EXPECT_TRUE(MP_EXECUTOR.wait_for_done(std::chrono::seconds{10}));
+    EXPECT_TRUE(future.isFinished());
+}
+
+TEST(Executor, cancelledTokenIsSeenByAllCopies)
+{
+    mp::CancellationToken token;
+    const auto copy = token;
+
+    ASSERT_FALSE(copy.is_cancelled());
+    token.cancel();
+    EXPECT_TRUE(copy.is_cancelled());
+}
+
+TEST(Executor, waitForLendsTheLaneAThread)
+{
+    // Every task of the lane waits on another task of the same lane, which only ever gets to run
+    // because the waiting ones step aside
+    const auto num_tasks = MP_EXECUTOR.stats(mp::Lane::blocking).max_threads;
+
+    QFutureSynchronizer<int> synchronizer;
+    for (int i = 0; i < num_tasks; ++i)
+        synchronizer.addFuture(MP_EXECUTOR.run(mp::Lane::blocking, [i] {
+            auto inner = MP_EXECUTOR.run(mp::Lane::blocking, [i] { return i; });
+            MP_EXECUTOR.wait_for(mp::Lane::blocking, inner);
+            return inner.result();
+        }));
+    synchronizer.waitForFinished();
+
+    int sum = 0;
+    for (const auto& future : synchronizer.futures())
+        sum += future.result();
+    EXPECT_EQ(sum, num_tasks * (num_tasks - 1) / 2);
+}
+
+TEST(Executor, waitForRethrowsAfterAllFinish)
+{
+    std::atomic_int finished{0};
+
+    std::vector<QFuture<void>> futures;
+    futures.push_back(
+        MP_EXECUTOR.run(mp::Lane::blocking, [] { throw std::runtime_error{"fail"}; }));
+    for (int i = 0; i < 5; ++i)
+        futures.push_back(MP_EXECUTOR.run(mp::Lane::blocking, [&finished] { ++finished; }));
+
+    MP_EXPECT_THROW_THAT(MP_EXECUTOR.wait_for(mp::Lane::blocking, futures),
+                         std::runtime_error,
+                         mpt::match_what(StrEq("fail")));
+    EXPECT_EQ(finished, 5);
+}
+
+TEST(Executor, parallelTransformKeepsOrderAndDropsDefaults)
+{
+    const std::vector<int> input{1, 0, 2, 0, 3};
+
+    const auto output = mp::utils::parallel_transform(input, [](int i) { return 10 * i; });
+
+    EXPECT_THAT(output, ElementsAre(10, 20, 30));
+}
+
+TEST(Executor, parallelForEachVisitsEveryItem)
+{
+    std::vector<int> items(20, 1);
+
+    mp::utils::parallel_for_each(items, [](int& item) { item *= 2; });
+
+    EXPECT_THAT(items, Each(2));
+}
+} // namespace
@@ -175,6 +175,7 @@ TEST_F(TestGlobalSettingsHandlers, clientsDoNotRegisterPersistentHandlerForDaemo
     assert_unrecognized_keys(mp::driver_key,
                              mp::bridged_interface_key,
                              mp::mounts_key,
+                             mp::mount_caching_key,
                              mp::passphrase_key);
 }
 
@@ -238,8 +239,10 @@ TEST_F(TestGlobalSettingsHandlers, daemonRegistersPersistentHandlerForDaemonSett
     mp::daemon::register_global_settings_handlers();
     inject_default_returning_mock_qsettings();
 
-    expect_setting_values(
-        {{mp::driver_key, driver}, {mp::bridged_interface_key, ""}, {mp::mounts_key, mount}});
+    expect_setting_values({{mp::driver_key, driver},
+                           {mp::bridged_interface_key, ""},
+                           {mp::mounts_key, mount},
+                           {mp::mount_caching_key, "false"}});
 }
 
 TEST_F(TestGlobalSettingsHandlers, daemonRegistersPersistentHandlerForDaemonPlatformSettings)
@@ -43,3 +43,31 @@ INSTANTIATE_TEST_SUITE_P(IdMappings,
                                                mp::id_mappings{{1, 1}}),
                                 std::make_pair(mp::id_mappings{{3, 4}}, mp::id_mappings{{3, 4}}),
                                 std::make_pair(mp::id_mappings{}, mp::id_mappings{})));
+
+TEST(IdMap, looksUpBothDirections)
+{
+    const mp::IdMap id_map{{{1000, 1001}, {1002, 1003}}, 1000};
+
+    EXPECT_EQ(id_map.instance_id_for(1002), 1003);
+    EXPECT_EQ(id_map.host_id_for(1001), 1000);
+    EXPECT_EQ(id_map.instance_id_for(1001), std::nullopt);
+    EXPECT_EQ(id_map.host_id_for(1000), std::nullopt);
+}
+
+TEST(IdMap, resolvesDefaultInstanceIdUpFront)
+{
+    const mp::IdMap id_map{{{501, mp::default_id}}, 1000};
+
+    EXPECT_EQ(id_map.instance_id_for(501), 1000);
+    EXPECT_EQ(id_map.host_id_for(mp::default_id), 501);
+    EXPECT_EQ(id_map.host_id_for(1000), std::nullopt);
+}
+
+TEST(IdMap, firstMappingForAnIdWins)
+{
+    const mp::IdMap id_map{{{1, 2}, {1, 3}, {4, 2}}, 1000};
+
+    EXPECT_EQ(id_map.instance_id_for(1), 2);
+    EXPECT_EQ(id_map.host_id_for(2), 1);
+    EXPECT_EQ(id_map.host_id_for(3), 1);
+}
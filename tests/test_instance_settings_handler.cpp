@@ -43,6 +43,7 @@ enum class SpecialInstanceState
 {
     none,
     preparing,
+    cloning,
     deleted
 };
 using InstanceName = const char*;
@@ -55,6 +56,7 @@ struct TestInstanceSettingsHandler : public Test
                                            vms,
                                            deleted_vms,
                                            preparing_vms,
+                                           cloning_vms,
                                            make_fake_persister(),
                                            make_fake_is_bridged(),
                                            make_fake_add()};
@@ -64,6 +66,8 @@ struct TestInstanceSettingsHandler : public Test
     {
         if (special_state == SpecialInstanceState::preparing)
             preparing_vms.emplace(name);
+        else if (special_state == SpecialInstanceState::cloning)
+            cloning_vms.emplace(name);
         else if (special_state == SpecialInstanceState::deleted)
             deleted_vms[name];
     }
@@ -138,12 +142,18 @@ struct TestInstanceSettingsHandler : public Test
     std::unordered_map<std::string, mp::VirtualMachine::ShPtr> vms;
     std::unordered_map<std::string, mp::VirtualMachine::ShPtr> deleted_vms;
     std::unordered_set<std::string> preparing_vms;
+    std::unordered_multiset<std::string> cloning_vms;
     std::string bridged_interface{"eth8"};
     bool fake_persister_called = false;
     bool user_authorized = true;
     inline static constexpr std::array numeric_properties{"cpus", "disk", "memory"};
-    inline static constexpr std::array boolean_properties{"bridged"};
-    inline static constexpr std::array properties{"cpus", "disk", "memory", "bridged"};
+    inline static constexpr std::array boolean_properties{"bridged", "memory-density"};
+    inline static constexpr std::array properties{"cpus",
+                                                  "disk",
+                                                  "memory",
+                                                  "disk-profile",
+                                                  "memory-density",
+                                                  "bridged"};
 };
 
 QString make_key(const QString& instance_name, const QString& property)
@@ -570,6 +580,60 @@ TEST_F(TestInstanceSettingsHandler, setDoesNotAddTwoInterfaces)
     EXPECT_EQ(specs[target_instance_name].extra_interfaces.size(), 1u);
 }
 
+TEST_F(TestInstanceSettingsHandler, getReturnsDiskProfile)
+{
+    constexpr auto target_instance_name = "Ravel";
+    specs[target_instance_name].disk_profile = mp::DiskProfile::throughput;
+    specs["Satie"];
+
+    const auto handler = make_handler();
+
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "disk-profile")), "throughput");
+    EXPECT_EQ(handler.get(make_key("Satie", "disk-profile")), "default");
+}
+
+TEST_F(TestInstanceSettingsHandler, setChangesDiskProfile)
+{
+    constexpr auto target_instance_name = "Debussy";
+    specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_disk_profile(mp::DiskProfile::throughput));
+
+    make_handler().set(make_key(target_instance_name, "disk-profile"), "throughput");
+
+    EXPECT_EQ(specs[target_instance_name].disk_profile, mp::DiskProfile::throughput);
+    EXPECT_TRUE(fake_persister_called);
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesUnknownDiskProfile)
+{
+    constexpr auto target_instance_name = "Faure";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_disk_profile).Times(0);
+
+    MP_EXPECT_THROW_THAT(make_handler().set(make_key(target_instance_name, "disk-profile"), "fast"),
+                         mp::InvalidSettingException,
+                         mpt::match_what(HasSubstr("default, throughput")));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
+TEST_F(TestInstanceSettingsHandler, setTogglesMemoryDensity)
+{
+    constexpr auto target_instance_name = "Chopin";
+    specs[target_instance_name];
+    auto& target_instance = mock_vm(target_instance_name);
+
+    EXPECT_CALL(target_instance, set_memory_density(true));
+
+    auto handler = make_handler();
+    handler.set(make_key(target_instance_name, "memory-density"), "on");
+
+    EXPECT_TRUE(specs[target_instance_name].memory_density);
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-density")), "true");
+}
+
 using VMSt = mp::VirtualMachine::State;
 using Property = const char*;
 using PropertyAndState = std::tuple<Property, VMSt>; // no subliminal political msg intended :)
@@ -587,6 +651,9 @@ TEST_P(TestInstanceModOnNonStoppedInstance, setRefusesToModifyNonStoppedInstance
 
     auto& target_instance = mock_vm<StrictMock>(target_instance_name);
     EXPECT_CALL(target_instance, current_state).WillOnce(Return(state));
+    EXPECT_CALL(target_instance, live_resize_limits)
+        .Times(AtMost(1))
+        .WillRepeatedly(Return(std::nullopt));
 
     MP_EXPECT_THROW_THAT(
         make_handler().set(make_key(target_instance_name, property), "123"),
@@ -607,6 +674,52 @@ INSTANTIATE_TEST_SUITE_P(TestInstanceSettingsHandler,
                                         VMSt::suspending,
                                         VMSt::unknown)));
 
+TEST_F(TestInstanceSettingsHandler, setAppliesLiveResizeWithinLimits)
+{
+    constexpr auto target_instance_name = "Haydn";
+    auto& target_specs = specs[target_instance_name];
+    target_specs.num_cores = 2;
+    target_specs.mem_size = mp::MemorySize{"1G"};
+
+    auto& target_instance = mock_vm(target_instance_name);
+    EXPECT_CALL(target_instance, current_state).WillRepeatedly(Return(VMSt::running));
+    EXPECT_CALL(target_instance, live_resize_limits)
+        .WillRepeatedly(Return(mp::VirtualMachine::LiveResizeLimits{2,
+                                                                    8,
+                                                                    mp::MemorySize{"1G"},
+                                                                    mp::MemorySize{"8G"}}));
+    EXPECT_CALL(target_instance, update_cpus(4));
+    EXPECT_CALL(target_instance, resize_memory(Eq(mp::MemorySize{"4G"})));
+
+    make_handler().set(make_key(target_instance_name, "cpus"), "4");
+    make_handler().set(make_key(target_instance_name, "memory"), "4G");
+
+    EXPECT_EQ(target_specs.num_cores, 4);
+    EXPECT_EQ(target_specs.mem_size, mp::MemorySize{"4G"});
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesLiveResizeBeyondLimits)
+{
+    constexpr auto target_instance_name = "Handel";
+    specs[target_instance_name].num_cores = 2;
+    const auto original_specs = specs[target_instance_name];
+
+    auto& target_instance = mock_vm(target_instance_name);
+    EXPECT_CALL(target_instance, current_state).WillOnce(Return(VMSt::running));
+    EXPECT_CALL(target_instance, live_resize_limits)
+        .WillOnce(Return(mp::VirtualMachine::LiveResizeLimits{2,
+                                                              8,
+                                                              mp::MemorySize{"1G"},
+                                                              mp::MemorySize{"8G"}}));
+    EXPECT_CALL(target_instance, update_cpus).Times(0);
+
+    MP_EXPECT_THROW_THAT(make_handler().set(make_key(target_instance_name, "cpus"), "16"),
+                         mp::InstanceStateSettingsException,
+                         mpt::match_what(HasSubstr("Instance must be stopped for values outside")));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
 struct TestInstanceModOnStoppedInstance : public TestInstanceSettingsHandler,
                                           public WithParamInterface<PropertyAndState>
 {
@@ -658,19 +771,24 @@ INSTANTIATE_TEST_SUITE_P(TestInstanceSettingsHandler,
 
 TEST_F(TestInstanceSettingsHandler, setRefusesToModifyInstancesInSpecialState)
 {
-    constexpr auto preparing_instance_name = "Yann", deleted_instance_name = "Tiersen";
+    constexpr auto preparing_instance_name = "Yann", cloning_instance_name = "Comptine",
+                   deleted_instance_name = "Tiersen";
     specs[preparing_instance_name];
+    specs[cloning_instance_name];
     specs[deleted_instance_name];
     const auto original_specs = specs;
 
     fake_instance_state(preparing_instance_name, SpecialInstanceState::preparing);
+    fake_instance_state(cloning_instance_name, SpecialInstanceState::cloning);
     auto& preparing_instance = mock_vm(preparing_instance_name);
+    auto& cloning_instance = mock_vm(cloning_instance_name);
     auto& deleted_instance = mock_vm(deleted_instance_name, /*deleted=*/true);
 
     auto handler = make_handler();
 
     for (const auto& [instance, instance_name, special_state] :
          {std::tuple{&preparing_instance, preparing_instance_name, "prepared"},
+          std::tuple{&cloning_instance, cloning_instance_name, "cloned"},
           std::tuple{&deleted_instance, deleted_instance_name, "deleted"}})
     {
         EXPECT_CALL(*instance, update_cpus).Times(0);
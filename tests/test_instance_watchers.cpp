@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <src/daemon/instance_watchers.h>
+
+#include <thread>
+
+namespace mp = multipass;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+using Change = mp::InstanceWatchers::Change;
+
+mp::ListVMInstance instance(const std::string& name, mp::InstanceStatus::Status status)
+{
+    mp::ListVMInstance instance;
+    instance.set_name(name);
+    instance.mutable_instance_status()->set_status(status);
+    return instance;
+}
+
+struct InstanceWatchers : public Test
+{
+    std::unique_ptr<mp::InstanceWatchers::Subscription> subscribe()
+    {
+        mp::WatchReply first_reply;
+        return watchers.subscribe(first_reply);
+    }
+
+    mp::InstanceWatchers watchers;
+};
+
+TEST_F(InstanceWatchers, firstReplyHoldsTheInstances)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::RUNNING));
+    watchers.put(instance("bar", mp::InstanceStatus::STOPPED));
+
+    mp::WatchReply first_reply;
+    auto subscription = watchers.subscribe(first_reply);
+
+    ASSERT_TRUE(first_reply.has_snapshot());
+    EXPECT_EQ(first_reply.snapshot().instances_size(), 2);
+    EXPECT_THAT(first_reply.changes(), IsEmpty());
+}
+
+TEST_F(InstanceWatchers, firstReplyHasSnapshotWithoutInstances)
+{
+    mp::WatchReply first_reply;
+    auto subscription = watchers.subscribe(first_reply);
+
+    EXPECT_TRUE(first_reply.has_snapshot());
+}
+
+TEST_F(InstanceWatchers, changesToAnInstanceMerge)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED));
+    auto subscription = subscribe();
+
+    watchers.set_status("foo", mp::InstanceStatus::STARTING);
+    watchers.notify("foo", Change::mounts);
+    watchers.set_status("foo", mp::InstanceStatus::RUNNING);
+
+    const auto reply = subscription->next(0ms);
+    ASSERT_TRUE(reply);
+    ASSERT_EQ(reply->changes_size(), 1);
+
+    const auto& change = reply->changes(0);
+    EXPECT_EQ(change.instance().instance_status().status(), mp::InstanceStatus::RUNNING);
+    EXPECT_TRUE(change.state_changed());
+    EXPECT_TRUE(change.mounts_changed());
+    EXPECT_FALSE(change.metadata_changed());
+    EXPECT_FALSE(change.snapshots_changed());
+    EXPECT_FALSE(change.removed());
+}
+
+TEST_F(InstanceWatchers, changesAreTakenOnce)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED));
+    auto subscription = subscribe();
+
+    watchers.notify("foo", Change::snapshots);
+    EXPECT_EQ(subscription->next(0ms)->changes_size(), 1);
+    EXPECT_EQ(subscription->next(0ms)->changes_size(), 0);
+}
+
+TEST_F(InstanceWatchers, sameStatusIsNoChange)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::RUNNING));
+    auto subscription = subscribe();
+
+    watchers.set_status("foo", mp::InstanceStatus::RUNNING);
+
+    EXPECT_EQ(subscription->next(0ms)->changes_size(), 0);
+}
+
+TEST_F(InstanceWatchers, unknownInstancesAreIgnored)
+{
+    auto subscription = subscribe();
+
+    watchers.set_status("foo", mp::InstanceStatus::RUNNING);
+    watchers.notify("foo", Change::metadata);
+    watchers.remove("foo");
+
+    EXPECT_EQ(subscription->next(0ms)->changes_size(), 0);
+}
+
+TEST_F(InstanceWatchers, deletedInstancesKeepTheirStatus)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::DELETED));
+    auto subscription = subscribe();
+
+    watchers.set_status("foo", mp::InstanceStatus::STOPPED);
+    EXPECT_EQ(subscription->next(0ms)->changes_size(), 0);
+
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED)); // recovered
+    EXPECT_EQ(subscription->next(0ms)->changes(0).instance().instance_status().status(),
+              mp::InstanceStatus::STOPPED);
+}
+
+TEST_F(InstanceWatchers, removedInstancesAreReportedAsSuch)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED));
+    auto subscription = subscribe();
+
+    watchers.notify("foo", Change::metadata);
+    watchers.remove("foo");
+
+    const auto reply = subscription->next(0ms);
+    ASSERT_EQ(reply->changes_size(), 1);
+    EXPECT_EQ(reply->changes(0).instance().name(), "foo");
+    EXPECT_TRUE(reply->changes(0).removed());
+}
+
+TEST_F(InstanceWatchers, eachSubscriptionGetsTheChanges)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED));
+    auto first = subscribe();
+    auto second = subscribe();
+
+    watchers.notify("foo", Change::metadata);
+
+    EXPECT_EQ(first->next(0ms)->changes_size(), 1);
+    EXPECT_EQ(second->next(0ms)->changes_size(), 1);
+}
+
+TEST_F(InstanceWatchers, nextWakesUpOnChanges)
+{
+    watchers.put(instance("foo", mp::InstanceStatus::STOPPED));
+    auto subscription = subscribe();
+
+    std::thread notifier{[this] {
+        std::this_thread::sleep_for(10ms);
+        watchers.set_status("foo", mp::InstanceStatus::STARTING);
+    }};
+
+    const auto reply = subscription->next(1min);
+    notifier.join();
+
+    ASSERT_TRUE(reply);
+    EXPECT_EQ(reply->changes_size(), 1);
+}
+
+TEST_F(InstanceWatchers, closingEndsSubscriptions)
+{
+    auto subscription = subscribe();
+
+    std::thread closer{[this] {
+        std::this_thread::sleep_for(10ms);
+        watchers.close();
+    }};
+
+    EXPECT_FALSE(subscription->next(1min));
+    closer.join();
+
+    EXPECT_FALSE(subscribe()->next(1min));
+}
+} // namespace
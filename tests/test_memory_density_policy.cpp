@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <src/daemon/memory_density_policy.h>
+
+#include <multipass/memory_size.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace mp = multipass;
+
+using namespace testing;
+
+namespace
+{
+std::string probe_output(const std::string& load1, const std::string& active_kb)
+{
+    return load1 + " 0.20 0.15 1/123 4567\n"
+                   "MemTotal:        4005992 kB\n"
+                   "MemFree:         2921444 kB\n"
+                   "HugePages_Total:       0\n"
+                   "Active:          " +
+           active_kb + " kB\n"
+                       "Inactive:         412100 kB\n";
+}
+
+TEST(MemoryDensityPolicy, idleGuestShrinksToWorkingSetWithHeadroom)
+{
+    EXPECT_EQ(mp::memory_density_target(probe_output("0.01", "1048576"), mp::MemorySize{"4G"}),
+              mp::MemorySize{"1536M"});
+}
+
+TEST(MemoryDensityPolicy, idleGuestKeepsMinimum)
+{
+    EXPECT_EQ(mp::memory_density_target(probe_output("0.00", "102400"), mp::MemorySize{"4G"}),
+              mp::MemorySize{"512M"});
+}
+
+TEST(MemoryDensityPolicy, targetNeverExceedsInstanceMemory)
+{
+    EXPECT_EQ(mp::memory_density_target(probe_output("0.05", "3145728"), mp::MemorySize{"4G"}),
+              mp::MemorySize{"4G"});
+}
+
+TEST(MemoryDensityPolicy, busyGuestGetsAllMemoryBack)
+{
+    EXPECT_EQ(mp::memory_density_target(probe_output("1.50", "102400"), mp::MemorySize{"4G"}),
+              mp::MemorySize{"4G"});
+}
+
+TEST(MemoryDensityPolicy, throwsOnUnparseableOutput)
+{
+    EXPECT_THROW(mp::memory_density_target("cat: /proc/loadavg: No such file",
+                                           mp::MemorySize{"1G"}),
+                 std::runtime_error);
+    EXPECT_THROW(mp::memory_density_target("0.00 0.00 0.00 1/1 1\nMemTotal: 1 kB\n",
+                                           mp::MemorySize{"1G"}),
+                 std::runtime_error);
+}
+} // namespace
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <multipass/metrics.h>
+
+#include <chrono>
+
+namespace mp = multipass;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+TEST(Metrics, countersAddUp)
+{
+    mp::Counter counter;
+    counter.add();
+    counter.add(41);
+
+    EXPECT_EQ(counter.value(), 42u);
+}
+
+TEST(Metrics, histogramsPutObservationsInTheFirstBucketThatFits)
+{
+    mp::Histogram histogram;
+    histogram.observe(500us);
+    histogram.observe(1ms);
+    histogram.observe(2s);
+    histogram.observe(1h);
+
+    const auto counts = histogram.bucket_counts();
+    EXPECT_EQ(counts[0], 2u);
+    EXPECT_EQ(counts[7], 1u);
+    EXPECT_EQ(counts.back(), 1u);
+    EXPECT_EQ(histogram.count(), 4u);
+    EXPECT_DOUBLE_EQ(histogram.sum(), 3602.0015);
+}
+
+TEST(Metrics, labelledMetricsAreCreatedOnce)
+{
+    mp::Labelled<mp::Counter> counters;
+    counters.with("launch").add();
+    counters.with(std::string{"launch"}).add();
+    counters.with("stop").add();
+
+    std::vector<std::pair<std::string, std::uint64_t>> seen;
+    counters.for_each([&seen](const std::string& label_value, const mp::Counter& counter) {
+        seen.emplace_back(label_value, counter.value());
+    });
+
+    EXPECT_THAT(seen, ElementsAre(Pair("launch", 2u), Pair("stop", 1u)));
+}
+
+TEST(Metrics, prometheusTextHasCumulativeBuckets)
+{
+    MP_METRICS.rpc_durations.with("metrics_test").observe(2ms);
+    MP_METRICS.rpc_durations.with("metrics_test").observe(20s);
+
+    const auto text = MP_METRICS.to_prometheus();
+    const std::string bucket{"multipass_rpc_duration_seconds_bucket{rpc=\"metrics_test\""};
+    EXPECT_THAT(text, HasSubstr("# TYPE multipass_rpc_duration_seconds histogram\n"));
+    EXPECT_THAT(text, HasSubstr(bucket + ",le=\"0.001\"} 0\n" + bucket + ",le=\"0.005\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr(bucket + ",le=\"+Inf\"} 2\n"));
+    EXPECT_THAT(text, HasSubstr("multipass_rpc_duration_seconds_count{rpc=\"metrics_test\"} 2\n"));
+    EXPECT_THAT(text, HasSubstr("# TYPE multipass_ssh_execs_total counter\n"));
+}
+
+TEST(Metrics, labelValuesAreEscaped)
+{
+    MP_METRICS.instance_operations.with("quote\"d").add();
+
+    EXPECT_THAT(MP_METRICS.to_prometheus(),
+                HasSubstr("multipass_instance_operations_total{operation=\"quote\\\"d\"} 1\n"));
+}
+
+TEST(Metrics, gaugesListTheirSamples)
+{
+    std::string text;
+    mp::append_prometheus_gauge(text,
+                                "multipass_test_gauge",
+                                "A gauge.",
+                                {{"lane=\"cpu\"", 2}, {"lane=\"blocking\"", 0}});
+
+    EXPECT_EQ(text,
+              "# HELP multipass_test_gauge A gauge.\n"
+              "# TYPE multipass_test_gauge gauge\n"
+              "multipass_test_gauge{lane=\"cpu\"} 2\n"
+              "multipass_test_gauge{lane=\"blocking\"} 0\n");
+}
+} // namespace
@@ -27,6 +27,8 @@
 
 #include <QString>
 
+#include <chrono>
+#include <filesystem>
 #include <functional>
 #include <optional>
 
@@ -249,6 +251,86 @@ TEST_F(TestPersistentSettingsHandler, getReturnsDefaultByDefault)
     ASSERT_EQ(handler.get(key), QString(default_));
 }
 
+TEST_F(TestPersistentSettingsHandler, getReusesValuesWhileFileIsUnchanged)
+{
+    const auto key = "cached.key", val = "cached value";
+    const auto handler = make_handler(key);
+
+    EXPECT_CALL(*mock_qsettings, value_impl(Eq(key), _)).WillOnce(Return(val));
+
+    inject_mock_qsettings(); // only once
+
+    EXPECT_EQ(handler.get(key), QString{val});
+    EXPECT_EQ(handler.get(key), QString{val});
+}
+
+TEST_F(TestPersistentSettingsHandler, getRereadsAfterSet)
+{
+    const auto key = "some.key", old_val = "old", new_val = "new";
+    auto handler = make_handler(key);
+
+    auto first_read = std::make_unique<NiceMock<mpt::MockQSettings>>();
+    auto second_read = std::make_unique<NiceMock<mpt::MockQSettings>>();
+    EXPECT_CALL(*first_read, value_impl(Eq(key), _)).WillOnce(Return(old_val));
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(key), Eq(new_val)));
+    EXPECT_CALL(*second_read, value_impl(Eq(key), _)).WillOnce(Return(new_val));
+
+    EXPECT_CALL(*mock_qsettings_provider, make_wrapped_qsettings(Eq(fake_filename), _))
+        .WillOnce(Return(ByMove(std::move(first_read))))
+        .WillOnce(Return(ByMove(std::move(mock_qsettings))))
+        .WillOnce(Return(ByMove(std::move(second_read))));
+
+    EXPECT_EQ(handler.get(key), QString{old_val});
+    handler.set(key, new_val);
+    EXPECT_EQ(handler.get(key), QString{new_val});
+}
+
+TEST_F(TestPersistentSettingsHandler, getRereadsWhenFileChanges)
+{
+    const auto key = "watched.key", old_val = "old", new_val = "newer";
+    const auto handler = make_handler(key);
+
+    const std::filesystem::path path{fake_filename.toStdU16String()};
+    const auto written = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    EXPECT_CALL(*mock_file_ops, last_write_time(Eq(path), _))
+        .WillOnce(Return(written))
+        .WillOnce(Return(written))
+        .WillOnce(Return(written + std::chrono::minutes{1}));
+
+    auto second_read = std::make_unique<NiceMock<mpt::MockQSettings>>();
+    EXPECT_CALL(*mock_qsettings, value_impl(Eq(key), _)).WillOnce(Return(old_val));
+    EXPECT_CALL(*second_read, value_impl(Eq(key), _)).WillOnce(Return(new_val));
+
+    EXPECT_CALL(*mock_qsettings_provider, make_wrapped_qsettings(Eq(fake_filename), _))
+        .WillOnce(Return(ByMove(std::move(mock_qsettings))))
+        .WillOnce(Return(ByMove(std::move(second_read))));
+
+    EXPECT_EQ(handler.get(key), QString{old_val});
+    EXPECT_EQ(handler.get(key), QString{old_val}); // from the cache
+    EXPECT_EQ(handler.get(key), QString{new_val});
+}
+
+TEST_F(TestPersistentSettingsHandler, getRereadsFilesModifiedJustNow)
+{
+    const auto key = "racy.key", val = "value";
+    const auto handler = make_handler(key);
+
+    // Coarse timestamps could hide another change within the same tick
+    EXPECT_CALL(*mock_file_ops, last_write_time)
+        .WillRepeatedly(Return(std::filesystem::file_time_type::clock::now()));
+
+    auto second_read = std::make_unique<NiceMock<mpt::MockQSettings>>();
+    EXPECT_CALL(*mock_qsettings, value_impl(Eq(key), _)).WillOnce(Return(val));
+    EXPECT_CALL(*second_read, value_impl(Eq(key), _)).WillOnce(Return(val));
+
+    EXPECT_CALL(*mock_qsettings_provider, make_wrapped_qsettings(Eq(fake_filename), _))
+        .WillOnce(Return(ByMove(std::move(mock_qsettings))))
+        .WillOnce(Return(ByMove(std::move(second_read))));
+
+    EXPECT_EQ(handler.get(key), QString{val});
+    EXPECT_EQ(handler.get(key), QString{val});
+}
+
 TEST_F(TestPersistentSettingsHandler, getThrowsOnUnknownKey)
 {
     const auto key = "clef";
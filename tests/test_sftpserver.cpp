@@ -29,6 +29,10 @@
 #include "temp_dir.h"
 #include "temp_file.h"
 
+#ifndef MULTIPASS_PLATFORM_WINDOWS
+#include "unix/mock_libc_functions.h"
+#endif
+
 #include <src/sshfs_mount/sftp_server.h>
 
 #include <multipass/cli/client_platform.h>
@@ -37,6 +41,10 @@
 #include <multipass/platform.h>
 #include <multipass/ssh/ssh_session.h>
 
+#include <QtEndian>
+
+#include <ctime>
+#include <map>
 #include <queue>
 
 namespace mp = multipass;
@@ -47,6 +55,7 @@ namespace mcp = multipass::cli::platform;
 using namespace testing;
 
 using StringUPtr = std::unique_ptr<ssh_string_struct, void (*)(ssh_string)>;
+using BufferUPtr = std::unique_ptr<ssh_buffer_struct, void (*)(ssh_buffer)>;
 
 namespace
 {
@@ -233,6 +242,33 @@ auto make_data(const std::string& in)
     return out;
 }
 
+std::string as_u32(uint32_t value)
+{
+    value = qToBigEndian(value);
+    return {reinterpret_cast<const char*>(&value), sizeof(value)};
+}
+
+std::string as_u64(uint64_t value)
+{
+    value = qToBigEndian(value);
+    return {reinterpret_cast<const char*>(&value), sizeof(value)};
+}
+
+std::string as_string(const std::string& value)
+{
+    return as_u32(value.size()) + value;
+}
+
+// What libssh keeps of an extended request, for the fields it leaves unparsed
+auto make_extended_request(const std::string& name, const std::string& fields)
+{
+    const auto request = as_u32(42) + as_string(name) + fields;
+
+    BufferUPtr out{ssh_buffer_new(), ssh_buffer_free};
+    ssh_buffer_add_data(out.get(), request.data(), request.size());
+    return out;
+}
+
 bool content_match(const QString& path, const std::string& data)
 {
     auto content = mpt::load(path);
@@ -299,8 +335,8 @@ TEST_F(SftpServer, throwsWhenFailedToInit)
 {
     auto init_msg = make_msg(SSH_FXP_INIT);
     REPLACE(sftp_get_client_message, make_msg_handler());
-    auto bad_reply_version = [](auto...) { return SSH_ERROR; };
-    REPLACE(sftp_reply_version, bad_reply_version);
+    auto bad_channel_write = [](auto...) { return SSH_ERROR; };
+    REPLACE(ssh_channel_write, bad_channel_write);
     EXPECT_THROW(make_sftpserver(), mp::SSHException);
 }
 
@@ -1836,6 +1872,91 @@ TEST_F(SftpServer, handlesReaddirAttributesPreserved)
     EXPECT_TRUE(compare_permission(test_file_attrs.permissions, test_file_info, Permission::Other));
 }
 
+#ifndef MULTIPASS_PLATFORM_WINDOWS
+TEST_F(SftpServer, handlesReaddirAttributesAndLongnamesFromLstat)
+{
+    mpt::TempDir temp_dir;
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto readdir_msg = make_msg(SFTP_READDIR);
+    auto readdir_msg_final = make_msg(SFTP_READDIR);
+
+    const auto temp_dir_path = mp::fs::path{temp_dir.path().toStdString()};
+    std::vector<mp::fs::path> expected_entries = {temp_dir_path / "a-file",
+                                                  temp_dir_path / "a-dir"};
+    auto entries_read = 0ul;
+
+    auto directory_entry = mpt::MockDirectoryEntry{};
+    EXPECT_CALL(directory_entry, path).WillRepeatedly([&]() -> const mp::fs::path& {
+        return expected_entries[entries_read - 1];
+    });
+    auto dir_iterator = mpt::MockDirIterator{};
+    EXPECT_CALL(dir_iterator, hasNext).WillRepeatedly([&] {
+        return entries_read != expected_entries.size();
+    });
+    EXPECT_CALL(dir_iterator, next)
+        .WillRepeatedly(DoAll([&] { entries_read++; }, ReturnRef(directory_entry)));
+
+    const int host_uid = 1005, host_gid = 1006, instance_id = 1000;
+    const std::time_t mtime = 1700000000;
+    REPLACE(lstat, [&](const char* path, struct stat* buf) {
+        *buf = {};
+        buf->st_mode = mp::fs::path{path}.filename() == "a-dir" ? S_IFDIR | 0755 : S_IFREG | 0640;
+        buf->st_uid = host_uid;
+        buf->st_gid = host_gid;
+        buf->st_size = 4242;
+        buf->st_mtime = mtime;
+        return 0;
+    });
+
+    REPLACE(sftp_handle, [&dir_iterator](auto...) { return &dir_iterator; });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    int eof_num_calls{0};
+    REPLACE(sftp_reply_status,
+            make_reply_status(readdir_msg_final.get(), SSH_FX_EOF, eof_num_calls));
+
+    std::map<std::string, std::pair<std::string, sftp_attributes_struct>> replies;
+    REPLACE(sftp_reply_names_add,
+            [&replies](auto, const char* file, const char* longname, sftp_attributes attr) {
+                replies[file] = {longname, *attr};
+                return SSH_OK;
+            });
+    REPLACE(sftp_reply_names, [](auto...) { return SSH_OK; });
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString(),
+                                {{host_uid, instance_id}},
+                                {{host_gid, instance_id}});
+    sftp.run();
+
+    EXPECT_EQ(eof_num_calls, 1);
+    ASSERT_EQ(replies.size(), 2u);
+
+    const auto& [file_longname, file_attrs] = replies["a-file"];
+    EXPECT_EQ(file_attrs.uid, (uint32_t)instance_id);
+    EXPECT_EQ(file_attrs.gid, (uint32_t)instance_id);
+    EXPECT_EQ(file_attrs.size, 4242u);
+    EXPECT_EQ(file_attrs.mtime, (uint32_t)mtime);
+    EXPECT_EQ(file_attrs.permissions, (uint32_t)(S_IFREG | 0640));
+
+    const auto* time = std::localtime(&mtime);
+    ASSERT_NE(time, nullptr);
+    const auto date = fmt::format("{} {:02}:{:02}:{:02} {}",
+                                  time->tm_mday,
+                                  time->tm_hour,
+                                  time->tm_min,
+                                  time->tm_sec,
+                                  time->tm_year + 1900);
+
+    EXPECT_THAT(file_longname, StartsWith("-rw-r----- 1 1000 1000 4242 "));
+    EXPECT_THAT(file_longname, EndsWith(fmt::format(" {} a-file", date)));
+
+    const auto& [dir_longname, dir_attrs] = replies["a-dir"];
+    EXPECT_EQ(dir_attrs.permissions, (uint32_t)(S_IFDIR | 0755));
+    EXPECT_THAT(dir_longname, StartsWith("drwxr-xr-x 1 1000 1000 4242 "));
+    EXPECT_THAT(dir_longname, EndsWith(fmt::format(" {} a-dir", date)));
+}
+#endif
+
 TEST_F(SftpServer, handlesClose)
 {
     mpt::TempDir temp_dir;
@@ -2782,6 +2903,319 @@ TEST_F(SftpServer, invalidExtendedFails)
     EXPECT_THAT(num_calls, Eq(1));
 }
 
+TEST_F(SftpServer, versionAdvertisesExtensions)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    REPLACE(sftp_get_client_message, make_msg_handler());
+
+    std::string version_packet;
+    REPLACE(ssh_channel_write, [&version_packet](auto, const void* data, uint32_t len) {
+        version_packet.assign(static_cast<const char*>(data), len);
+        return static_cast<int>(len);
+    });
+
+    auto sftp = make_sftpserver();
+
+    ASSERT_GT(version_packet.size(), 9u);
+    EXPECT_EQ(version_packet[4], static_cast<char>(SSH_FXP_VERSION));
+    EXPECT_THAT(version_packet, HasSubstr(as_string("statvfs@openssh.com") + as_string("2")));
+    EXPECT_THAT(version_packet, HasSubstr(as_string("fsync@openssh.com") + as_string("1")));
+    EXPECT_THAT(version_packet, HasSubstr(as_string("copy-data") + as_string("1")));
+}
+
+TEST_F(SftpServer, handleExtendedStatvfs)
+{
+    mpt::TempDir temp_dir;
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("statvfs@openssh.com");
+    msg->submessage = submessage.data();
+    msg->id = 42;
+    auto request =
+        make_extended_request("statvfs@openssh.com", as_string(temp_dir.path().toStdString()));
+    msg->complete_message = request.get();
+
+    std::string reply;
+    REPLACE(ssh_channel_write, [&reply](auto, const void* data, uint32_t len) {
+        reply.assign(static_cast<const char*>(data), len);
+        return static_cast<int>(len);
+    });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    ASSERT_EQ(reply.size(), 4u + 1u + 4u + 11u * 8u);
+    EXPECT_EQ(reply[4], static_cast<char>(SSH_FXP_EXTENDED_REPLY));
+    EXPECT_EQ(reply.substr(5, 4), as_u32(42));
+    EXPECT_NE(reply.substr(9, 8), as_u64(0)); // f_bsize
+}
+
+TEST_F(SftpServer, extendedStatvfsInInvalidDirFails)
+{
+    mpt::TempDir temp_dir;
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("statvfs@openssh.com");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("statvfs@openssh.com", as_string("/foo/bar"));
+    msg->complete_message = request.get();
+
+    int perm_denied_num_calls{0};
+    auto reply_status =
+        make_reply_status(msg.get(), SSH_FX_PERMISSION_DENIED, perm_denied_num_calls);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    EXPECT_THAT(perm_denied_num_calls, Eq(1));
+}
+
+TEST_F(SftpServer, malformedExtendedStatvfsFails)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("statvfs@openssh.com");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("statvfs@openssh.com", as_u32(1000));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_BAD_MESSAGE, num_calls);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver();
+    sftp.run();
+
+    EXPECT_THAT(num_calls, Eq(1));
+}
+
+TEST_F(SftpServer, handleExtendedFsync)
+{
+    mpt::TempDir temp_dir;
+    auto file_name = temp_dir.path() + "/test-file";
+    mpt::make_file_with_content(file_name);
+
+    QFile file{file_name};
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    const auto named_fd = std::make_pair(mp::fs::path{file_name.toStdString()}, file.handle());
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("fsync@openssh.com");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("fsync@openssh.com", as_string("handle"));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_OK, num_calls);
+
+    REPLACE(sftp_handle, [&named_fd](auto...) { return (void*)&named_fd; });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    EXPECT_THAT(num_calls, Eq(1));
+}
+
+TEST_F(SftpServer, extendedFsyncWithBadHandleFails)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("fsync@openssh.com");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("fsync@openssh.com", as_string("handle"));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_BAD_MESSAGE, num_calls);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver();
+    sftp.run();
+
+    EXPECT_THAT(num_calls, Eq(1));
+}
+
+TEST_F(SftpServer, DISABLE_ON_WINDOWS(handleExtendedCopyData))
+{
+    mpt::TempDir temp_dir;
+    auto source_name = temp_dir.path() + "/test-file";
+    auto destination_name = temp_dir.path() + "/test-copy";
+    mpt::make_file_with_content(source_name);
+
+    QFile source{source_name}, destination{destination_name};
+    ASSERT_TRUE(source.open(QIODevice::ReadOnly));
+    ASSERT_TRUE(destination.open(QIODevice::WriteOnly));
+    const auto source_fd = std::make_pair(mp::fs::path{source_name.toStdString()}, source.handle());
+    const auto destination_fd =
+        std::make_pair(mp::fs::path{destination_name.toStdString()}, destination.handle());
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("copy-data");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("copy-data",
+                                         as_string("source") + as_u64(0) + as_u64(0) +
+                                             as_string("destination") + as_u64(0));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_OK, num_calls);
+
+    REPLACE(sftp_handle, [&source_fd, &destination_fd](auto, ssh_string handle) {
+        return ssh_string_len(handle) == std::string{"source"}.size() ? (void*)&source_fd
+                                                                      : (void*)&destination_fd;
+    });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    destination.close();
+    ASSERT_THAT(num_calls, Eq(1));
+    EXPECT_TRUE(content_match(destination_name, "this is a test file"));
+}
+
+TEST_F(SftpServer, extendedCopyDataOntoOverlappingRangeFails)
+{
+    mpt::TempDir temp_dir;
+    auto file_name = temp_dir.path() + "/test-file";
+    mpt::make_file_with_content(file_name);
+    const auto named_fd = std::make_pair(mp::fs::path{file_name.toStdString()}, -1);
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("copy-data");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("copy-data",
+                                         as_string("handle") + as_u64(0) + as_u64(10) +
+                                             as_string("handle") + as_u64(5));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_FAILURE, num_calls);
+
+    REPLACE(sftp_handle, [&named_fd](auto...) { return (void*)&named_fd; });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    EXPECT_THAT(num_calls, Eq(1));
+}
+
+TEST_F(SftpServer, DISABLE_ON_WINDOWS(extendedCopyDataOverlappingThroughTwoHandlesFails))
+{
+    mpt::TempDir temp_dir;
+    auto file_name = temp_dir.path() + "/test-file";
+    mpt::make_file_with_content(file_name);
+
+    QFile reader{file_name}, writer{file_name};
+    ASSERT_TRUE(reader.open(QIODevice::ReadOnly));
+    ASSERT_TRUE(writer.open(QIODevice::ReadWrite));
+    const auto reader_fd = std::make_pair(mp::fs::path{file_name.toStdString()}, reader.handle());
+    const auto writer_fd = std::make_pair(mp::fs::path{file_name.toStdString()}, writer.handle());
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("copy-data");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("copy-data",
+                                         as_string("reader") + as_u64(0) + as_u64(10) +
+                                             as_string("writer!") + as_u64(5));
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_FAILURE, num_calls);
+
+    REPLACE(sftp_handle, [&reader_fd, &writer_fd](auto, ssh_string handle) {
+        return ssh_string_len(handle) == std::string{"reader"}.size() ? (void*)&reader_fd
+                                                                      : (void*)&writer_fd;
+    });
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    writer.close();
+    EXPECT_THAT(num_calls, Eq(1));
+    EXPECT_TRUE(content_match(file_name, "this is a test file"));
+}
+
+TEST_F(SftpServer, handleExtendedCopyFile)
+{
+    mpt::TempDir temp_dir;
+    auto source_name = temp_dir.path() + "/test-file";
+    auto destination_name = temp_dir.path() + "/test-copy";
+    mpt::make_file_with_content(source_name);
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("copy-file");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("copy-file",
+                                         as_string(source_name.toStdString()) +
+                                             as_string(destination_name.toStdString()) + '\0');
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_OK, num_calls);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    ASSERT_THAT(num_calls, Eq(1));
+    EXPECT_TRUE(content_match(destination_name, "this is a test file"));
+}
+
+TEST_F(SftpServer, extendedCopyFileDoesNotOverwriteUnlessAsked)
+{
+    mpt::TempDir temp_dir;
+    auto source_name = temp_dir.path() + "/test-file";
+    auto destination_name = temp_dir.path() + "/test-copy";
+    mpt::make_file_with_content(source_name);
+    mpt::make_file_with_content(destination_name, "keep me");
+
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg = make_msg(SFTP_EXTENDED);
+    auto submessage = name_as_char_array("copy-file");
+    msg->submessage = submessage.data();
+    auto request = make_extended_request("copy-file",
+                                         as_string(source_name.toStdString()) +
+                                             as_string(destination_name.toStdString()) + '\0');
+    msg->complete_message = request.get();
+
+    int num_calls{0};
+    auto reply_status = make_reply_status(msg.get(), SSH_FX_FILE_ALREADY_EXISTS, num_calls);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+    REPLACE(sftp_reply_status, reply_status);
+
+    auto sftp = make_sftpserver(temp_dir.path().toStdString());
+    sftp.run();
+
+    ASSERT_THAT(num_calls, Eq(1));
+    EXPECT_TRUE(content_match(destination_name, "keep me"));
+}
+
 TEST_P(Stat, handles)
 {
     mpt::TempDir temp_dir;
@@ -110,6 +110,31 @@ TEST_F(TestSimpleStreamsManifest, throwsWhenFailedToParseAnyProducts)
                  mp::EmptyManifestException);
 }
 
+TEST_F(TestSimpleStreamsManifest, binaryFormRoundTrips)
+{
+    auto json = mpt::load_test_file("simple_streams_manifest/multiple_versions_manifest.json");
+    auto manifest = mp::SimpleStreamsManifest::fromJson(json, std::nullopt, "http://stream/url");
+
+    const auto loaded = mp::SimpleStreamsManifest::fromBinary(manifest->toBinary());
+
+    EXPECT_EQ(loaded->updated_at, manifest->updated_at);
+    EXPECT_EQ(loaded->products, manifest->products);
+    EXPECT_EQ(loaded->image_records.size(), manifest->image_records.size());
+    const QString id{"1797c5c82016c1e65f4008fcf89deae3a044ef76087a9ec5b907c6d64a3609ac"};
+    EXPECT_EQ(*loaded->image_records.at(id), *manifest->image_records.at(id));
+}
+
+TEST_F(TestSimpleStreamsManifest, throwsOnInvalidBinaryForm)
+{
+    auto json = mpt::load_test_file("simple_streams_manifest/good_manifest.json");
+    const auto binary = mp::SimpleStreamsManifest::fromJson(json, std::nullopt, "")->toBinary();
+
+    EXPECT_THROW(mp::SimpleStreamsManifest::fromBinary("not a manifest"),
+                 mp::GenericManifestException);
+    EXPECT_THROW(mp::SimpleStreamsManifest::fromBinary(binary.chopped(1)),
+                 mp::GenericManifestException);
+}
+
 TEST_F(TestSimpleStreamsManifest, choosesNewestVersion)
 {
     auto json = mpt::load_test_file("simple_streams_manifest/multiple_versions_manifest.json");
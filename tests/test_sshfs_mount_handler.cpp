@@ -23,11 +23,13 @@
 #include "mock_logger.h"
 #include "mock_process_factory.h"
 #include "mock_server_reader_writer.h"
+#include "mock_settings.h"
 #include "mock_ssh_process_exit_status.h"
 #include "mock_virtual_machine.h"
 #include "stub_ssh_key_provider.h"
 #include "stub_virtual_machine.h"
 
+#include <multipass/constants.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/vm_mount.h>
@@ -102,16 +104,33 @@ struct SSHFSMountHandlerTest : public ::Test
     mpt::MockFileOps& mock_file_ops = *mock_file_ops_injection.first;
     mpt::SetEnvScope env_scope{"DISABLE_APPARMOR", "1"};
     mpt::MockLogger::Scope logger_scope = mpt::MockLogger::inject(default_log_level);
+    mpt::MockSettings::GuardedMock mock_settings_injection = mpt::MockSettings::inject<NiceMock>();
+    mpt::MockSettings& mock_settings = *mock_settings_injection.first;
     mpt::MockServerReaderWriter<mp::MountReply, mp::MountRequest> server;
     mpt::MockSSHTestFixture mock_ssh_test_fixture;
     mpt::ExitStatusMock exit_status_mock;
     mpt::StubVirtualMachine vm;
+    mp::SSHFSChecks sshfs_checks;
+    mp::SSHFSServers sshfs_servers;
+    std::vector<QByteArray> sshfs_requests; // as sent to the sshfs_server processes
     std::unique_ptr<mpt::MockProcessFactory::Scope> factory = mpt::MockProcessFactory::Inject();
 
-    mpt::MockProcessFactory::Callback sshfs_prints_connected = [](mpt::MockProcess* process) {
-        // Have "sshfs_server" print "Connected" to its stdout after short delay
-        ON_CALL(*process, read_all_standard_output).WillByDefault(Return("Connected"));
-        QTimer::singleShot(1, process, [process] { emit process->ready_read_standard_output(); });
+    mpt::MockProcessFactory::Callback sshfs_prints_connected = [this](mpt::MockProcess* process) {
+        // Have "sshfs_server" print "Connected" to its stdout after short delay, and reply to
+        // requests to attach and detach further mounts likewise
+        auto output = std::make_shared<QByteArray>("Connected\n");
+        auto print = [process] { emit process->ready_read_standard_output(); };
+        ON_CALL(*process, read_all_standard_output).WillByDefault([output] {
+            return std::exchange(*output, {});
+        });
+        ON_CALL(*process, write)
+            .WillByDefault([this, process, output, print](const QByteArray& line) {
+                sshfs_requests.push_back(line);
+                *output += line.startsWith("attach") ? "Connected\n" : "Detached\n";
+                QTimer::singleShot(1, process, print);
+                return line.size();
+            });
+        QTimer::singleShot(1, process, print);
         // Ensure process_state() does not have an exit code set (i.e. still running)
         ON_CALL(*process, process_state).WillByDefault(Return(mp::ProcessState{}));
     };
@@ -126,7 +145,12 @@ TEST_F(SSHFSMountHandlerTest, mountCreatesSshfsProcess)
     EXPECT_CALL(mock_vm, ssh_hostname()).Times(2);
     EXPECT_CALL(mock_vm, ssh_username()).Times(2);
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&mock_vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&mock_vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     sshfs_mount_handler.activate(&server);
 
     ASSERT_EQ(factory->process_list().size(), 1u);
@@ -149,6 +173,31 @@ TEST_F(SSHFSMountHandlerTest, mountCreatesSshfsProcess)
     EXPECT_EQ(sshfs_command.arguments[7], log_level_as_string);
 }
 
+TEST_F(SSHFSMountHandlerTest, sshfsServerCachesOnlyWhenSetTo)
+{
+    std::vector<QString> cache_values;
+    factory->register_callback(sshfs_server_callback([&](mpt::MockProcess* process) {
+        cache_values.push_back(process->process_environment().value("SSHFS_CACHE"));
+        sshfs_prints_connected(process);
+    }));
+
+    EXPECT_CALL(mock_settings, get(Eq(mp::mount_caching_key)))
+        .WillOnce(Return("false"))
+        .WillOnce(Return("true"));
+
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
+    sshfs_mount_handler.activate(&server);
+    sshfs_mount_handler.deactivate(/*force=*/true);
+    sshfs_mount_handler.activate(&server);
+
+    EXPECT_THAT(cache_values, ElementsAre(QString{}, QString{"1"}));
+}
+
 TEST_F(SSHFSMountHandlerTest, sshfsProcessFailingWithReturnCode9CausesException)
 {
     factory->register_callback(sshfs_server_callback([](mpt::MockProcess* process) {
@@ -159,7 +208,12 @@ TEST_F(SSHFSMountHandlerTest, sshfsProcessFailingWithReturnCode9CausesException)
         ON_CALL(*process, process_state()).WillByDefault(Return(exit_state));
     }));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     EXPECT_THROW(sshfs_mount_handler.activate(&server), mp::SSHFSMissingError);
 
     ASSERT_EQ(factory->process_list().size(), 1u);
@@ -180,7 +234,12 @@ TEST_F(SSHFSMountHandlerTest, sshfsProcessFailingCausesRuntimeException)
         ON_CALL(*process, process_state()).WillByDefault(Return(exit_state));
     }));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     MP_EXPECT_THROW_THAT(sshfs_mount_handler.activate(&server),
                          std::runtime_error,
                          mpt::match_what(StrEq("Process returned exit code: 1: Whoopsie")));
@@ -194,17 +253,126 @@ TEST_F(SSHFSMountHandlerTest, stopTerminatesSshfsProcess)
         EXPECT_CALL(*process, wait_for_finished).WillOnce(Return(true));
     }));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     sshfs_mount_handler.activate(&server);
     sshfs_mount_handler.deactivate();
 }
 
+TEST_F(SSHFSMountHandlerTest, mountsShareTheSshfsCheckUntilDeactivated)
+{
+    factory->register_callback(sshfs_server_callback(sshfs_prints_connected));
+
+    auto checks = 0;
+    REPLACE(ssh_channel_request_exec, [this, &checks](ssh_channel, const char* raw_cmd) {
+        if (std::string{raw_cmd} == "which snap")
+            ++checks;
+
+        exit_status_mock.set_exit_status(exit_status_mock.success_status);
+        return SSH_OK;
+    });
+
+    mp::SSHFSMountHandler first_handler{&vm,
+                                        &key_provider,
+                                        target_path,
+                                        mount,
+                                        sshfs_checks,
+                                        sshfs_servers};
+    EXPECT_CALL(mock_file_ops, status)
+        .WillOnce(Return(mp::fs::file_status{mp::fs::file_type::directory, mp::fs::perms::all}));
+    mp::SSHFSMountHandler second_handler{&vm,
+                                         &key_provider,
+                                         "/another/target",
+                                         mount,
+                                         sshfs_checks,
+                                         sshfs_servers};
+
+    first_handler.activate(&server);
+    second_handler.activate(&server);
+    EXPECT_EQ(checks, 1);
+
+    first_handler.deactivate(/*force=*/true);
+    second_handler.deactivate(/*force=*/true);
+    first_handler.activate(&server);
+    EXPECT_EQ(checks, 2);
+}
+
+TEST_F(SSHFSMountHandlerTest, mountsOfAnInstanceShareItsSshfsServer)
+{
+    factory->register_callback(sshfs_server_callback([this](mpt::MockProcess* process) {
+        sshfs_prints_connected(process);
+        // Let into the second source, then out of it again
+        EXPECT_CALL(*process, reload_apparmor_profile).Times(2);
+        EXPECT_CALL(*process, terminate);
+        EXPECT_CALL(*process, wait_for_finished).WillOnce(Return(true));
+    }));
+
+    mp::SSHFSMountHandler first_handler{&vm,
+                                        &key_provider,
+                                        target_path,
+                                        mount,
+                                        sshfs_checks,
+                                        sshfs_servers};
+    EXPECT_CALL(mock_file_ops, status)
+        .WillOnce(Return(mp::fs::file_status{mp::fs::file_type::directory, mp::fs::perms::all}));
+    mp::SSHFSMountHandler second_handler{&vm,
+                                         &key_provider,
+                                         "/another target",
+                                         mount,
+                                         sshfs_checks,
+                                         sshfs_servers};
+
+    first_handler.activate(&server);
+    second_handler.activate(&server);
+    EXPECT_EQ(factory->process_list().size(), 1u);
+    ASSERT_EQ(sshfs_requests.size(), 1u);
+    const auto encoded_source = QByteArray::fromStdString(source_path).toPercentEncoding();
+    EXPECT_TRUE(sshfs_requests[0].startsWith("attach " + encoded_source + " %2Fanother%20target "));
+
+    second_handler.deactivate();
+    EXPECT_THAT(sshfs_requests, ElementsAre(_, QByteArray{"detach %2Fanother%20target\n"}));
+
+    first_handler.deactivate();
+    EXPECT_EQ(sshfs_requests.size(), 2u);
+}
+
+TEST_F(SSHFSMountHandlerTest, staleChecksAreNotForgottenInPlaceOfNewerOnes)
+{
+    auto checks = 0;
+    auto check = [&checks] {
+        ++checks;
+        return mp::SSHFSChecks::Result{};
+    };
+
+    const auto [first_result, first_check] = sshfs_checks.run_once("vm", check);
+    sshfs_checks.forget("vm", first_check);
+    const auto [second_result, second_check] = sshfs_checks.run_once("vm", check);
+    EXPECT_EQ(checks, 2);
+
+    sshfs_checks.forget("vm", first_check);
+    sshfs_checks.run_once("vm", check);
+    EXPECT_EQ(checks, 2);
+
+    sshfs_checks.forget("vm", second_check);
+    sshfs_checks.run_once("vm", check);
+    EXPECT_EQ(checks, 3);
+}
+
 TEST_F(SSHFSMountHandlerTest, throwsInstallSshfsWhichSnapFails)
 {
     auto invoked = false;
     REPLACE(ssh_channel_request_exec, make_exec_that_fails_for({"which snap"}, invoked));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     EXPECT_THROW(sshfs_mount_handler.activate(&server), std::runtime_error);
     EXPECT_TRUE(invoked);
 }
@@ -215,7 +383,12 @@ TEST_F(SSHFSMountHandlerTest, throwsInstallSshfsNoSnapDirFails)
     REPLACE(ssh_channel_request_exec,
             make_exec_that_fails_for({"[ -e /snap ]", "sudo snap list multipass-sshfs"}, invoked));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     EXPECT_THROW(sshfs_mount_handler.activate(&server), std::runtime_error);
     EXPECT_TRUE(invoked);
 }
@@ -228,7 +401,12 @@ TEST_F(SSHFSMountHandlerTest, throwsInstallSshfsSnapInstallFails)
                 {"sudo snap list multipass-sshfs", "sudo snap install multipass-sshfs"},
                 invoked));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     EXPECT_THROW(sshfs_mount_handler.activate(&server), mp::SSHFSMissingError);
     EXPECT_TRUE(invoked);
 }
@@ -278,7 +456,12 @@ TEST_F(SSHFSMountHandlerTest, installSshfsTimeoutLogsInfo)
                     AllOf(HasSubstr("Could not install 'multipass-sshfs' in 'stub'"),
                           HasSubstr("timed out"))));
 
-    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              sshfs_checks,
+                                              sshfs_servers};
     EXPECT_THROW(sshfs_mount_handler.activate(&server, std::chrono::milliseconds(1)),
                  mp::SSHFSMissingError);
 }
@@ -71,6 +71,28 @@ TEST_F(TestSSHFSServerProcessSpec, environmentCorrect)
     EXPECT_EQ(spec.environment().value("KEY"), "private_key");
 }
 
+TEST_F(TestSSHFSServerProcessSpec, environmentCarriesKnownGuestInfo)
+{
+    EXPECT_FALSE(mp::SSHFSServerProcessSpec{config}.environment().contains("SSHFS_EXEC"));
+
+    config.sshfs_exec_line = "/usr/bin/sshfs -o slave";
+    config.instance_uid = 1000;
+    config.instance_gid = 1001;
+    mp::SSHFSServerProcessSpec spec(config);
+
+    EXPECT_EQ(spec.environment().value("SSHFS_EXEC"), "/usr/bin/sshfs -o slave");
+    EXPECT_EQ(spec.environment().value("INSTANCE_UID"), "1000");
+    EXPECT_EQ(spec.environment().value("INSTANCE_GID"), "1001");
+}
+
+TEST_F(TestSSHFSServerProcessSpec, environmentAllowsCachingOnlyWhenAsked)
+{
+    EXPECT_FALSE(mp::SSHFSServerProcessSpec{config}.environment().contains("SSHFS_CACHE"));
+
+    config.cache = true;
+    EXPECT_EQ(mp::SSHFSServerProcessSpec{config}.environment().value("SSHFS_CACHE"), "1");
+}
+
 TEST_F(TestSSHFSServerProcessSpec, snapConfinedApparmorProfileReturnsExpectedData)
 {
     mpt::TempDir bin_dir;
@@ -103,3 +125,25 @@ TEST_F(TestSSHFSServerProcessSpec, unconfinedApparmorProfileReturnsExpectedData)
     EXPECT_TRUE(apparmor_profile.contains(current_dir.absolutePath() + "/{usr/,}lib/**"));
     EXPECT_TRUE(apparmor_profile.contains("signal (receive) peer=unconfined"));
 }
+
+TEST_F(TestSSHFSServerProcessSpec, apparmorProfileFollowsTheSourcesBeingServed)
+{
+    mp::SSHFSServerProcessSpec spec(config);
+    EXPECT_TRUE(spec.apparmor_profile().contains("source_path/** rwlk,"));
+
+    auto source_paths = std::make_shared<std::vector<std::string>>(
+        std::vector<std::string>{"/home/user/one", "/home/user/two"});
+    config.source_paths = source_paths;
+    mp::SSHFSServerProcessSpec shared_spec(config);
+    const auto identifier = shared_spec.identifier();
+
+    auto apparmor_profile = shared_spec.apparmor_profile();
+    EXPECT_TRUE(apparmor_profile.contains("/home/user/one/ rw,"));
+    EXPECT_TRUE(apparmor_profile.contains("/home/user/two/** rwlk,"));
+
+    source_paths->pop_back();
+    apparmor_profile = shared_spec.apparmor_profile();
+    EXPECT_TRUE(apparmor_profile.contains("/home/user/one/** rwlk,"));
+    EXPECT_FALSE(apparmor_profile.contains("/home/user/two"));
+    EXPECT_EQ(shared_spec.identifier(), identifier);
+}
@@ -45,14 +45,18 @@ namespace
 {
 struct SshfsMount : public mp::test::SftpServerTest
 {
-    mp::SshfsMount make_sshfsmount(std::optional<std::string> target = std::nullopt)
+    mp::SshfsMount make_sshfsmount(
+        std::optional<std::string> target = std::nullopt,
+        const std::optional<mp::SshfsGuestInfo>& guest_info = std::nullopt)
     {
         mp::SSHSession session{"a", 42, "ubuntu", key_provider};
         return {std::move(session),
                 default_source,
                 target.value_or(default_target),
                 default_mappings,
-                default_mappings};
+                default_mappings,
+                cache,
+                guest_info};
     }
 
     auto make_exec_that_fails_for(const std::vector<std::string>& expected_cmds, bool& invoked)
@@ -173,10 +177,12 @@ struct SshfsMount : public mp::test::SftpServerTest
         return channel_read;
     }
 
-    void test_command_execution(const CommandVector& commands,
-                                std::optional<std::string> target = std::nullopt,
-                                std::optional<std::string> fail_cmd = std::nullopt,
-                                std::optional<bool> fail_invoked = std::nullopt)
+    void test_command_execution(
+        const CommandVector& commands,
+        std::optional<std::string> target = std::nullopt,
+        std::optional<std::string> fail_cmd = std::nullopt,
+        std::optional<bool> fail_invoked = std::nullopt,
+        const std::optional<mp::SshfsGuestInfo>& guest_info = std::nullopt)
     {
         bool invoked{false};
         std::string output;
@@ -195,7 +201,7 @@ struct SshfsMount : public mp::test::SftpServerTest
                                                         fail_invoked);
         REPLACE(ssh_channel_request_exec, request_exec);
 
-        make_sshfsmount(target.value_or(default_target));
+        make_sshfsmount(target.value_or(default_target), guest_info);
 
         EXPECT_TRUE(next_expected_cmd == commands.end())
             << "\"" << next_expected_cmd->first << "\" not executed";
@@ -219,6 +225,7 @@ struct SshfsMount : public mp::test::SftpServerTest
     std::string default_target{"target"};
     mp::id_mappings default_mappings;
     int default_id{1000};
+    bool cache{false};
     mpt::MockLogger::Scope logger_scope = mpt::MockLogger::inject();
     const mpt::StubSSHKeyProvider key_provider;
 
@@ -346,6 +353,20 @@ CommandVector new_fuse_cmds = {
      "allow_other -o Compression=no -o dir_cache=no :\"source\" \"/home/ubuntu/target\"",
      "don't care\n"}};
 
+// Commands to check that mounts allowed to cache do so briefly, whatever the version of FUSE.
+CommandVector old_fuse_caching_cmds = {
+    {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -V", "FUSE library version: 2.9.0\n"},
+    {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -o slave -o transform_symlinks -o "
+     "allow_other -o Compression=no -o nonempty -o cache=yes -o cache_timeout=1 :\"source\" "
+     "\"/home/ubuntu/target\"",
+     "don't care\n"}};
+CommandVector new_fuse_caching_cmds = {
+    {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -V", "FUSE library version: 3.0.0\n"},
+    {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -o slave -o transform_symlinks -o "
+     "allow_other -o Compression=no -o dir_cache=yes -o dcache_timeout=1 :\"source\" "
+     "\"/home/ubuntu/target\"",
+     "don't care\n"}};
+
 // Commands to check that an unknown version of FUSE gives a correct answer.
 CommandVector unk_fuse_cmds = {
     {"sudo env LD_LIBRARY_PATH=/foo/bar /baz/bin/sshfs -V", "weird fuse version\n"},
@@ -469,6 +490,35 @@ TEST_F(SshfsMount, unblocksWhenSftpserverExits)
     EXPECT_TRUE(stopped_ok);
 }
 
+TEST_F(SshfsMount, skipsDiscoveryWhenGivenGuestInfo)
+{
+    CommandVector commands = {{"sudo /usr/bin/sshfs -o slave :\"source\" \"target\"", "\n"}};
+    sftp_client_message_struct message{make_init_message()};
+    auto mock_get_client_msg = mock_sftp_get_cli_msg(&message);
+    REPLACE(sftp_get_client_message, mock_get_client_msg);
+
+    // Discovering would fail, as would running anything but the given sshfs
+    for (const auto* discovery : {"snap run multipass-sshfs.env", "id -u", "id -g"})
+        EXPECT_NO_THROW(test_command_execution(commands,
+                                               std::nullopt,
+                                               discovery,
+                                               std::nullopt,
+                                               mp::SshfsGuestInfo{"/usr/bin/sshfs -o slave",
+                                                                  1000,
+                                                                  1000}));
+}
+
+TEST_F(SshfsMount, cachesOnlyWhenAllowedTo)
+{
+    sftp_client_message_struct message{make_init_message()};
+    auto mock_get_client_msg = mock_sftp_get_cli_msg(&message);
+    REPLACE(sftp_get_client_message, mock_get_client_msg);
+
+    cache = true;
+    for (const auto& commands : {old_fuse_caching_cmds, new_fuse_caching_cmds})
+        test_command_execution(commands);
+}
+
 TEST_F(SshfsMount, blankFuseVersionLogsError)
 {
     CommandVector commands = {
@@ -488,3 +538,58 @@ TEST_F(SshfsMount, blankFuseVersionLogsError)
 
     test_command_execution(commands);
 }
+
+TEST_F(SshfsMount, attachesAndDetachesMountsOnTheSameSession)
+{
+    sftp_client_message_struct message{make_init_message()};
+    auto get_init_message = [&message](sftp_session) { return &message; };
+    REPLACE(sftp_get_client_message, get_init_message);
+
+    // sshfs never has anything to say, so mounts are only ever attached and detached
+    auto nothing_to_read = [](ssh_channel* read_channels, ssh_channel*, ssh_channel*, timeval*) {
+        read_channels[0] = nullptr;
+        return SSH_OK;
+    };
+    REPLACE(ssh_channel_select, nothing_to_read);
+
+    int closed_channels{0};
+    auto count_closes = [&closed_channels](ssh_channel) {
+        ++closed_channels;
+        return SSH_OK;
+    };
+    REPLACE(ssh_channel_close, count_closes);
+
+    const CommandVector commands = {
+        {"echo $PWD/other", "/home/ubuntu/other\n"},
+        {"sudo /bin/bash -c 'P=\"/home/ubuntu/other\"; while [ ! -d \"$P/\" ]; do "
+         "P=\"${P%/*}\"; done; echo $P/'",
+         "/home/ubuntu/\n"}};
+    bool invoked{false};
+    std::string output;
+    auto remaining = output.size();
+    CommandVector::const_iterator next_expected_cmd = commands.begin();
+    std::optional<std::string> fail_cmd;
+    std::optional<bool> fail_invoked;
+
+    auto channel_read = make_channel_read_return(output, remaining, invoked);
+    REPLACE(ssh_channel_read_timeout, channel_read);
+    auto request_exec = make_exec_to_check_commands(commands,
+                                                    remaining,
+                                                    next_expected_cmd,
+                                                    output,
+                                                    invoked,
+                                                    fail_cmd,
+                                                    fail_invoked);
+    REPLACE(ssh_channel_request_exec, request_exec);
+
+    auto sshfs_mount = make_sshfsmount();
+    sshfs_mount.attach("other_source", "other", default_mappings, default_mappings);
+    EXPECT_TRUE(next_expected_cmd == commands.end());
+    EXPECT_THROW(sshfs_mount.attach("other_source", "other", default_mappings, default_mappings),
+                 std::runtime_error);
+
+    sshfs_mount.detach("other");
+    EXPECT_EQ(closed_channels, 1);
+    EXPECT_THROW(sshfs_mount.detach("other"), std::runtime_error);
+    EXPECT_TRUE(sshfs_mount.alive());
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "temp_dir.h"
+
+#include <multipass/tracing.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <thread>
+
+namespace mp = multipass;
+namespace mpt = mp::test;
+
+using namespace testing;
+
+namespace
+{
+TEST(Tracing, spansOfUntracedInstancesAreDropped)
+{
+    {
+        mp::TraceSpan span{"untraced", "start"};
+    }
+
+    MP_TRACER.begin("untraced", "launch");
+    EXPECT_THAT(MP_TRACER.end("untraced")->spans, IsEmpty());
+    EXPECT_FALSE(MP_TRACER.end("untraced"));
+}
+
+TEST(Tracing, spansWithoutInstanceGoToTheScope)
+{
+    MP_TRACER.begin("scoped", "launch");
+    {
+        mp::TraceScope scope{"scoped"};
+        mp::TraceSpan span{"fetch_image"};
+    }
+    {
+        mp::TraceSpan span{"outside_scope"};
+    }
+
+    const auto trace = MP_TRACER.end("scoped");
+    ASSERT_TRUE(trace);
+    EXPECT_EQ(trace->operation, "launch");
+    ASSERT_EQ(trace->spans.size(), 1u);
+    EXPECT_EQ(trace->spans[0].stage, "fetch_image");
+}
+
+TEST(Tracing, inTraceScopeCarriesTheScopeToOtherThreads)
+{
+    MP_TRACER.begin("carried", "launch");
+    auto task = [] {
+        mp::TraceScope scope{"carried"};
+        return mp::in_trace_scope([] {
+            mp::TraceSpan span{"download"};
+            return mp::TraceScope::current();
+        });
+    }();
+
+    std::string seen_scope;
+    std::thread{[&task, &seen_scope] { seen_scope = task(); }}.join();
+
+    EXPECT_EQ(seen_scope, "carried");
+    EXPECT_TRUE(mp::TraceScope::current().empty());
+    EXPECT_EQ(MP_TRACER.end("carried")->spans.size(), 1u);
+}
+
+TEST(Tracing, chromeTraceHasAnEventPerSpanPlusTheOperation)
+{
+    MP_TRACER.begin("chrome", "launch");
+    {
+        mp::TraceSpan outer{"chrome", "fetch_image"};
+        mp::TraceSpan inner{"chrome", "download"};
+    }
+
+    const auto json = QJsonDocument::fromJson(
+        QByteArray::fromStdString(mp::to_chrome_trace(*MP_TRACER.end("chrome"))));
+    const auto events = json["traceEvents"].toArray();
+
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0]["name"].toString(), "launch");
+    EXPECT_EQ(events[1]["name"].toString(), "fetch_image");
+    EXPECT_EQ(events[2]["name"].toString(), "download");
+    for (const auto& event : events)
+    {
+        EXPECT_EQ(event["ph"].toString(), "X");
+        EXPECT_EQ(event["args"]["instance"].toString(), "chrome");
+    }
+}
+
+TEST(Tracing, summaryIndentsNestedStages)
+{
+    MP_TRACER.begin("summary", "launch");
+    {
+        mp::TraceSpan outer{"summary", "fetch_image"};
+        mp::TraceSpan inner{"summary", "download"};
+    }
+
+    const auto summary = mp::summary_of(*MP_TRACER.end("summary"));
+
+    EXPECT_THAT(summary, HasSubstr("launch of summary"));
+    EXPECT_THAT(summary, HasSubstr("\n  fetch_image "));
+    EXPECT_THAT(summary, HasSubstr("\n    download "));
+    EXPECT_THAT(summary, HasSubstr("\n  total "));
+}
+
+TEST(Tracing, writesTraceIntoTheDirectory)
+{
+    mpt::TempDir dir;
+    MP_TRACER.begin("written", "launch");
+
+    const auto path = mp::write_chrome_trace(*MP_TRACER.end("written"), dir.path());
+
+    EXPECT_TRUE(path.startsWith(dir.path()));
+    EXPECT_TRUE(path.endsWith(".json"));
+    EXPECT_TRUE(QFile::exists(path));
+}
+} // namespace
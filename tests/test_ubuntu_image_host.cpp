@@ -16,11 +16,13 @@
  */
 
 #include "common.h"
+#include "file_operations.h"
 #include "image_host_remote_count.h"
 #include "mischievous_url_downloader.h"
 #include "mock_platform.h"
 #include "mock_settings.h"
 #include "path.h"
+#include "temp_dir.h"
 
 #include <multipass/constants.h>
 #include <multipass/exceptions/download_exception.h>
@@ -29,9 +31,12 @@
 #include <multipass/image_host/ubuntu_image_host.h>
 #include <multipass/query.h>
 
+#include <QDir>
 #include <QUrl>
 
+#include <atomic>
 #include <cstddef>
+#include <future>
 #include <optional>
 #include <unordered_set>
 
@@ -189,6 +194,35 @@ TEST_F(UbuntuImageHost, iteratesOverAllEntries)
                 Eq(1u));
 }
 
+TEST_F(UbuntuImageHost, iteratesOverAliasedEntriesOnly)
+{
+    mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader};
+    host.update_manifests(false);
+
+    std::vector<mp::VMImageInfo> all_entries, aliased_entries;
+    host.for_each_entry_do([&all_entries](const std::string&, const mp::VMImageInfo& info) {
+        if (!info.aliases.empty())
+            all_entries.push_back(info);
+    });
+    host.for_each_aliased_entry_do(
+        [&aliased_entries](const std::string&, const mp::VMImageInfo& info) {
+            aliased_entries.push_back(info);
+        });
+
+    EXPECT_FALSE(aliased_entries.empty());
+    EXPECT_EQ(aliased_entries, all_entries);
+}
+
+TEST_F(UbuntuImageHost, infoForFullHashIgnoresCase)
+{
+    mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader};
+    host.update_manifests(false);
+
+    const auto info = host.info_for_full_hash(expected_id.toUpper().toStdString());
+
+    EXPECT_EQ(info.id, expected_id);
+}
+
 TEST_F(UbuntuImageHost, canQueryByHash)
 {
     mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader};
@@ -385,13 +419,34 @@ TEST_F(UbuntuImageHost, handlesAndRecoversFromLaterNetworkFailure)
 
     url_downloader.mischiefs = 1000;
     EXPECT_THROW(host.update_manifests(false), mp::DownloadException);
-    EXPECT_THROW(host.info_for(query), std::runtime_error);
+    EXPECT_TRUE(host.info_for(query)); // the previous manifests remain published
 
     url_downloader.mischiefs = 0;
     host.update_manifests(false);
     EXPECT_TRUE(host.info_for(query));
 }
 
+TEST_F(UbuntuImageHost, lookupsKeepWorkingDuringRefresh)
+{
+    mp::UbuntuVMImageHost host{all_remote_specs, &url_downloader};
+    host.update_manifests(false);
+
+    const auto query = make_query("xenial", release_remote_spec.first);
+    std::atomic_bool done{false};
+    auto refresher = std::async(std::launch::async, [&host, &done] {
+        for (auto i = 0; i < 10; ++i)
+            host.update_manifests(false);
+        done = true;
+    });
+
+    do
+    {
+        ASSERT_TRUE(host.info_for(query));
+    } while (!done);
+
+    refresher.get();
+}
+
 TEST_F(UbuntuImageHost, handlesAndRecoversFromIndependentServerFailures)
 {
     mp::UbuntuVMImageHost host{all_remote_specs, &url_downloader};
@@ -434,6 +489,38 @@ TEST_F(UbuntuImageHost, develRequestWithNoRemoteReturnsExpectedInfo)
     EXPECT_EQ(info->id, daily_expected_id);
 }
 
+TEST_F(UbuntuImageHost, cachesParsedManifests)
+{
+    mpt::TempDir cache_dir;
+
+    mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader, cache_dir.path()};
+    host.update_manifests(false);
+
+    EXPECT_TRUE(QDir{cache_dir.path()}.exists(QString::fromStdString(release_remote_spec.first)));
+
+    mp::UbuntuVMImageHost cached_host{{release_remote_spec}, &url_downloader, cache_dir.path()};
+    cached_host.update_manifests(false);
+
+    EXPECT_EQ(cached_host.all_images_for(release_remote_spec.first, true),
+              host.all_images_for(release_remote_spec.first, true));
+}
+
+TEST_F(UbuntuImageHost, ignoresInvalidManifestCache)
+{
+    mpt::TempDir cache_dir;
+    mpt::make_file_with_content(
+        QDir{cache_dir.path()}.filePath(QString::fromStdString(release_remote_spec.first)),
+        "garbage");
+
+    mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader, cache_dir.path()};
+    host.update_manifests(false);
+
+    auto info = host.info_for(make_query("xenial", release_remote_spec.first));
+
+    ASSERT_TRUE(info);
+    EXPECT_THAT(info->id, Eq(expected_id));
+}
+
 TEST_F(UbuntuImageHost, infoForTooManyHashMatchesThrows)
 {
     mp::UbuntuVMImageHost host{{release_remote_spec}, &url_downloader};
@@ -24,6 +24,7 @@
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/download_exception.h>
 
+#include <QNetworkDiskCache>
 #include <QTimer>
 
 namespace mp = multipass;
@@ -84,6 +85,41 @@ TEST_F(URLDownloader, simpleDownloadReturnsExpectedData)
     EXPECT_EQ(downloaded_data, test_data);
 }
 
+TEST_F(URLDownloader, forcedDownloadRevalidatesCachedData)
+{
+    const QByteArray test_data{"The answer to everything is 42."};
+    mpt::MockQNetworkReply* mock_reply = new mpt::MockQNetworkReply();
+
+    auto network_cache = new QNetworkDiskCache;
+    network_cache->setCacheDirectory(cache_dir.path());
+    mock_network_access_manager->setCache(network_cache);
+
+    QNetworkCacheMetaData meta_data;
+    meta_data.setUrl(fake_url);
+    meta_data.setSaveToDisk(true);
+    meta_data.setRawHeaders({{"ETag", "\"42\""}});
+    auto cache_device = network_cache->prepare(meta_data);
+    ASSERT_NE(cache_device, nullptr);
+    cache_device->write(test_data);
+    network_cache->insert(cache_device);
+
+    EXPECT_CALL(*mock_network_access_manager, createRequest(_, _, _))
+        .WillOnce([&mock_reply](auto, const QNetworkRequest& request, auto) {
+            EXPECT_EQ(request.rawHeader("If-None-Match"), "\"42\"");
+
+            QTimer::singleShot(0, [&mock_reply] {
+                mock_reply->set_attribute(QNetworkRequest::HttpStatusCodeAttribute, QVariant(304));
+                mock_reply->finished();
+            });
+            return mock_reply;
+        });
+    EXPECT_CALL(*mock_reply, readData(_, _)).WillRepeatedly(Return(0));
+
+    mp::URLDownloader downloader(cache_dir.path(), 1s);
+
+    EXPECT_EQ(downloader.download(fake_url, true), test_data);
+}
+
 TEST_F(URLDownloader, simpleDownloadNetworkTimeoutTriesCache)
 {
     mpt::MockQNetworkReply* mock_reply_abort = new mpt::MockQNetworkReply();
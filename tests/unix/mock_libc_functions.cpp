@@ -43,6 +43,23 @@ int ut_tcsetattr(int fd, int optional_actions, const struct termios* termios_p)
 {
     return mock_tcsetattr(fd, optional_actions, termios_p);
 }
+
+int ut_lstat(const char* path, struct stat* buf)
+{
+    return mock_lstat(path, buf);
+}
+
+#ifdef __linux__
+ssize_t ut_copy_file_range(int in_fd,
+                           loff_t* in_off,
+                           int out_fd,
+                           loff_t* out_off,
+                           size_t len,
+                           unsigned int flags)
+{
+    return mock_copy_file_range(in_fd, in_off, out_fd, out_off, len, flags);
+}
+#endif
 }
 
 // By default, call real functions
@@ -50,3 +67,8 @@ std::function<int(int)> mock_isatty = isatty;
 std::function<int(FILE*)> mock_fileno = fileno;
 std::function<int(int, struct termios*)> mock_tcgetattr = tcgetattr;
 std::function<int(int, int, const struct termios*)> mock_tcsetattr = tcsetattr;
+std::function<int(const char*, struct stat*)> mock_lstat = lstat;
+#ifdef __linux__
+std::function<ssize_t(int, loff_t*, int, loff_t*, size_t, unsigned int)> mock_copy_file_range =
+    copy_file_range;
+#endif
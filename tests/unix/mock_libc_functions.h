@@ -21,7 +21,9 @@
 
 #include <grp.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <termios.h>
+#include <unistd.h>
 
 DECL_MOCK(getgrnam);
 
@@ -34,3 +36,8 @@ extern "C" std::function<int(int)> mock_isatty;
 extern "C" std::function<int(FILE*)> mock_fileno;
 extern "C" std::function<int(int, struct termios*)> mock_tcgetattr;
 extern "C" std::function<int(int, int, const struct termios*)> mock_tcsetattr;
+extern "C" std::function<int(const char*, struct stat*)> mock_lstat;
+#ifdef __linux__
+extern "C" std::function<ssize_t(int, loff_t*, int, loff_t*, size_t, unsigned int)>
+    mock_copy_file_range;
+#endif
@@ -27,8 +27,13 @@
 #include <multipass/format.h>
 #include <multipass/platform.h>
 
+#include <fstream>
+#include <sstream>
 #include <thread>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace mp = multipass;
 namespace mpt = multipass::test;
 
@@ -180,6 +185,83 @@ TEST_F(TestPlatformUnix, getTotalRamReturnsGreaterThanZero)
     EXPECT_GT(MP_PLATFORM.get_total_ram(), 0LL);
 }
 
+#ifdef __linux__
+struct CopyFileDataFallback : public TestPlatformUnix, public WithParamInterface<int>
+{
+};
+
+TEST_P(CopyFileDataFallback, copiesThroughABufferWhereTheKernelCannot)
+{
+    const std::string data{"contents the kernel refuses to copy"};
+    mpt::TempFile destination;
+    std::ofstream{file.name().toStdString()} << data;
+
+    REPLACE(copy_file_range, [this](auto...) {
+        errno = GetParam();
+        return ssize_t{-1};
+    });
+
+    const auto in_fd = ::open(qPrintable(file.name()), O_RDONLY);
+    const auto out_fd = ::open(qPrintable(destination.name()), O_WRONLY);
+    ASSERT_NE(in_fd, -1);
+    ASSERT_NE(out_fd, -1);
+
+    EXPECT_EQ(mp::platform::copy_file_data(in_fd, 0, out_fd, 0, 0), (long long)data.size());
+    ::close(in_fd);
+    ::close(out_fd);
+
+    std::stringstream copied;
+    copied << std::ifstream{destination.name().toStdString()}.rdbuf();
+    EXPECT_EQ(copied.str(), data);
+}
+
+INSTANTIATE_TEST_SUITE_P(TestPlatformUnix, CopyFileDataFallback, Values(EBADF, EXDEV, EINVAL));
+
+TEST_F(TestPlatformUnix, copyFileDataDoesNotBufferOverlappingRangesOfOneFile)
+{
+    const std::string data{"contents that must not be overwritten"};
+    std::ofstream{file.name().toStdString()} << data;
+
+    REPLACE(copy_file_range, [](auto...) {
+        errno = EINVAL;
+        return ssize_t{-1};
+    });
+
+    const auto in_fd = ::open(qPrintable(file.name()), O_RDONLY);
+    const auto out_fd = ::open(qPrintable(file.name()), O_WRONLY);
+    ASSERT_NE(in_fd, -1);
+    ASSERT_NE(out_fd, -1);
+
+    EXPECT_TRUE(mp::platform::same_file(in_fd, out_fd));
+    EXPECT_EQ(mp::platform::copy_file_data(in_fd, 0, out_fd, 4, 10), -1);
+    EXPECT_EQ(errno, EINVAL);
+    ::close(in_fd);
+    ::close(out_fd);
+
+    std::stringstream contents;
+    contents << std::ifstream{file.name().toStdString()}.rdbuf();
+    EXPECT_EQ(contents.str(), data);
+}
+
+TEST_F(TestPlatformUnix, copyFileDataFailsWhenTheKernelFailsOtherwise)
+{
+    mpt::TempFile destination;
+    std::ofstream{file.name().toStdString()} << "some contents";
+
+    REPLACE(copy_file_range, [](auto...) {
+        errno = EIO;
+        return ssize_t{-1};
+    });
+
+    const auto in_fd = ::open(qPrintable(file.name()), O_RDONLY);
+    const auto out_fd = ::open(qPrintable(destination.name()), O_WRONLY);
+
+    EXPECT_EQ(mp::platform::copy_file_data(in_fd, 0, out_fd, 0, 0), -1);
+    ::close(in_fd);
+    ::close(out_fd);
+}
+#endif
+
 void test_sigset_empty(const sigset_t& set)
 {
     // there is no standard empty check to try a few different signals